@@ -55,7 +55,7 @@ struct whb0x_in_data
 #pragma pack(pop)
 
 /* Globale Variablen */
-extern struct whb04_out_data output_report;
+extern struct whb04_out_data output_report;   // Stand des UI-Tasks (xhc_rx_take_update)
 extern struct whb0x_in_data in_report;
 extern uint8_t day;  // XOR-Schlüssel
 
@@ -17,7 +17,6 @@ void encoder_init(void);
 int16_t encoder_read(void);
 uint8_t encoder_has_activity(void);
 void encoder_reset(void);
-void encoder_display_test(void);
 void encoder_display_sent_values(void);
 void encoder_1ms_poll(void);
 int16_t encoder_read_1ms(void);
@@ -8,6 +8,8 @@ typedef struct {
     const uint8_t width;
     uint8_t height;
     const uint16_t *data;
+    const uint8_t *packed;    // siehe Drivers/ST7735/fonts.h
+    const uint8_t *map;
 } FontDef;
 
 
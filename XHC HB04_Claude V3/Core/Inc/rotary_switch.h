@@ -6,7 +6,6 @@
 /* Funktionsprototypen */
 void rotary_switch_init(void);
 uint8_t rotary_switch_read(void);
-void rotary_switch_display_test(void);
 
 /* Rotary Switch Werte */
 #define ROTARY_OFF      0x00
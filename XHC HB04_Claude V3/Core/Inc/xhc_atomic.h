@@ -0,0 +1,97 @@
+/*
+ * XHC HB04 Atomare Zähler (LDREX/STREX)
+ *
+ * Ersetzt __disable_irq()/__enable_irq() um kurze Read-Modify-Write-
+ * Sequenzen auf Variablen, die Hauptschleife und ISRs teilen. Auf dem
+ * Cortex-M3 löscht jeder Exception-Eintritt/-Austritt den Exclusive-
+ * Monitor; kommt eine ISR dazwischen, schlägt STREX fehl und die Schleife
+ * läuft noch einmal. Interrupts werden nie global gesperrt, USB und DMA
+ * sehen keine zusätzliche Latenz.
+ *
+ * Plain aligned 8/16/32-Bit Loads/Stores sind ohnehin atomar und brauchen
+ * nichts davon.
+ */
+
+#ifndef XHC_ATOMIC_H
+#define XHC_ATOMIC_H
+
+#include <stdint.h>
+
+#if defined(__arm__)
+
+#include "main.h"   /* CMSIS: __LDREXW/__STREXW, __LDREXH/__STREXH */
+
+/* *p += v, liefert den neuen Wert */
+static inline int32_t xhc_atomic_add_i32(volatile int32_t *p, int32_t v)
+{
+    int32_t n;
+    do {
+        n = (int32_t)__LDREXW((volatile uint32_t *)p) + v;
+    } while (__STREXW((uint32_t)n, (volatile uint32_t *)p));
+    return n;
+}
+
+/* *p = v, liefert den alten Wert */
+static inline int32_t xhc_atomic_xchg_i32(volatile int32_t *p, int32_t v)
+{
+    int32_t old;
+    do {
+        old = (int32_t)__LDREXW((volatile uint32_t *)p);
+    } while (__STREXW((uint32_t)v, (volatile uint32_t *)p));
+    return old;
+}
+
+/* *p |= v, liefert den alten Wert (Flag-Masken) */
+static inline int32_t xhc_atomic_fetch_or_i32(volatile int32_t *p, int32_t v)
+{
+    int32_t old;
+    do {
+        old = (int32_t)__LDREXW((volatile uint32_t *)p);
+    } while (__STREXW((uint32_t)(old | v), (volatile uint32_t *)p));
+    return old;
+}
+
+/* (*p)++, liefert den alten Wert (Ring-Indizes, läuft über) */
+static inline uint32_t xhc_atomic_fetch_inc_u32(volatile uint32_t *p)
+{
+    uint32_t old;
+    do {
+        old = __LDREXW(p);
+    } while (__STREXW(old + 1u, p));
+    return old;
+}
+
+static inline int16_t xhc_atomic_add_i16(volatile int16_t *p, int16_t v)
+{
+    int16_t n;
+    do {
+        n = (int16_t)((int16_t)__LDREXH((volatile uint16_t *)p) + v);
+    } while (__STREXH((uint16_t)n, (volatile uint16_t *)p));
+    return n;
+}
+
+static inline int16_t xhc_atomic_xchg_i16(volatile int16_t *p, int16_t v)
+{
+    int16_t old;
+    do {
+        old = (int16_t)__LDREXH((volatile uint16_t *)p);
+    } while (__STREXH((uint16_t)v, (volatile uint16_t *)p));
+    return old;
+}
+
+#else   /* Host-Build: GCC-Builtins */
+
+static inline int32_t xhc_atomic_add_i32(volatile int32_t *p, int32_t v)  { return __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST); }
+static inline int32_t xhc_atomic_xchg_i32(volatile int32_t *p, int32_t v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+static inline int32_t xhc_atomic_fetch_or_i32(volatile int32_t *p, int32_t v) { return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST); }
+static inline uint32_t xhc_atomic_fetch_inc_u32(volatile uint32_t *p) { return __atomic_fetch_add(p, 1u, __ATOMIC_SEQ_CST); }
+static inline int16_t xhc_atomic_add_i16(volatile int16_t *p, int16_t v)  { return __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST); }
+static inline int16_t xhc_atomic_xchg_i16(volatile int16_t *p, int16_t v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+
+#endif
+
+/* Wert abholen und auf 0 setzen (Akkumulatoren leeren) */
+static inline int32_t xhc_atomic_fetch_clear_i32(volatile int32_t *p) { return xhc_atomic_xchg_i32(p, 0); }
+static inline int16_t xhc_atomic_fetch_clear_i16(volatile int16_t *p) { return xhc_atomic_xchg_i16(p, 0); }
+
+#endif /* XHC_ATOMIC_H */
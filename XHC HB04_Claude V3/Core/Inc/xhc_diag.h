@@ -0,0 +1,33 @@
+/*
+ * XHC HB04 Diagnose-Feature-Report (Report ID 0x10)
+ *
+ * SET_REPORT 0x10: [0x10, page, index, cmd]   cmd 1 = Statistik der Seite löschen
+ * GET_REPORT 0x10: [0x10, page, index, Daten der Seite ...] (64 Bytes, little endian)
+ * Nach jedem GET läuft index auf den nächsten Eintrag der Seite weiter,
+ * der Host kann eine Seite also durch wiederholtes GET komplett lesen.
+ */
+
+#ifndef XHC_DIAG_H
+#define XHC_DIAG_H
+
+#include <stdint.h>
+
+#define XHC_DIAG_REPORT_ID   0x10
+#define XHC_DIAG_REPORT_LEN  64u      // inkl. Report-ID
+
+#define XHC_DIAG_CMD_NONE    0x00
+#define XHC_DIAG_CMD_RESET   0x01
+
+typedef enum {
+    XHC_DIAG_PAGE_PROFILER = 1,   // je Messpunkt: Name, Anzahl, Min/Max/Mittel, Histogramm
+    XHC_DIAG_PAGE_SCHED    = 2,   // je Task: Name, Läufe, Deadline-Misses, max. Verspätung
+    XHC_DIAG_PAGE_MEMORY   = 3,   // RAM-Aufteilung, Stack-High-Water, Stack-Tiefe je ISR
+    XHC_DIAG_PAGE_TRACE    = 4,   // Trace-Ring (xhc_trace.h), 3 Datensätze je Report
+    XHC_DIAG_PAGE_IRQ      = 5,   // je IRQ: Name, Priorität Ist/Soll (xhc_irq.h)
+} xhc_diag_page_t;
+
+void     xhc_diag_set_report(const uint8_t *report, uint16_t len);
+uint8_t *xhc_diag_get_report(uint16_t *len);
+void     xhc_diag_deferred(void);
+
+#endif /* XHC_DIAG_H */
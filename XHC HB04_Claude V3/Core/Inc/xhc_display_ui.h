@@ -7,11 +7,18 @@
 #define DISPLAY_WIDTH   160
 #define DISPLAY_HEIGHT  128
 
+/* 1 = statische Labels/Linien als vorgeneriertes RLE-Bild (xhc_ui_background.c) */
+#ifndef XHC_UI_RLE_BACKGROUND
+#define XHC_UI_RLE_BACKGROUND 1
+#endif
+
 extern  uint16_t feed_percent;
 extern  uint16_t spin_percent;
 
 /* Funktionsprototypen */
 void xhc_ui_init(void);
+uint8_t xhc_ui_boot_service(void);
+void xhc_ui_redraw(void);
 void xhc_ui_update_coordinates(void);
 void xhc_ui_update_status_bar(uint8_t rotary_pos, uint8_t step_mul);
 void format_coordinate(char* text, int value, uint16_t frac, uint8_t negative);
@@ -0,0 +1,83 @@
+/*
+ * XHC HB04 Interrupt-Prioritäten und verzögerte Arbeit (PendSV)
+ *
+ * Gruppierung NVIC_PRIORITYGROUP_2: 2 Bit Preemption (0..3), 2 Bit
+ * Sub-Priorität (0..3), jeweils 0 = höchste. Preemption entscheidet, wer
+ * wen unterbricht, die Sub-Priorität nur die Reihenfolge gleichzeitig
+ * anstehender IRQs derselben Stufe.
+ *
+ *   IRQ                 Preempt  Sub   Aufgabe
+ *   SysTick             0        0     HAL-Tick + Encoder-Abtastung (1 ms)
+ *   DMA1_Channel3       1        0     SPI-TX fertig -> nächste Display-Zeile
+ *   USB_LP_CAN1_RX0     2        0     Endpunkte, SET/GET_REPORT
+ *   PendSV              3        3     verzögerte Arbeit aus den ISRs
+ *
+ * Die Werte stehen (CubeMX-generiert) in stm32f1xx_hal_msp.c, dma.c,
+ * usbd_conf.c und TICK_INT_PRIORITY; xhc_irq_check() vergleicht beim
+ * Start mit dieser Tabelle, falls CubeMX sie einmal überschreibt. Ist und
+ * Soll je IRQ liefert auch die Diagnose-Seite IRQ (xhc_diag.h), dort
+ * schlägt Tools/xhc_diag.py irq --check bei jeder Abweichung an.
+ *
+ * Alles, was im USB-IRQ länger als ein paar Mikrosekunden dauern kann
+ * (Paket-Zusammenbau, Diagnose-Resets), wird per xhc_irq_defer() nach
+ * PendSV verschoben. PendSV läuft direkt nach dem USB-IRQ (Tail-Chaining),
+ * aber unterbrechbar durch alle drei IRQs.
+ *
+ * Encoder-Abtastjitter: SysTick hat die höchste Stufe, verzögern ihn nur
+ * die PRIMASK-Sperre um WFI im Scheduler und der Exception-Eintritt.
+ * Gemessen wird die Latenz je Tick (Profiler "l_tick"), Jitter = max - min.
+ * Grenze XHC_ENC_JITTER_MAX_US, geprüft mit Tools/xhc_diag.py irq --check;
+ * in der Sim prüft scenarios/jitter.sim SysTick-Jitter und Latenz bis PendSV.
+ */
+
+#ifndef XHC_IRQ_H
+#define XHC_IRQ_H
+
+#include <stdint.h>
+
+#define XHC_IRQ_PRIO_GROUP      NVIC_PRIORITYGROUP_2
+
+#define XHC_IRQ_PRIO_TICK       0u
+#define XHC_IRQ_SUB_TICK        0u
+#define XHC_IRQ_PRIO_DMA        1u
+#define XHC_IRQ_SUB_DMA         0u
+#define XHC_IRQ_PRIO_USB        2u
+#define XHC_IRQ_SUB_USB         0u
+#define XHC_IRQ_PRIO_PENDSV     3u
+#define XHC_IRQ_SUB_PENDSV      3u
+
+/*
+ * Obergrenze für den Encoder-Abtastjitter (l_tick max - min).
+ * Noch nicht am Gerät gemessen. Die Sim (scenarios/jitter.sim, ISR-Kosten
+ * SIM_ISR_*_CYCLES geschätzt) kommt mit diesem Plan auf 0,11 us Jitter;
+ * SysTick auf Stufe 2 hinter einem USB-IRQ ergibt dort 18 us. 10 us liegt
+ * dazwischen und deutlich unter einer Encoder-Flanke. Am Gerät:
+ * Tools/xhc_diag.py irq --soak 60 --check, Ergebnis hier nachtragen.
+ */
+#define XHC_ENC_JITTER_MAX_US   10u
+
+/* Verzögerte Arbeiten, je ein Bit; Reihenfolge = Ausführungsreihenfolge */
+typedef enum {
+    XHC_DEFER_RX = 0,       // HID-Chunks an xhc_recv (xhc_recieve.c)
+    XHC_DEFER_DIAG,         // Diagnose-Reset (xhc_diag.c)
+    XHC_DEFER_COUNT
+} xhc_defer_t;
+
+/* Ist/Soll eines IRQs aus dem Plan (Diagnose-Seite IRQ) */
+typedef struct {
+    char    name[8];
+    uint8_t prio;           // Preemption laut NVIC
+    uint8_t sub;
+    uint8_t plan_prio;      // Preemption laut Tabelle oben
+    uint8_t plan_sub;
+    uint8_t group;          // Prioritätsgruppe laut NVIC
+    uint8_t plan_group;
+} xhc_irq_state_t;
+
+void     xhc_irq_defer(xhc_defer_t job);
+void     xhc_irq_pendsv(void);
+uint8_t  xhc_irq_check(void);
+uint8_t  xhc_irq_count(void);
+uint8_t  xhc_irq_state(uint8_t index, xhc_irq_state_t *out);
+
+#endif /* XHC_IRQ_H */
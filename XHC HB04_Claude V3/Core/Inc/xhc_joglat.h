@@ -0,0 +1,62 @@
+/*
+ * XHC HB04 Jog-Latenz: Rastung -> IN-Report -> Host-Position
+ *
+ * Drei Strecken in us, jeweils über die letzten XHC_JOGLAT_WINDOW Messungen
+ * (p50/p90/p99/max, Telemetrie-Report 0x11 ab Byte 64):
+ *
+ *   enc_usb   älteste noch nicht gemeldete Rastung bis USBD_CUSTOM_HID_SendReport
+ *             angenommen hat (Zeitpunkt Rastung = erster task_encoder-Lauf, der
+ *             sie sieht, also bis 1 ms nach der Flanke; auf dem Bus ist der
+ *             Report erst beim nächsten IN-Token des Hosts)
+ *   usb_echo  dieser Report bis zum ersten Host-Paket, in dem sich die gewählte
+ *             Achse bewegt hat (xhc_recv, PendSV)
+ *   enc_echo  beides zusammen: Rastung bis zur neuen Position im Host-Paket
+ *
+ * enc_usb zählt jeden Report mit Rad-Wert. Das Echo wird nur für den ersten
+ * Report aus der Ruhe gemessen (XHC_JOGLAT_REST_MS kein Rad-Report und keine
+ * Bewegung auf X/Y/Z), sonst wäre die Positionsänderung nicht eindeutig
+ * einem Report zuzuordnen. Feed/Spindel/A haben keine DRO-Zeile, dort nur
+ * enc_usb. Kommt binnen XHC_JOGLAT_ECHO_TIMEOUT_MS keine Bewegung (Maschine
+ * aus, Endschalter, Host ignoriert das Rad), zählt die Messung als Timeout
+ * (geprüft im 1-s-Raster von task_memory).
+ *
+ * Host: python3 Tools/xhc_diag.py telem
+ */
+
+#ifndef XHC_JOGLAT_H
+#define XHC_JOGLAT_H
+
+#include <stdint.h>
+
+struct whb04_out_data;
+
+#define XHC_JOGLAT_WINDOW          32u      // Messungen je Strecke für die Perzentile
+#define XHC_JOGLAT_REST_MS         250u
+#define XHC_JOGLAT_ECHO_TIMEOUT_MS 1000u    // < CYCCNT-Überlauf (59 s)
+
+typedef enum {
+    JOGLAT_ENC_USB = 0,
+    JOGLAT_USB_ECHO,
+    JOGLAT_ENC_ECHO,
+    JOGLAT_COUNT
+} xhc_joglat_path_t;
+
+typedef struct {
+    uint32_t p50, p90, p99, max;    // us, 0 solange keine Messung
+} xhc_joglat_pct_t;
+
+typedef struct {
+    uint32_t         reports;       // Reports mit Rad-Wert (enc_usb-Messungen)
+    uint32_t         echoes;        // gemessene Echos
+    uint32_t         timeouts;      // Echo ausgeblieben
+    xhc_joglat_pct_t pct[JOGLAT_COUNT];
+} xhc_joglat_stats_t;
+
+void xhc_joglat_detent(void);
+void xhc_joglat_flush(void);
+void xhc_joglat_report(uint8_t wheel_mode, int8_t wheel, uint32_t now_ms);
+void xhc_joglat_host(const struct whb04_out_data *pkt);
+void xhc_joglat_update(void);
+const xhc_joglat_stats_t *xhc_joglat_stats(void);
+
+#endif /* XHC_JOGLAT_H */
@@ -9,14 +9,23 @@
 #include "xhc_receive.h"
 #include "usbd_custom_hid_if.h"
 
+/* Boot-Zeitpunkte in ms seit Reset (0 = noch nicht erreicht) */
+typedef struct {
+    uint32_t display_ready_ms;   // Panel-Init-Sequenz fertig
+    uint32_t ui_ready_ms;        // statische UI gezeichnet
+    uint32_t first_report_ms;    // erster Input-Report vom Host abgenommen
+} xhc_boot_times_t;
+
+extern xhc_boot_times_t xhc_boot_times;
+
 /* Funktionsprototypen für main.c */
 void xhc_custom_hid_init(void);
+void xhc_main_tasks_init(void);
 void xhc_main_loop(void);
 uint8_t xhc_send_input_report(uint8_t btn1, uint8_t btn2, uint8_t wheel_mode, int8_t wheel_value);
 void xhc_main_loop_encoder_only(void);
 
 /* Debug-Funktionen */
 void xhc_debug_callback(void);
-void run_display_performance_tests(void);
 
 #endif /* XHC_MAIN_H */
@@ -0,0 +1,66 @@
+/*
+ * XHC HB04 RAM-Budget und Stack-High-Water
+ *
+ * Beim Start wird der freie Bereich zwischen Heap-Ende und Stack mit
+ * XHC_MEM_PAINT gefüllt. xhc_mem_update() sucht von unten das erste
+ * überschriebene Wort: darüber hat der Stack (inkl. aller ISRs) schon
+ * einmal gelegen. Zusätzlich merkt sich jede ISR beim Eintritt den
+ * tiefsten MSP, mit dem sie gestartet wurde (Verschachtelung sichtbar).
+ *
+ * Auslesen: Feature-Report 0x10, Seite XHC_DIAG_PAGE_MEMORY
+ * (Tools/xhc_diag.py mem, mit --map zusätzlich die größten Puffer).
+ */
+
+#ifndef XHC_MEM_H
+#define XHC_MEM_H
+
+#include <stdint.h>
+#include "main.h"
+
+#ifndef XHC_MEM_ENABLE
+#define XHC_MEM_ENABLE 1
+#endif
+
+#define XHC_MEM_PAINT          0xC5C5C5C5u
+#define XHC_MEM_WARN_BYTES     512u     // Warnung wenn weniger Luft zwischen Heap und Stack
+
+typedef enum {
+    MEM_ISR_SYSTICK = 0,
+    MEM_ISR_USB,
+    MEM_ISR_DMA_SPI,
+    MEM_ISR_PENDSV,
+    MEM_ISR_COUNT
+} xhc_mem_isr_t;
+
+typedef struct {
+    uint32_t ram_total;       // Größe des SRAM
+    uint32_t data;            // .data (inkl. .RamFunc)
+    uint32_t bss;             // .bss
+    uint32_t heap_used;       // sbrk-Ende - _end
+    uint32_t heap_min;        // _Min_Heap_Size (Linker-Reserve)
+    uint32_t stack_min;       // _Min_Stack_Size (Linker-Reserve)
+    uint32_t stack_peak;      // _estack - tiefster je benutzter Stack
+    uint32_t headroom;        // nie benutzte Bytes zwischen Heap und Stack
+    uint32_t ramfunc;         // .ramfunc: ISR-Code/Tabellen im SRAM (xhc_ramfunc.h)
+    uint32_t noinit;          // .noinit: Flugschreiber (xhc_trace.h)
+} xhc_mem_stat_t;
+
+#if XHC_MEM_ENABLE
+
+extern uint32_t xhc_mem_isr_sp[MEM_ISR_COUNT];
+
+/* Am ISR-Anfang: tiefsten Eintritts-MSP merken (2 Load/Store) */
+#define XHC_MEM_ISR_ENTRY(id)  do { uint32_t _sp = __get_MSP(); \
+                                    if (_sp < xhc_mem_isr_sp[(id)]) xhc_mem_isr_sp[(id)] = _sp; } while (0)
+#else
+#define XHC_MEM_ISR_ENTRY(id)  do { } while (0)
+#endif /* XHC_MEM_ENABLE */
+
+void        xhc_mem_paint(void);
+void        xhc_mem_update(void);
+void        xhc_mem_stats(xhc_mem_stat_t *s);
+uint32_t    xhc_mem_isr_depth(xhc_mem_isr_t id);
+const char *xhc_mem_isr_name(xhc_mem_isr_t id);
+void        xhc_mem_reset(void);
+
+#endif /* XHC_MEM_H */
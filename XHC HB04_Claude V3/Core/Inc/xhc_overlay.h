@@ -0,0 +1,42 @@
+/*
+ * XHC HB04 Diagnoseseite auf dem ST7735
+ *
+ * Versteckte Seite statt der DRO: Scheduler-Durchläufe/s, längste Laufzeit
+ * je Task, IN-Reports/s und abgelehnte Sends, Host-Pakete/s und verworfene
+ * Chunks, Rastungen/s und Auslastung der Display-SPI. Damit lässt sich der
+ * Zustand des Handrads an der Maschine prüfen, ohne Laptop und USB-Tools.
+ *
+ * Umschalten: XHC_OVERLAY_KEY_A + XHC_OVERLAY_KEY_B zusammen
+ * XHC_OVERLAY_HOLD_MS halten. Beide Tasten gehen wie jede andere Taste
+ * auch an den Host; erst das lange Halten schaltet die Seite.
+ *
+ * Gezeichnet wird nur im UI-Task, im festen Raster XHC_OVERLAY_PERIOD_MS
+ * mit Font_7x10 (ST7735_WriteString, kein GFX-Font) und je Zeile nur der
+ * Abschnitt, der sich geändert hat. Die Display-Bytes der Seite selbst
+ * zählen in der SPI-Auslastung mit. Währenddessen laufen USB, Encoder und
+ * Host-Pakete normal weiter. Ein- und Ausblenden kostet je einen
+ * Vollbild-Aufbau wie beim Boot (schwarz bzw. DRO-Hintergrund, je ~75 ms
+ * bei SPI/16); Rastungen sammelt der SysTick solange weiter.
+ */
+
+#ifndef XHC_OVERLAY_H
+#define XHC_OVERLAY_H
+
+#include <stdint.h>
+#include "button_matrix.h"
+
+/* 0 = Seite und Tastenkombination entfallen */
+#ifndef XHC_OVERLAY_ENABLE
+#define XHC_OVERLAY_ENABLE 1
+#endif
+
+#define XHC_OVERLAY_KEY_A      BTN_Macro3
+#define XHC_OVERLAY_KEY_B      BTN_Macro6
+#define XHC_OVERLAY_HOLD_MS    1000u
+#define XHC_OVERLAY_PERIOD_MS  500u
+
+void    xhc_overlay_keys(uint8_t s1, uint8_t s2, uint32_t now);
+void    xhc_overlay_service(uint32_t now);
+uint8_t xhc_overlay_active(void);
+
+#endif /* XHC_OVERLAY_H */
@@ -0,0 +1,58 @@
+/*
+ * XHC HB04 Idle-Power-Management
+ *
+ * ACTIVE -> (XHC_PWR_IDLE_MS ohne Aktivität) -> IDLE -> (XHC_PWR_DEEP_IDLE_MS) -> DEEP_IDLE
+ * Jede Aktivität (Encoder, Taste, Drehschalter, geänderte Host-Daten)
+ * springt sofort zurück auf ACTIVE.
+ *
+ *  IDLE:      Encoder-, USB-, Drehschalter- und UI-Task seltener (Perioden
+ *             unten, gesetzt im Hook von xhc_main.c), Flash/SRAM-Takt im Sleep aus
+ *  DEEP_IDLE: zusätzlich Panel im ST7735-Idle-Mode (8 Farben, weniger Strom),
+ *             geschaltet im nächsten xhc_power_update (auch beim Aufwachen)
+ *
+ * Aufwachen: SysTick tastet TIM2 weiter jede ms ab (encoder_1ms_poll), es
+ * geht also keine Rastung verloren. Die erste sieht task_encoder nach
+ * höchstens XHC_PWR_IDLE_ENC_PERIOD_MS, meldet Aktivität, der Hook setzt
+ * die USB-Task sofort fällig: Rastung -> IN-Report bleibt unter einem
+ * USB-Pollintervall (CUSTOM_HID_FS_BINTERVAL, 5 ms). Tasten behalten ihr
+ * 20-ms-Raster, die Entprellung braucht es ohnehin. Host-Pakete wecken
+ * erst im UI-Task, also nach bis zu XHC_PWR_IDLE_UI_PERIOD_MS.
+ *
+ * Duty-Cycle: der Kern wacht weiter jede ms für SysTick auf, in der
+ * Hauptschleife laufen im Idle statt ~2180 nur noch ~430 Task-Aufrufe/s
+ * (Sim: scenarios/idle.sim). Gemessen wird die Schlafzeit im Profiler
+ * ("m_wfi", Summe der WFI-Dauern), auf dem Gerät mit
+ * Tools/xhc_diag.py power --soak 10.
+ *
+ * Nicht umgesetzt: EXTI-Wecker bräuchte erst STOP-Mode, der ist nur im
+ * USB-Suspend erlaubt (im Betrieb muss der Kern IN-Token beantworten);
+ * im Sleep-Mode weckt ohnehin jeder IRQ. Die Hintergrundbeleuchtung hängt
+ * fest an der Versorgung, statt Dimmen gibt es nur den Panel-Idle-Mode.
+ */
+
+#ifndef XHC_POWER_H
+#define XHC_POWER_H
+
+#include <stdint.h>
+
+#define XHC_PWR_IDLE_MS            30000u     // 30 s
+#define XHC_PWR_DEEP_IDLE_MS       300000u    // 5 min
+#define XHC_PWR_IDLE_UI_PERIOD_MS  100u
+#define XHC_PWR_IDLE_ENC_PERIOD_MS 3u         // + 1 ms Abtastung + 1 ms USB-Frame < 5 ms
+#define XHC_PWR_IDLE_USB_PERIOD_MS 50u        // nur Keepalive (500 ms)
+#define XHC_PWR_IDLE_ROT_PERIOD_MS 200u
+
+typedef enum {
+    XHC_PWR_ACTIVE = 0,
+    XHC_PWR_IDLE,
+    XHC_PWR_DEEP_IDLE
+} xhc_power_level_t;
+
+typedef void (*xhc_power_hook_t)(xhc_power_level_t level);
+
+void              xhc_power_init(xhc_power_hook_t on_change);
+void              xhc_power_activity(void);
+xhc_power_level_t xhc_power_update(uint32_t now);
+xhc_power_level_t xhc_power_level(void);
+
+#endif /* XHC_POWER_H */
@@ -0,0 +1,43 @@
+/*
+ * XHC HB04 Vorhersage-DRO (Dead Reckoning)
+ *
+ * Die Koordinaten kommen nur mit dem nächsten Host-Paket. Beim Joggen hängt
+ * die Anzeige dem Rad deshalb um eine Host-Runde hinterher. Mit
+ * XHC_DRO_PREDICT=1 wird die Position der gewählten Achse (X/Y/Z) sofort um
+ * jeden gesendeten Rad-Wert x Schrittweite (step_mul) fortgeschrieben.
+ *
+ * Meldet der Host Bewegung auf der Achse, wird der vorausgesagte Anteil um
+ * genau diese Strecke abgebaut (nie über null hinaus). Fährt die Achse in
+ * die Gegenrichtung (am Host invertiert oder anders bewegt), wird die
+ * Vorhersage sofort verworfen. Kommt innerhalb von
+ * XHC_PREDICT_TIMEOUT_MS nach dem letzten Rad-Wert keine Bewegung, wird der
+ * Rest verworfen (Maschine aus, Endschalter, anderer Modus ...). Solange ein
+ * Anteil offen ist, zeigt die UI eine kleine Markierung neben dem Wert.
+ *
+ * Alle Funktionen nur aus dem Hauptkontext (Scheduler-Tasks) aufrufen.
+ */
+
+#ifndef XHC_PREDICT_H
+#define XHC_PREDICT_H
+
+#include <stdint.h>
+
+#ifndef XHC_DRO_PREDICT
+#define XHC_DRO_PREDICT 1
+#endif
+
+#define XHC_PREDICT_TIMEOUT_MS   300u
+#define XHC_PREDICT_NONE         0xFFu     // keine Achse vorausgesagt
+
+/* Positionen intern in 1/10000 Einheiten (p_int * 10000 + Nachkommastellen) */
+int32_t xhc_pos_to_units(uint16_t p_int, uint16_t p_frac);
+void    xhc_units_to_pos(int32_t units, uint16_t *p_int, uint16_t *p_frac);
+
+void    xhc_predict_reset(void);
+void    xhc_predict_on_wheel(uint8_t wheel_mode, int8_t wheel, uint8_t step_mul, uint32_t now);
+void    xhc_predict_on_host(void);
+uint8_t xhc_predict_service(uint32_t now);
+void    xhc_predict_apply(uint16_t p_int[6], uint16_t p_frac[6]);
+uint8_t xhc_predict_axis(void);
+
+#endif /* XHC_PREDICT_H */
@@ -0,0 +1,94 @@
+/*
+ * XHC HB04 Zyklen-Profiler (DWT CYCCNT)
+ *
+ * Benannte Messpunkte um Hauptschleifen-States, ISRs und Display-Primitive.
+ * Je Messpunkt: Anzahl, Min/Max/Mittel in CPU-Zyklen (72 MHz -> 13,9 ns)
+ * und ein log2-Histogramm. Auslesen über Feature-Report 0x10 (xhc_diag.h).
+ */
+
+#ifndef XHC_PROFILER_H
+#define XHC_PROFILER_H
+
+#include <stdint.h>
+#include "main.h"
+
+/* 0 = Messpunkte kompilieren zu nichts */
+#ifndef XHC_PROF_ENABLE
+#define XHC_PROF_ENABLE 1
+#endif
+
+/* Histogramm: Bin k zählt Dauern in [2^(k+SHIFT), 2^(k+SHIFT+1)) Zyklen,
+ * Bin 0 zusätzlich alles darunter, letzter Bin alles darüber.
+ * 18 Bins ab 2^6: < 1,8 us ... >= 116 ms */
+#define XHC_PROF_HIST_BINS   18u
+#define XHC_PROF_HIST_SHIFT  6u
+
+typedef enum {
+    /* Hauptschleife */
+    PROF_MAIN_ENCODER = 0,
+    PROF_MAIN_BUTTONS,
+    PROF_MAIN_ROTARY,
+    PROF_MAIN_USB_SEND,
+    PROF_MAIN_UI,
+    PROF_MAIN_POWER,
+    PROF_MAIN_MEMORY,
+    PROF_MAIN_SLEEP,        // Dauer je WFI im Scheduler, Summe = Schlafzeit
+    /* ISRs */
+    PROF_ISR_SYSTICK,
+    PROF_ISR_USB,
+    PROF_ISR_DMA_SPI,
+    PROF_ISR_PENDSV,
+    /* Latenz: Zyklen vom Ereignis bis zum Handler-Eintritt (xhc_irq.h) */
+    PROF_LAT_SYSTICK,
+    PROF_LAT_PENDSV,
+    /* Display */
+    PROF_ST_FILL,
+    PROF_ST_STRING,
+    PROF_ST_IMAGE,
+    PROF_ST_BAR,
+    PROF_FB_FLUSH,
+    PROF_UI_COORDS,
+    PROF_UI_STATUS,
+    PROF_COUNT
+} xhc_prof_id_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint16_t hist[XHC_PROF_HIST_BINS];   // sättigt bei 0xFFFF
+} xhc_prof_stat_t;
+
+#if XHC_PROF_ENABLE
+
+static inline uint32_t xhc_prof_now(void) { return DWT->CYCCNT; }
+
+/* Rahmen um einen Codeblock; BEGIN/END müssen im selben Scope stehen */
+#define XHC_PROF_BEGIN(id)  uint32_t _prof_t0_##id = xhc_prof_now()
+#define XHC_PROF_END(id)    xhc_prof_record((id), xhc_prof_now() - _prof_t0_##id)
+
+/* Erste Anweisung im SysTick_Handler. SysTick zählt von LOAD abwärts,
+ * LOAD - VAL ist also die Zeit seit dem Überlauf. SysTick hat die höchste
+ * Priorität -> Wert enthält nur PRIMASK-Sperren und den Exception-
+ * Eintritt; max - min = Jitter der Encoder-Abtastung (xhc_irq.h). */
+#define XHC_PROF_SYSTICK_LATENCY() \
+    xhc_prof_record(PROF_LAT_SYSTICK, SysTick->LOAD - SysTick->VAL)
+
+#else
+
+static inline uint32_t xhc_prof_now(void) { return 0; }
+
+#define XHC_PROF_BEGIN(id)  do { } while (0)
+#define XHC_PROF_END(id)    do { } while (0)
+#define XHC_PROF_SYSTICK_LATENCY() do { } while (0)
+
+#endif /* XHC_PROF_ENABLE */
+
+void        xhc_prof_init(void);
+void        xhc_prof_record(xhc_prof_id_t id, uint32_t cycles);
+void        xhc_prof_reset(void);
+uint8_t     xhc_prof_snapshot(uint8_t id, xhc_prof_stat_t *out);
+const char *xhc_prof_name(uint8_t id);
+
+#endif /* XHC_PROFILER_H */
@@ -0,0 +1,41 @@
+/*
+ * XHC HB04 SRAM-Code für heiße ISR-Pfade
+ *
+ * Bei 72 MHz läuft der Flash mit 2 Waitstates; Sprünge und Literal-Loads
+ * verfehlen den kleinen Prefetch-Puffer regelmäßig. Funktionen mit
+ * XHC_RAMFUNC (und Tabellen mit XHC_RAMDATA) landen in der Ausgabe-Sektion
+ * .ramfunc (STM32F103C8TX_FLASH.ld), die der Startup-Code vor main() aus
+ * dem Flash ins SRAM kopiert.
+ *
+ * Ob das hilft, ist auf dem F103 nicht sicher: Code aus dem SRAM kommt
+ * über den System-Bus, auf dem auch die Datenzugriffe der ISR laufen,
+ * und sequentieller Flash-Code ist dank Prefetch fast waitstate-frei.
+ *
+ * Stand: .ramfunc ist leer. Es gibt noch keine Zyklen vom Gerät, und die
+ * Sim bildet keine Waitstates ab. Eine Funktion bekommt XHC_RAMFUNC erst,
+ * wenn i_tick / i_usb / i_dma (Tools/xhc_diag.py prof, Mittel und Max nach
+ * gleicher Last) damit messbar sinken. Vorher/Nachher-Zyklen dann hier
+ * neben der Funktion eintragen. Kandidaten: encoder_1ms_poll (SysTick),
+ * HAL_SPI_TxCpltCallback (DMA), USB_ReadPMA/WritePMA (USB, nur per
+ * Objektmuster im Linker-Skript, CubeMX-Code bleibt unverändert).
+ *
+ * RAM-Kosten: Feature-Report 0x10, Seite 3 (Tools/xhc_diag.py mem).
+ */
+
+#ifndef XHC_RAMFUNC_H
+#define XHC_RAMFUNC_H
+
+#ifndef XHC_RAMFUNC_ENABLE
+#define XHC_RAMFUNC_ENABLE 1
+#endif
+
+#if XHC_RAMFUNC_ENABLE
+/* noinline: sonst landet der Körper wieder im (Flash-)Aufrufer */
+#define XHC_RAMFUNC   __attribute__((section(".RamFunc.hot"), noinline))
+#define XHC_RAMDATA   __attribute__((section(".RamData.hot")))
+#else
+#define XHC_RAMFUNC
+#define XHC_RAMDATA
+#endif
+
+#endif /* XHC_RAMFUNC_H */
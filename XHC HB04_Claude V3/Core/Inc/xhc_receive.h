@@ -46,7 +46,10 @@
 
 /* Hauptfunktionen */
 void xhc_recv(uint8_t *data);
+void xhc_recv_isr(const uint8_t *data);
+void xhc_recv_deferred(void);
 void xhc_process_received_data(void);
+uint8_t xhc_rx_take_update(void);
 
 /* Hilfsfunktionen */
 float xhc_get_position(uint8_t axis, uint8_t is_machine);
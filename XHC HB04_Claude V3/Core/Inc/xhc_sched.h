@@ -0,0 +1,48 @@
+/*
+ * XHC HB04 kooperativer Scheduler
+ *
+ * Feste Task-Tabelle, Reihenfolge = Priorität (Index 0 zuerst).
+ * Pro Durchlauf läuft genau EINE fällige Task, danach wird wieder von oben
+ * gesucht -> eine hoch priorisierte Task wartet höchstens auf das Ende der
+ * gerade laufenden, nie auf eine ganze Runde. Ist nichts fällig, schläft
+ * die CPU per WFI bis zum nächsten Interrupt (spätestens SysTick, 1 ms).
+ *
+ * Lange Tasks (Display) rufen an ihren Wartestellen xhc_sched_yield(): die
+ * ersten xhc_sched_set_yield_count() Tasks der Tabelle laufen dann
+ * eingeschoben, eine Ausgabe hält sie also nur einen DMA-Block lang auf
+ * statt bis zu ihrem Ende. Eingeschobene Tasks dürfen selbst nicht
+ * zeichnen; ihre Laufzeit zählt im Profiler zusätzlich bei der Task mit,
+ * in die sie eingeschoben wurden.
+ */
+
+#ifndef XHC_SCHED_H
+#define XHC_SCHED_H
+
+#include <stdint.h>
+
+#define SCHED_NONE  0xFFu   // keine Task aktiv
+
+typedef struct {
+    const char *name;
+    void      (*run)(uint32_t now);
+    uint16_t    period_ms;      // Abstand der Fälligkeiten
+    uint16_t    deadline_ms;    // erlaubte Verspätung ab Fälligkeit, darüber = Miss
+    uint8_t     prof_id;        // Messpunkt in xhc_profiler
+
+    /* Laufzeitdaten */
+    uint32_t    next_ms;        // nächste Fälligkeit (HAL_GetTick)
+    uint32_t    runs;
+    uint32_t    misses;
+    uint16_t    max_late_ms;
+} xhc_task_t;
+
+void              xhc_sched_init(xhc_task_t *tasks, uint8_t count);
+void              xhc_sched_run_once(void);
+void              xhc_sched_reset_stats(void);
+void              xhc_sched_set_period(uint8_t index, uint16_t period_ms);
+void              xhc_sched_set_yield_count(uint8_t count);
+void              xhc_sched_yield(void);
+uint8_t           xhc_sched_task_count(void);
+const xhc_task_t *xhc_sched_task(uint8_t index);
+
+#endif /* XHC_SCHED_H */
@@ -0,0 +1,48 @@
+/*
+ * XHC HB04 Telemetrie-Feature-Report (Report ID 0x11)
+ *
+ * Laufende Betriebszähler ohne Debugger: der Host pollt GET_REPORT 0x11
+ * und bekommt immer dasselbe 128-Byte-Layout (xhc_telemetry.c). Die
+ * Zähler laufen frei über, der Host bildet Differenzen. Raten (Schleifen/s,
+ * Display-Bytes/s) rechnet task_memory einmal pro Sekunde nach.
+ *
+ * Die HB04-Reports 0x04/0x06 bleiben unverändert, Host-Software ohne
+ * Kenntnis von 0x11 sieht keinen Unterschied.
+ *
+ * Host: python3 Tools/xhc_diag.py telem [--watch 1]
+ */
+
+#ifndef XHC_TELEMETRY_H
+#define XHC_TELEMETRY_H
+
+#include <stdint.h>
+
+#define XHC_TELEM_REPORT_ID   0x11
+#define XHC_TELEM_REPORT_LEN  128u    // inkl. Report-ID
+#define XHC_TELEM_VERSION     4u      // Layout-Version in Byte 1
+
+typedef struct {
+    uint32_t loops;             // Scheduler-Durchläufe (xhc_main_loop)
+    uint32_t usb_sent;          // IN-Reports angenommen
+    uint32_t usb_busy;          // IN-Endpunkt belegt, später erneut
+    uint32_t host_reports;      // SET_REPORTs vom Host (alle IDs)
+    uint32_t rx_packets;        // vollständige Host-Pakete
+    uint32_t rx_dropped;        // Chunks verworfen, Warteschlange voll
+    uint32_t rx_duplicates;     // Paket identisch mit dem vorigen
+    uint32_t enc_in;            // Rastungen vom Encoder (Betrag)
+    uint32_t enc_out;           // an den Host gemeldete Rastungen (Betrag, vor Speed-Mapping)
+    uint32_t enc_discarded;     // verworfen: Schalter OFF, Flush beim Achswechsel
+    uint32_t spi_bytes;         // an das Display übertragene Bytes
+} xhc_telem_t;
+
+extern volatile xhc_telem_t xhc_telem;
+
+/* Jedes Feld hat genau einen Schreiber (eine Prioritätsstufe), ein
+ * einfaches Inkrement reicht. GET_REPORT liest nur. */
+#define XHC_TELEM_INC(field)     (xhc_telem.field++)
+#define XHC_TELEM_ADD(field, n)  (xhc_telem.field += (uint32_t)(n))
+
+void     xhc_telem_update(uint32_t now_ms);
+uint8_t *xhc_telem_get_report(uint16_t *len);
+
+#endif /* XHC_TELEMETRY_H */
@@ -0,0 +1,137 @@
+/*
+ * XHC HB04 Binär-Trace (verzögerte Debug-Ausgabe)
+ *
+ * Ersetzt printf auf heißen Pfaden und in ISRs. Ein Trace-Punkt schreibt
+ * einen 16-Byte-Datensatz (Zeitstempel DWT-Zyklen, ID, Folgenummer, zwei
+ * Argumente) in einen Ring im RAM: ein LDREX/STREX-Inkrement und vier
+ * Stores, keine Formatierung, keine Sperre. Der Ring überschreibt die
+ * ältesten Einträge und darf deshalb auch im Release-Build an bleiben.
+ *
+ * Flugschreiber: der Ring liegt in .noinit (STM32F103C8TX_FLASH.ld, fest am
+ * RAM-Anfang) und übersteht Watchdog-, Software- und Pin-Reset. Beim Start
+ * hängt xhc_trace_init nur einen TRC_BOOT-Eintrag mit der Reset-Ursache an;
+ * die Einträge vor dem Hänger bleiben lesbar. Ungültiger Inhalt (Power-On,
+ * anderes Layout) wird an Magic und Tiefe erkannt und verworfen.
+ * DMA-Transfers stehen nicht einzeln im Ring (ein Bildaufbau würde ihn
+ * füllen), sondern als Start-/Fertig-Zähler im Kopf; bleibt ein Transfer
+ * offen (ST_WaitDMA hängt), meldet der nächste Start TRC_DMA_HUNG.
+ *
+ * Texte liegen nicht im Flash: der Format-String steht als Kommentar hinter
+ * der ID in xhc_trace_id_t, Tools/xhc_diag.py liest ihn aus dieser Datei.
+ * Neue IDs nur anhängen, sonst passen ältere Mitschnitte nicht mehr.
+ *
+ * Auslesen:
+ *   python3 Tools/xhc_diag.py trace                 Feature-Report 0x10, Seite 4
+ *   python3 Tools/xhc_diag.py trace --file t.bin    Speicherabzug von xhc_trace_buf
+ *                                                   (GDB: dump binary value t.bin xhc_trace_buf,
+ *                                                    Sim: xhc_sim -t t.bin ...)
+ */
+
+#ifndef XHC_TRACE_H
+#define XHC_TRACE_H
+
+#include <stdint.h>
+#include "main.h"
+#include "xhc_atomic.h"
+
+/* 0 = Trace-Punkte kompilieren zu nichts */
+#ifndef XHC_TRACE_ENABLE
+#define XHC_TRACE_ENABLE 1
+#endif
+
+/* Anzahl Datensätze im Ring, Zweierpotenz (16 Byte je Eintrag, 4 KB) */
+#ifndef XHC_TRACE_DEPTH
+#define XHC_TRACE_DEPTH 256u
+#endif
+
+#define XHC_TRACE_MAGIC  0x58545243u    // "CRTX", ändern wenn sich das Layout ändert
+
+/* Reset-Ursache in TRC_BOOT: RCC->CSR >> 24 */
+#define XHC_RESET_PIN    0x04u
+#define XHC_RESET_POR    0x08u
+#define XHC_RESET_SW     0x10u
+#define XHC_RESET_IWDG   0x20u
+#define XHC_RESET_WWDG   0x40u
+#define XHC_RESET_LPWR   0x80u
+
+/* Format: printf-artig mit genau den Platzhaltern %d/%u/%x für a und b */
+typedef enum {
+    TRC_NONE = 0,           // ""
+    TRC_ENC_RESET,          // "Encoder-Reset: encoder_1ms_buffer %d, impulse_buffer %d"
+    TRC_ENC_FAST,           // "Fast encoder: %d (total: %d)"
+    TRC_ENC_DISCARD,        // "Discarding encoder detents while OFF: %d"
+    TRC_ROTARY_CHANGE,      // "Rotary change: %02x -> %02x - FLUSH"
+    TRC_ROTARY_DONE,        // "Rotary switch complete. Buffers cleared."
+    TRC_POWER_LEVEL,        // "Power level %u"
+    TRC_BOOT,               // "Start #%u, Reset-Ursache 0x%02x"
+    TRC_DMA_HUNG,           // "Vor dem Reset offen: %u DMA-Transfers, letzter %u Byte"
+    TRC_FAULT,              // "Fault %u, CFSR 0x%08x"
+    TRC_FAULT_ADDR,         // "Fault-Adressen BFAR 0x%08x, MMFAR 0x%08x"
+    TRC_ERROR,              // "Error_Handler, gerufen von 0x%08x"
+    TRC_USB_BUSY,           // "IN-Report abgelehnt (Status %u), %d Rastungen zurückgelegt"
+    TRC_UI_READY,           // "UI bereit nach %u ms"
+    TRC_FIRST_REPORT,       // "Erster IN-Report nach %u ms"
+    TRC_SPI_TUNE,           // "Display-SPI Teiler /%u, Rücklesen %u"
+    TRC_COUNT
+} xhc_trace_id_t;
+
+typedef struct {
+    uint32_t ts;            // DWT->CYCCNT beim Schreiben
+    uint16_t id;            // xhc_trace_id_t
+    uint16_t seq;           // untere 16 Bit der laufenden Nummer, zuletzt geschrieben
+    int32_t  a;
+    int32_t  b;
+} xhc_trace_rec_t;
+
+/* Layout = Speicherabzug für "xhc_diag.py trace --file", 32 Byte Kopf */
+typedef struct {
+    uint32_t          magic;                // XHC_TRACE_MAGIC
+    volatile uint32_t head;                 // Anzahl geschriebener Datensätze
+    uint32_t          depth;                // XHC_TRACE_DEPTH
+    uint32_t          boots;                // Starts seit dem letzten Power-On
+    uint32_t          reset_cause;          // RCC->CSR dieses Starts
+    volatile uint32_t dma_started;          // ST7735-DMA gestartet (Task)
+    volatile uint32_t dma_done;             // fertig gemeldet (DMA-IRQ)
+    volatile uint32_t dma_last_len;
+    xhc_trace_rec_t   rec[XHC_TRACE_DEPTH];
+} xhc_trace_buf_t;
+
+extern xhc_trace_buf_t xhc_trace_buf;
+
+#if XHC_TRACE_ENABLE
+
+/*
+ * Platz reservieren, Felder schreiben, Folgenummer zuletzt. Unterbricht
+ * eine ISR zwischen Reservieren und seq, bekommt sie den nächsten Platz;
+ * ein Leser erkennt den halb geschriebenen Eintrag an der falschen seq.
+ */
+static inline void xhc_trace(xhc_trace_id_t id, int32_t a, int32_t b)
+{
+    uint32_t n = xhc_atomic_fetch_inc_u32(&xhc_trace_buf.head);
+    xhc_trace_rec_t *r = &xhc_trace_buf.rec[n & (XHC_TRACE_DEPTH - 1u)];
+    r->ts = DWT->CYCCNT;
+    r->id = (uint16_t)id;
+    r->a  = a;
+    r->b  = b;
+    __asm volatile ("" ::: "memory");
+    r->seq = (uint16_t)n;
+}
+
+#define XHC_TRACE(id, a, b)  xhc_trace((id), (int32_t)(a), (int32_t)(b))
+
+/* Je Zähler ein Schreiber: Start im Task, Fertig im DMA-IRQ */
+#define XHC_TRACE_DMA_START(len)  do { xhc_trace_buf.dma_last_len = (len); xhc_trace_buf.dma_started++; } while (0)
+#define XHC_TRACE_DMA_DONE()      (xhc_trace_buf.dma_done++)
+
+#else
+
+#define XHC_TRACE(id, a, b)  do { (void)(a); (void)(b); } while (0)
+#define XHC_TRACE_DMA_START(len)  do { (void)(len); } while (0)
+#define XHC_TRACE_DMA_DONE()      do { } while (0)
+
+#endif /* XHC_TRACE_ENABLE */
+
+void xhc_trace_init(uint32_t reset_flags);
+void xhc_trace_reset(void);
+
+#endif /* XHC_TRACE_H */
@@ -0,0 +1,18 @@
+#ifndef XHC_UI_BACKGROUND_H
+#define XHC_UI_BACKGROUND_H
+
+#include <stdint.h>
+
+/*
+ * Statischer UI-Hintergrund (alle Labels, Linien, Statusband) als RLE-Bild.
+ * Daten in xhc_ui_background.c werden von Tools/gen_ui_background.py erzeugt;
+ * nach Layout-Änderungen in xhc_ui_init() dort LAYOUT anpassen und neu generieren.
+ */
+#define XHC_UI_BG_WIDTH     160
+#define XHC_UI_BG_HEIGHT    128
+#define XHC_UI_BG_RLE_SIZE  1154
+
+extern const uint16_t xhc_ui_bg_palette[4];
+extern const uint8_t  xhc_ui_bg_rle[XHC_UI_BG_RLE_SIZE];
+
+#endif /* XHC_UI_BACKGROUND_H */
@@ -0,0 +1,53 @@
+/*
+ * XHC HB04 Unabhängiger Watchdog (IWDG)
+ *
+ * Hängt die Hauptschleife (Error_Handler mit gesperrten IRQs, Fault-Handler,
+ * ST_WaitDMA ohne DMA-Callback), setzt der IWDG den Controller nach
+ * XHC_WDG_TIMEOUT_MS zurück. Gestartet wird direkt nach HAL_Init, vor
+ * SystemClock_Config und den MX_*_Init: ein Error_Handler dort hängt sonst
+ * für immer. Blockierende Init-Schleifen (ST7735_Init) füttern selbst.
+ * Der Flugschreiber (xhc_trace.h) übersteht den Reset,
+ * der neue TRC_BOOT-Eintrag trägt XHC_RESET_IWDG.
+ *
+ * Direkt über Register, das HAL-IWDG-Modul bleibt aus. Angehaltener Kern
+ * im Debugger hält auch den IWDG an (DBGMCU_CR_DBG_IWDG_STOP).
+ */
+
+#ifndef XHC_WDG_H
+#define XHC_WDG_H
+
+#include "main.h"
+
+#ifndef XHC_WDG_ENABLE
+#define XHC_WDG_ENABLE 1
+#endif
+
+/* LSI nominal 40 kHz (30..60 kHz), Teiler 64 -> 625 Hz. Der Panel-Boot
+ * läuft zeitgeteilt, kein Task blockiert annähernd so lange. */
+#define XHC_WDG_TIMEOUT_MS  2000u
+#define XHC_WDG_RELOAD      (XHC_WDG_TIMEOUT_MS * 625u / 1000u)   // max. 4095
+
+#if XHC_WDG_ENABLE
+
+static inline void xhc_wdg_start(void)
+{
+    DBGMCU->CR |= DBGMCU_CR_DBG_IWDG_STOP;
+    IWDG->KR  = 0xCCCCu;            // Start, schaltet auch den LSI ein
+    IWDG->KR  = 0x5555u;            // PR/RLR entsperren
+    IWDG->PR  = IWDG_PR_PR_2;       // /64
+    IWDG->RLR = XHC_WDG_RELOAD;
+    while (IWDG->SR != 0u) { }      // PVU/RVU: Werte im LSI-Takt übernommen
+    IWDG->KR  = 0xAAAAu;
+}
+
+/* Einmal je Hauptschleifen-Durchlauf */
+static inline void xhc_wdg_feed(void) { IWDG->KR = 0xAAAAu; }
+
+#else
+
+static inline void xhc_wdg_start(void) { }
+static inline void xhc_wdg_feed(void)  { }
+
+#endif /* XHC_WDG_ENABLE */
+
+#endif /* XHC_WDG_H */
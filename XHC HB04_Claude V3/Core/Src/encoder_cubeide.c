@@ -6,6 +6,8 @@
 #include "main.h"
 #include "xhc_main.h"
 #include "ST7735.h"
+#include "xhc_atomic.h"
+#include "xhc_trace.h"
 
 /* Encoder Hardware-Konfiguration */
 #define ENCODER_TIMER           TIM2
@@ -24,6 +26,7 @@ static volatile int16_t encoder_speed_buffer[10];  // Ringpuffer für Geschwindi
 static volatile uint8_t speed_buffer_index = 0;
 static volatile int32_t impulse_buffer = 0;
 static volatile uint16_t encoder_last_count = 0;
+static volatile uint8_t encoder_resync_req = 0;      // Hauptschleife -> ISR: neu aufsetzen
 
 /**
  * @brief Encoder Hardware initialisieren
@@ -129,28 +132,6 @@ void encoder_reset(void)
     enc_rem = 0;
 }
 
-/**
- * @brief Test-Funktion: Encoder-Werte auf Display anzeigen
- */
-void encoder_display_test(void)
-{
-    static int32_t total_detents = 0;
-    int16_t new_detents = encoder_read();
-
-    if (new_detents != 0) {
-        total_detents += new_detents;
-    }
-
-    char text[32];
-    sprintf(text, "Enc: %d (%d)", (int)new_detents, (int)total_detents);
-    ST7735_WriteString(0, 130, text, Font_7x10, RED, BLACK);
-
-    /* Rohdaten anzeigen */
-    uint16_t raw_count = (uint16_t)__HAL_TIM_GET_COUNTER(&htim_encoder);
-    sprintf(text, "Raw: %d Rem: %d", raw_count, (int)enc_rem);
-    ST7735_WriteString(0, 140, text, Font_7x10, RED, BLACK);
-}
-
 /**
  * @brief Zeigt gesendete Encoder-Werte an (für USB-Debug)
  */
@@ -188,8 +169,7 @@ void encoder_display_sent_values(void)
  * 3. In main.c nach MX_TIM2_Init():
  *    encoder_init();
  *
- * 4. In main.c while-Schleife:
- *    encoder_display_test();
+ * 4. Kontrolle am Gerät: Diagnoseseite (xhc_overlay.h), Rastungen/s
  *
  * 5. In xhc_main_loop() echte Encoder-Werte verwenden:
  *    int8_t wheel_value = (int8_t)encoder_read(); // Statt 0
@@ -204,43 +184,39 @@ void encoder_display_sent_values(void)
  */
 void encoder_1ms_poll(void)
 {
-	{
-
+    uint16_t current_count = TIM2->CNT;
 
-            uint16_t current_count = TIM2->CNT;
-            int16_t diff = (int16_t)(current_count - encoder_last_count);
-            encoder_last_count = current_count;
+    /* Reset aus der Hauptschleife: auf aktuellen Zählerstand aufsetzen, Rest verwerfen.
+     * encoder_last_count und impulse_buffer schreibt nur diese ISR. */
+    if (encoder_resync_req) {
+        encoder_last_count = current_count;
+        impulse_buffer = 0;
+        encoder_resync_req = 0;
+        return;
+    }
 
-	    if (diff != 0) {
-	        impulse_buffer += diff;
+    int16_t diff = (int16_t)(current_count - encoder_last_count);
+    encoder_last_count = current_count;
 
-	        // 4 Impulse = 1 Rastung
-	        int16_t detents = (int16_t)(impulse_buffer / 4);
-	        if (detents != 0) {
-	            impulse_buffer -= detents * 4;
+    if (diff != 0) {
+        impulse_buffer += diff;
 
+        // 4 Impulse = 1 Rastung
+        int16_t detents = (int16_t)(impulse_buffer / 4);
+        if (detents != 0) {
+            impulse_buffer -= detents * 4;
 
-	            __disable_irq();
-	            encoder_1ms_buffer += detents;  // AKKUMULIERUNG
-	            encoder_data_ready = 1;
-	            last_encoder_time = HAL_GetTick();
-	            __enable_irq();
-	        }
-	    }
-	}
+            xhc_atomic_add_i16(&encoder_1ms_buffer, detents);   // AKKUMULIERUNG
+            encoder_data_ready = 1;
+            last_encoder_time = HAL_GetTick();
+        }
+    }
 }
 
 	int16_t encoder_read_simple_speed(void)
 	{
-	    int16_t accumulated_detents = 0;
-
-	    __disable_irq();
-	    if (encoder_data_ready) {
-	        accumulated_detents = encoder_1ms_buffer;
-	        encoder_1ms_buffer = 0;
-	        encoder_data_ready = 0;
-	    }
-	    __enable_irq();
+	    encoder_data_ready = 0;
+	    int16_t accumulated_detents = xhc_atomic_fetch_clear_i16(&encoder_1ms_buffer);
 
 	    if (accumulated_detents == 0) {
 	        return 0;
@@ -271,16 +247,9 @@ void encoder_1ms_poll(void)
  */
 int16_t encoder_read_1ms(void)
 {
-    int16_t result = 0;
-
-    /* Atomic read */
-    __disable_irq();
-    if (encoder_data_ready && encoder_1ms_buffer != 0) {
-        result = encoder_1ms_buffer;
-        encoder_1ms_buffer = 0;
-        encoder_data_ready = 0;
-    }
-    __enable_irq();
+    /* Atomar abholen (LDREX/STREX, keine IRQ-Sperre) */
+    encoder_data_ready = 0;
+    int16_t result = xhc_atomic_fetch_clear_i16(&encoder_1ms_buffer);
 
     /* Begrenzen */
     if (result > 127) result = 127;
@@ -302,31 +271,19 @@ uint8_t encoder_1ms_has_data(void)
  */
 void encoder_reset_buffers(void)
 {
-    __disable_irq();
-    if (encoder_1ms_buffer != 0) {
-        printf("Reset encoder_1ms_buffer: %d\r\n", encoder_1ms_buffer);
-        encoder_1ms_buffer = 0;
-    }
-    if (impulse_buffer != 0) {
-        printf("Reset impulse_buffer: %ld\r\n", impulse_buffer);
-        impulse_buffer = 0;
-    }
+    /* Kein TIM2->CNT = 0 mehr: die ISR setzt beim nächsten Tick auf den
+     * aktuellen Zählerstand auf (encoder_resync_req). Bis dahin erzeugt sie
+     * keine Rastungen, danach ist der Puffer leer -> keine IRQ-Sperre nötig. */
+    int32_t impulses = impulse_buffer;            // nur für den Trace
+    encoder_resync_req = 1;
+    int16_t pending = xhc_atomic_fetch_clear_i16(&encoder_1ms_buffer);
     encoder_data_ready = 0;
-    // 1. Timer Hardware-Register zurücksetzen
-        uint16_t old_count = TIM2->CNT;
-        TIM2->CNT = 0;  // Hardware-Counter auf 0
-        encoder_last_count = 0;
-        if (old_count != 0) {
-            printf("Reset TIM2->CNT: %d\r\n", old_count);
-        }
 
-        // 2. Encoder-interne Variablen zurücksetzen
-        extern uint16_t enc_prev_cnt;  // Aus encoder_cubeide.c
-        extern int32_t enc_rem;        // Aus encoder_cubeide.c
-        enc_prev_cnt = 0;
-        enc_rem = 0;
+    // Polling-API (encoder_read) ebenfalls neu aufsetzen
+    enc_prev_cnt = (uint16_t)__HAL_TIM_GET_COUNTER(&htim_encoder);
+    enc_rem = 0;
+
+    last_encoder_time = HAL_GetTick();
 
-        // 3. Timing zurücksetzen
-        last_encoder_time = HAL_GetTick();
-    __enable_irq();
+    if (pending != 0 || impulses != 0) XHC_TRACE(TRC_ENC_RESET, pending, impulses);
 }
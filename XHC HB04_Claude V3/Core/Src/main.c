@@ -30,11 +30,15 @@
 #include "XHC_DataStructures.h"
 #include "xhc_main.h"
 #include "st7735_dma.h"
-#include "GFX_FUNCTIONS.h"
 #include "encoder_cubeide.h"
 #include "button_matrix.h"
 #include "rotary_switch.h"
 #include "xhc_display_ui.h"
+#include "xhc_profiler.h"
+#include "xhc_mem.h"
+#include "xhc_irq.h"
+#include "xhc_trace.h"
+#include "xhc_wdg.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -58,8 +62,6 @@
 /* XHC HB04 Variablen */
 extern struct whb04_out_data output_report;
 extern struct whb0x_in_data in_report;
-extern volatile uint32_t debug_setreport_calls;
-extern volatile uint32_t debug_outevent_calls;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -81,6 +83,7 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
+  xhc_mem_paint();   // freien Stack-Bereich markieren (High-Water: Feature-Report 0x10, Seite 3)
 
   /* USER CODE END 1 */
 
@@ -90,6 +93,10 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
+  xhc_prof_init();   // DWT-Zyklenzähler für Messpunkte (Auslesen: Feature-Report 0x10)
+  xhc_trace_init(RCC->CSR);        // Flugschreiber aus .noinit übernehmen, TRC_BOOT mit Reset-Ursache
+  __HAL_RCC_CLEAR_RESET_FLAGS();
+  xhc_wdg_start();   // IWDG vor Takt- und Peripherie-Init: auch ein Error_Handler dort endet im Reset
 
   /* USER CODE END Init */
 
@@ -107,30 +114,25 @@ int main(void)
   MX_USB_DEVICE_Init();
   MX_TIM2_Init();
   /* USER CODE BEGIN 2 */
-  ST7735_Init();
+  ST7735_InitStart();   // Panel-Init läuft zeitgeteilt im UI-Task (xhc_ui_boot_service)
 
 
   xhc_custom_hid_init();
   encoder_init();
   button_matrix_init();
   rotary_switch_init();
-  xhc_ui_init();
-  xhc_ui_update_status_bar(rotary_switch_read(), output_report.step_mul);
-  //run_display_performance_tests();
-
-  //fillScreen(WHITE);
-  //testAll();
+  xhc_main_tasks_init();
+  xhc_irq_check();      // NVIC-Prioritäten gegen Plan (xhc_irq.h), Abweichung per printf
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-	  xhc_main_loop();
+	  xhc_wdg_feed();
+	  xhc_main_loop();   // Scheduler: Encoder > USB > Tasten > Drehschalter > UI, sonst WFI
 	  //xhc_main_loop_encoder_only();
-	  //encoder_display_test();
 	  //button_matrix_display_test();
-	  //rotary_switch_display_test();// <- NEU: Button-Test
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -213,6 +215,7 @@ void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
   /* User can add his own implementation to report the HAL error return state */
+  XHC_TRACE(TRC_ERROR, (uint32_t)(uintptr_t)__builtin_return_address(0), 0);   // Reset danach durch den IWDG (läuft ab USER CODE Init)
   __disable_irq();
   while (1)
   {
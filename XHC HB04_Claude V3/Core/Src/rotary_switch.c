@@ -1,7 +1,5 @@
 #include "main.h"
 #include "rotary_switch.h"
-#include "ST7735.h"
-#include <stdio.h>
 
 /* Hardware-Definitionen */
 #define ROT_POS1_GPIO_Port  GPIOB
@@ -25,7 +23,6 @@ void rotary_switch_init(void)
 
 uint8_t rotary_switch_read(void)
 {
-    static uint8_t last_position = ROTARY_OFF;
     static uint32_t off_start_time = 0;
     static uint8_t stable_position = ROTARY_OFF;
 
@@ -66,41 +63,5 @@ uint8_t rotary_switch_read(void)
         stable_position = ROTARY_OFF;
     }
 
-    last_position = stable_position;
     return stable_position;
 }
-
-void rotary_switch_display_test(void)
-{
-    uint8_t pos = rotary_switch_read();
-    char text[32];
-
-    sprintf(text, "Rot: 0x%02X", pos);
-    ST7735_WriteString(0, 110, text, Font_7x10, YELLOW, BLACK);
-
-    const char* pos_name;
-    switch(pos) {
-        case ROTARY_X: pos_name = "X-AXIS"; break;
-        case ROTARY_Y: pos_name = "Y-AXIS"; break;
-        case ROTARY_Z: pos_name = "Z-AXIS"; break;
-        case ROTARY_SPINDLE: pos_name = "SPINDLE"; break;
-        case ROTARY_FEED: pos_name = "FEED"; break;
-        case ROTARY_A: pos_name = "A-AXIS"; break;
-        default: pos_name = "OFF"; break;
-    }
-
-    sprintf(text, "Pos: %s", pos_name);
-    ST7735_WriteString(0, 120, text, Font_7x10, YELLOW, BLACK);
-
-    /* Debug: Zeige Hardware-Pins direkt */
-    uint8_t pin_states = 0;
-    if (!HAL_GPIO_ReadPin(ROT_POS1_GPIO_Port, ROT_POS1_Pin)) pin_states |= 0x01;
-    if (!HAL_GPIO_ReadPin(ROT_POS2_GPIO_Port, ROT_POS2_Pin)) pin_states |= 0x02;
-    if (!HAL_GPIO_ReadPin(ROT_POS3_GPIO_Port, ROT_POS3_Pin)) pin_states |= 0x04;
-    if (!HAL_GPIO_ReadPin(ROT_POS4_GPIO_Port, ROT_POS4_Pin)) pin_states |= 0x08;
-    if (!HAL_GPIO_ReadPin(ROT_POS5_GPIO_Port, ROT_POS5_Pin)) pin_states |= 0x10;
-    if (!HAL_GPIO_ReadPin(ROT_POS6_GPIO_Port, ROT_POS6_Pin)) pin_states |= 0x20;
-
-    sprintf(text, "HW: 0x%02X", pin_states);
-    ST7735_WriteString(0, 130, text, Font_7x10, WHITE, BLACK);
-}
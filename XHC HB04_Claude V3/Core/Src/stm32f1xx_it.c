@@ -22,6 +22,10 @@
 #include "stm32f1xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "xhc_profiler.h"
+#include "xhc_mem.h"
+#include "xhc_irq.h"
+#include "xhc_trace.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -52,6 +56,17 @@
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+/**
+ * @brief Fault in den Flugschreiber (xhc_trace.h), danach hängt der Handler
+ *        bis der IWDG zurücksetzt; die Einträge überleben den Reset
+ * @param exc Exception-Nummer (3 HardFault, 4 MemManage, 5 BusFault, 6 UsageFault)
+ */
+static void xhc_trace_fault(uint32_t exc)
+{
+  XHC_TRACE(TRC_FAULT, exc, SCB->CFSR);
+  XHC_TRACE(TRC_FAULT_ADDR, SCB->BFAR, SCB->MMFAR);
+}
+
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
@@ -85,7 +100,7 @@ void NMI_Handler(void)
 void HardFault_Handler(void)
 {
   /* USER CODE BEGIN HardFault_IRQn 0 */
-
+  xhc_trace_fault(3);
   /* USER CODE END HardFault_IRQn 0 */
   while (1)
   {
@@ -100,7 +115,7 @@ void HardFault_Handler(void)
 void MemManage_Handler(void)
 {
   /* USER CODE BEGIN MemoryManagement_IRQn 0 */
-
+  xhc_trace_fault(4);
   /* USER CODE END MemoryManagement_IRQn 0 */
   while (1)
   {
@@ -115,7 +130,7 @@ void MemManage_Handler(void)
 void BusFault_Handler(void)
 {
   /* USER CODE BEGIN BusFault_IRQn 0 */
-
+  xhc_trace_fault(5);
   /* USER CODE END BusFault_IRQn 0 */
   while (1)
   {
@@ -130,7 +145,7 @@ void BusFault_Handler(void)
 void UsageFault_Handler(void)
 {
   /* USER CODE BEGIN UsageFault_IRQn 0 */
-
+  xhc_trace_fault(6);
   /* USER CODE END UsageFault_IRQn 0 */
   while (1)
   {
@@ -171,9 +186,13 @@ void DebugMon_Handler(void)
 void PendSV_Handler(void)
 {
   /* USER CODE BEGIN PendSV_IRQn 0 */
+  XHC_MEM_ISR_ENTRY(MEM_ISR_PENDSV);
+  XHC_PROF_BEGIN(PROF_ISR_PENDSV);
 
   /* USER CODE END PendSV_IRQn 0 */
   /* USER CODE BEGIN PendSV_IRQn 1 */
+  xhc_irq_pendsv();   // verzögerte Arbeit aus USB-IRQ (xhc_irq.h)
+  XHC_PROF_END(PROF_ISR_PENDSV);
 
   /* USER CODE END PendSV_IRQn 1 */
 }
@@ -184,12 +203,16 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
+  XHC_PROF_SYSTICK_LATENCY();
+  XHC_MEM_ISR_ENTRY(MEM_ISR_SYSTICK);
+  XHC_PROF_BEGIN(PROF_ISR_SYSTICK);
 
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
   extern void encoder_1ms_poll(void);
   encoder_1ms_poll();
+  XHC_PROF_END(PROF_ISR_SYSTICK);
   /* USER CODE END SysTick_IRQn 1 */
 }
 
@@ -206,10 +229,13 @@ void SysTick_Handler(void)
 void DMA1_Channel3_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA1_Channel3_IRQn 0 */
+  XHC_MEM_ISR_ENTRY(MEM_ISR_DMA_SPI);
+  XHC_PROF_BEGIN(PROF_ISR_DMA_SPI);
 
   /* USER CODE END DMA1_Channel3_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_spi1_tx);
   /* USER CODE BEGIN DMA1_Channel3_IRQn 1 */
+  XHC_PROF_END(PROF_ISR_DMA_SPI);
 
   /* USER CODE END DMA1_Channel3_IRQn 1 */
 }
@@ -220,10 +246,13 @@ void DMA1_Channel3_IRQHandler(void)
 void USB_LP_CAN1_RX0_IRQHandler(void)
 {
   /* USER CODE BEGIN USB_LP_CAN1_RX0_IRQn 0 */
+  XHC_MEM_ISR_ENTRY(MEM_ISR_USB);
+  XHC_PROF_BEGIN(PROF_ISR_USB);
 
   /* USER CODE END USB_LP_CAN1_RX0_IRQn 0 */
   HAL_PCD_IRQHandler(&hpcd_USB_FS);
   /* USER CODE BEGIN USB_LP_CAN1_RX0_IRQn 1 */
+  XHC_PROF_END(PROF_ISR_USB);
 
   /* USER CODE END USB_LP_CAN1_RX0_IRQn 1 */
 }
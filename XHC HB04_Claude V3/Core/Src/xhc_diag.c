@@ -0,0 +1,223 @@
+/*
+ * XHC HB04 Diagnose-Feature-Report (Report ID 0x10)
+ *
+ * Läuft komplett im USB-IRQ (Control-Transfer auf EP0), deshalb hier nur
+ * kopieren, nichts berechnen was länger dauert. Resets (Speicher neu
+ * bemalen!) laufen verzögert in PendSV (xhc_irq.h).
+ */
+
+#include "xhc_diag.h"
+#include "xhc_profiler.h"
+#include "xhc_sched.h"
+#include "xhc_mem.h"
+#include "xhc_irq.h"
+#include "xhc_trace.h"
+#include "st7735_fb.h"
+#include <string.h>
+
+static uint8_t diag_page  = XHC_DIAG_PAGE_PROFILER;
+static uint8_t diag_index = 0;
+static uint8_t diag_buf[XHC_DIAG_REPORT_LEN];
+static volatile uint8_t diag_reset_page = 0;    // 0 = kein Reset offen
+
+static inline void put_u16(uint8_t *p, uint16_t v) { memcpy(p, &v, 2); }
+static inline void put_u32(uint8_t *p, uint32_t v) { memcpy(p, &v, 4); }
+
+/*
+ * Profiler-Seite, ab Byte 3:
+ *  [3]      Anzahl Messpunkte
+ *  [4..11]  Name (ASCII, mit 0 aufgefüllt)
+ *  [12..15] Anzahl Messungen
+ *  [16..19] Min-Zyklen   [20..23] Max-Zyklen   [24..27] Mittel-Zyklen
+ *  [28..63] Histogramm, XHC_PROF_HIST_BINS x uint16
+ */
+static uint8_t diag_fill_profiler(uint8_t index, uint8_t *p)
+{
+    xhc_prof_stat_t s;
+    if (!xhc_prof_snapshot(index, &s)) return 0;
+
+    p[3] = PROF_COUNT;
+    strncpy((char*)&p[4], xhc_prof_name(index), 8);
+    put_u32(&p[12], s.count);
+    put_u32(&p[16], s.min);
+    put_u32(&p[20], s.max);
+    put_u32(&p[24], s.count ? (uint32_t)(s.sum / s.count) : 0u);
+    for (uint8_t i = 0; i < XHC_PROF_HIST_BINS; i++) {
+        put_u16(&p[28 + 2u * i], s.hist[i]);
+    }
+    return PROF_COUNT;
+}
+
+/*
+ * Scheduler-Seite, ab Byte 3:
+ *  [3]      Anzahl Tasks
+ *  [4..11]  Name
+ *  [12..15] Läufe   [16..19] Deadline-Misses
+ *  [20..21] max. Verspätung ms   [22..23] Periode ms   [24..25] Deadline ms
+ */
+static uint8_t diag_fill_sched(uint8_t index, uint8_t *p)
+{
+    const xhc_task_t *t = xhc_sched_task(index);
+    if (t == NULL) return 0;
+
+    p[3] = xhc_sched_task_count();
+    strncpy((char*)&p[4], t->name, 8);
+    put_u32(&p[12], t->runs);
+    put_u32(&p[16], t->misses);
+    put_u16(&p[20], t->max_late_ms);
+    put_u16(&p[22], t->period_ms);
+    put_u16(&p[24], t->deadline_ms);
+    return p[3];
+}
+
+/*
+ * Speicher-Seite, ab Byte 3:
+ *  [3]      Anzahl Einträge (1 + ISRs)
+ *  [4..11]  Name ("ram" bzw. ISR-Name)
+ *  Index 0: [12..43] RAM gesamt, .data, .bss, Heap benutzt, Heap-Reserve,
+ *                    Stack-Reserve, Stack-Spitze, Luft Heap/Stack (je uint32)
+ *          [44..47] SRAM-Code (.ramfunc)   [48..51] Flugschreiber (.noinit)
+ *          [52..55] Schattenspeicher (ST7735_FB_RamUsage, 0 wenn aus)
+ *  sonst:   [12..15] Stack-Tiefe beim Eintritt in die ISR
+ */
+static uint8_t diag_fill_memory(uint8_t index, uint8_t *p)
+{
+    const uint8_t entries = 1u + MEM_ISR_COUNT;
+    if (index >= entries) return 0;
+
+    p[3] = entries;
+    if (index == 0) {
+        xhc_mem_stat_t s;
+        xhc_mem_stats(&s);
+        strncpy((char*)&p[4], "ram", 8);
+        put_u32(&p[12], s.ram_total);
+        put_u32(&p[16], s.data);
+        put_u32(&p[20], s.bss);
+        put_u32(&p[24], s.heap_used);
+        put_u32(&p[28], s.heap_min);
+        put_u32(&p[32], s.stack_min);
+        put_u32(&p[36], s.stack_peak);
+        put_u32(&p[40], s.headroom);
+        put_u32(&p[44], s.ramfunc);
+        put_u32(&p[48], s.noinit);
+        put_u32(&p[52], ST7735_FB_RamUsage());
+    } else {
+        xhc_mem_isr_t id = (xhc_mem_isr_t)(index - 1u);
+        strncpy((char*)&p[4], xhc_mem_isr_name(id), 8);
+        put_u32(&p[12], xhc_mem_isr_depth(id));
+    }
+    return entries;
+}
+
+/*
+ * Trace-Seite, ab Byte 3:
+ *  [3]      Anzahl Reports für den ganzen Ring
+ *  [4..7]   Schreibzähler head zum Zeitpunkt des GET
+ *  [8..11]  Ring-Tiefe (Datensätze)   [12..15] CPU-Takt Hz (Zeitstempel)
+ *  [16..63] Ring-Plätze 3*index .. 3*index+2, je 16 Byte wie xhc_trace_rec_t
+ * Die Plätze sind roh kopiert; Reihenfolge und Gültigkeit ergeben sich
+ * beim Host aus head und der Folgenummer jedes Datensatzes.
+ */
+#define DIAG_TRACE_PER_REPORT  3u
+
+static uint8_t diag_fill_trace(uint8_t index, uint8_t *p)
+{
+    const uint8_t entries = (uint8_t)((XHC_TRACE_DEPTH + DIAG_TRACE_PER_REPORT - 1u) / DIAG_TRACE_PER_REPORT);
+    if (index >= entries) return 0;
+
+    p[3] = entries;
+    put_u32(&p[4], xhc_trace_buf.head);
+    put_u32(&p[8], XHC_TRACE_DEPTH);
+    put_u32(&p[12], SystemCoreClock);
+    for (uint8_t i = 0; i < DIAG_TRACE_PER_REPORT; i++) {
+        uint32_t slot = (uint32_t)index * DIAG_TRACE_PER_REPORT + i;
+        if (slot >= XHC_TRACE_DEPTH) break;
+        memcpy(&p[16 + 16u * i], &xhc_trace_buf.rec[slot], sizeof(xhc_trace_rec_t));
+    }
+    return entries;
+}
+
+/*
+ * IRQ-Seite, ab Byte 3:
+ *  [3]      Anzahl IRQs im Plan
+ *  [4..11]  Name
+ *  [12] Preemption Ist   [13] Sub Ist   [14] Preemption Soll   [15] Sub Soll
+ *  [16] Prioritätsgruppe Ist   [17] Prioritätsgruppe Soll
+ * Gelesen wird der NVIC bei jedem GET, also auch spätere Überschreibungen.
+ */
+static uint8_t diag_fill_irq(uint8_t index, uint8_t *p)
+{
+    xhc_irq_state_t st;
+    if (!xhc_irq_state(index, &st)) return 0;
+
+    p[3] = xhc_irq_count();
+    memcpy(&p[4], st.name, 8);
+    p[12] = st.prio;
+    p[13] = st.sub;
+    p[14] = st.plan_prio;
+    p[15] = st.plan_sub;
+    p[16] = st.group;
+    p[17] = st.plan_group;
+    return p[3];
+}
+
+/**
+ * @brief Host wählt Seite/Index bzw. löscht Statistik
+ */
+void xhc_diag_set_report(const uint8_t *report, uint16_t len)
+{
+    if (len < 3 || report[0] != XHC_DIAG_REPORT_ID) return;
+
+    diag_page  = report[1];
+    diag_index = report[2];
+
+    if (len >= 4 && report[3] == XHC_DIAG_CMD_RESET) {
+        diag_reset_page = diag_page;
+        xhc_irq_defer(XHC_DEFER_DIAG);
+    }
+}
+
+/**
+ * @brief Führt einen angeforderten Reset aus (PendSV, xhc_irq.h)
+ */
+void xhc_diag_deferred(void)
+{
+    uint8_t page = diag_reset_page;
+    diag_reset_page = 0;
+
+    switch (page) {
+        case XHC_DIAG_PAGE_PROFILER: xhc_prof_reset(); break;
+        case XHC_DIAG_PAGE_SCHED:    xhc_sched_reset_stats(); break;
+        case XHC_DIAG_PAGE_MEMORY:   xhc_mem_reset(); break;
+        case XHC_DIAG_PAGE_TRACE:    xhc_trace_reset(); break;
+        default: break;
+    }
+}
+
+/**
+ * @brief Baut die Antwort auf GET_REPORT 0x10
+ * @param len [out] Länge inkl. Report-ID
+ */
+uint8_t *xhc_diag_get_report(uint16_t *len)
+{
+    uint8_t entries = 0;
+
+    memset(diag_buf, 0, sizeof(diag_buf));
+    diag_buf[0] = XHC_DIAG_REPORT_ID;
+    diag_buf[1] = diag_page;
+    diag_buf[2] = diag_index;
+
+    switch (diag_page) {
+        case XHC_DIAG_PAGE_PROFILER: entries = diag_fill_profiler(diag_index, diag_buf); break;
+        case XHC_DIAG_PAGE_SCHED:    entries = diag_fill_sched(diag_index, diag_buf); break;
+        case XHC_DIAG_PAGE_MEMORY:   entries = diag_fill_memory(diag_index, diag_buf); break;
+        case XHC_DIAG_PAGE_TRACE:    entries = diag_fill_trace(diag_index, diag_buf); break;
+        case XHC_DIAG_PAGE_IRQ:      entries = diag_fill_irq(diag_index, diag_buf); break;
+        default: break;
+    }
+
+    diag_index = entries ? (uint8_t)((diag_index + 1u) % entries) : 0u;
+
+    *len = XHC_DIAG_REPORT_LEN;
+    return diag_buf;
+}
@@ -2,6 +2,12 @@
 #include "xhc_receive.h"
 #include "rotary_switch.h"
 #include "st7735_dma.h"
+#include "xhc_ui_background.h"
+#include "xhc_main.h"
+#include "xhc_profiler.h"
+#include "xhc_predict.h"
+#include "xhc_trace.h"
+#include "xhc_overlay.h"
 #include "XHC_DataStructures.h"
 #include <stdio.h>
 #include "user_defines.h"
@@ -10,6 +16,11 @@
 
 static uint8_t ui_initialized = 0;
 static uint8_t lastposition = 0;
+static uint8_t dro_invalid = 0;     // Hintergrund neu gezeichnet, Cache der Koordinaten ungültig
+static uint8_t dro_refresh = 0;     // nach xhc_ui_redraw: Werte im nächsten UI-Lauf zeichnen
+
+/* Y-Position der DRO-Zeilen: WC X/Y/Z, MC X/Y/Z */
+static const uint8_t dro_row_y[6] = { 2, 17, 32, 49, 64, 79 };
 
 
 // kleine Helfer
@@ -22,9 +33,17 @@ static inline void VLine(int x, int y, int h, uint16_t c){
 
 void xhc_ui_init(void)
 {
+#if XHC_UI_RLE_BACKGROUND
+    /* Kompletter statischer Hintergrund in einem DMA-Durchlauf (auch bei Re-Init) */
+    ST7735_DrawRLE(0, 0, XHC_UI_BG_WIDTH, XHC_UI_BG_HEIGHT,
+                   xhc_ui_bg_rle, XHC_UI_BG_RLE_SIZE, xhc_ui_bg_palette);
+    ST7735_barProgressInvalidate();   // Balken wurden gerade übermalt
+    ui_initialized = 1;
+#else
 
 	ST7735_FillScreen(ST7735_WHITE);
     ST7735_FillRectangle(0, 94, DISPLAY_WIDTH, 34, ST7735_BLUE);
+    ST7735_barProgressInvalidate();   // Balken wurden gerade übermalt
 
 
     if (ui_initialized) return;
@@ -89,6 +108,52 @@ void xhc_ui_init(void)
     //ST7735_DrawRect(60, 17, 98, 13, ST7735_BLUE,1); // WC Y
     //ST7735_DrawRect(60, 32, 98, 13, ST7735_BLUE,1); // WC Z
     ui_initialized = 1;
+#endif /* XHC_UI_RLE_BACKGROUND */
+}
+
+
+/**
+ * @brief Bringt Panel und UI im Hintergrund hoch (zyklisch aus der Hauptschleife)
+ * @return 1 sobald die UI steht
+ *
+ * USB und Eingaben laufen währenddessen normal weiter; Zeichenaufrufe vor
+ * diesem Zeitpunkt werden von den Update-Funktionen verworfen.
+ */
+uint8_t xhc_ui_boot_service(void)
+{
+    if (ui_initialized) {
+        if (dro_refresh) {
+            dro_refresh = 0;
+            xhc_ui_update_coordinates();
+            xhc_ui_update_status_bar(rotary_switch_read(), output_report.step_mul);
+        }
+        return 1;
+    }
+    if (!ST7735_InitStep()) return 0;
+
+    xhc_boot_times.display_ready_ms = HAL_GetTick();
+    xhc_ui_init();
+    xhc_ui_update_status_bar(rotary_switch_read(), output_report.step_mul);
+    xhc_boot_times.ui_ready_ms = HAL_GetTick();
+    XHC_TRACE(TRC_UI_READY, xhc_boot_times.ui_ready_ms, 0);
+    return 1;
+}
+
+/**
+ * @brief Komplette DRO neu zeichnen (nach der Diagnoseseite, xhc_overlay.h)
+ *
+ * Hier nur der Hintergrund; Werte und Statusleiste zeichnet der nächste
+ * UI-Lauf (xhc_ui_boot_service), damit kein Lauf zwei Vollbilder dauert.
+ */
+void xhc_ui_redraw(void)
+{
+    if (!ui_initialized) return;
+
+    ui_initialized = 0;          // xhc_ui_init zeichnet dann auch die Labels
+    xhc_ui_init();
+    lastposition = 0xFF;         // Achs-Label der aktuellen Position neu einfärben
+    dro_invalid = 1;
+    dro_refresh = 1;
 }
 
 
@@ -121,46 +186,68 @@ void xhc_ui_update_coordinates(void)
 {
     char text[20];
 
+    if (!ui_initialized) return;   // Panel bootet noch (ST7735_InitStep)
+    if (xhc_overlay_active()) return;   // Diagnoseseite statt DRO
+    XHC_PROF_BEGIN(PROF_UI_COORDS);
+
     // Statische Variablen für Cache
     static int32_t last_wc_x_int = -999999, last_wc_y_int = -999999, last_wc_z_int = -999999;
     static int32_t last_mc_x_int = -999999, last_mc_y_int = -999999, last_mc_z_int = -999999;
     static uint16_t last_wc_x_frac = 0xFFFF, last_wc_y_frac = 0xFFFF, last_wc_z_frac = 0xFFFF;
     static uint16_t last_mc_x_frac = 0xFFFF, last_mc_y_frac = 0xFFFF, last_mc_z_frac = 0xFFFF;
+    static uint8_t last_marker = XHC_PREDICT_NONE;
+
+    if (dro_invalid) {
+        last_wc_x_int = last_wc_y_int = last_wc_z_int = -999999;
+        last_mc_x_int = last_mc_y_int = last_mc_z_int = -999999;
+        last_wc_x_frac = last_wc_y_frac = last_wc_z_frac = 0xFFFF;
+        last_mc_x_frac = last_mc_y_frac = last_mc_z_frac = 0xFFFF;
+        last_marker = XHC_PREDICT_NONE;    // Markierungen hat der Hintergrund übermalt
+        dro_invalid = 0;
+    }
+
+    // Anzeige-Kopie, ggf. mit vorausgesagtem Rad-Anteil (xhc_predict)
+    uint16_t p_int[6], p_frac[6];
+    for (int i = 0; i < 6; i++) {
+        p_int[i]  = output_report.pos[i].p_int;
+        p_frac[i] = output_report.pos[i].p_frac;
+    }
+    xhc_predict_apply(p_int, p_frac);
 
     // WC X - nur update wenn geändert
-    uint16_t x_frac = output_report.pos[0].p_frac;
+    uint16_t x_frac = p_frac[0];
     uint8_t x_negative = (x_frac & 0x8000) ? 1 : 0;
     x_frac &= 0x7FFF;
-    int32_t wc_x_int = x_negative ? -(int32_t)output_report.pos[0].p_int : (int32_t)output_report.pos[0].p_int;
+    int32_t wc_x_int = x_negative ? -(int32_t)p_int[0] : (int32_t)p_int[0];
 
     if (wc_x_int != last_wc_x_int || x_frac != last_wc_x_frac) {
-        format_coordinate(text, (int)output_report.pos[0].p_int, x_frac, x_negative);
+        format_coordinate(text, (int)p_int[0], x_frac, x_negative);
         ST7735_WriteString(50, 2, text, Font_9x11, ST7735_BLACK, ST7735_WHITE);
         last_wc_x_int = wc_x_int;
         last_wc_x_frac = x_frac;
     }
 
     // WC Y - nur update wenn geändert
-    uint16_t y_frac = output_report.pos[1].p_frac;
+    uint16_t y_frac = p_frac[1];
     uint8_t y_negative = (y_frac & 0x8000) ? 1 : 0;
     y_frac &= 0x7FFF;
-    int32_t wc_y_int = y_negative ? -(int32_t)output_report.pos[1].p_int : (int32_t)output_report.pos[1].p_int;
+    int32_t wc_y_int = y_negative ? -(int32_t)p_int[1] : (int32_t)p_int[1];
 
     if (wc_y_int != last_wc_y_int || y_frac != last_wc_y_frac) {
-        format_coordinate(text, (int)output_report.pos[1].p_int, y_frac, y_negative);
+        format_coordinate(text, (int)p_int[1], y_frac, y_negative);
         ST7735_WriteString(50, 17, text, Font_9x11, ST7735_BLACK, ST7735_WHITE);
         last_wc_y_int = wc_y_int;
         last_wc_y_frac = y_frac;
     }
 
     // WC Z - nur update wenn geändert
-    uint16_t z_frac = output_report.pos[2].p_frac;
+    uint16_t z_frac = p_frac[2];
     uint8_t z_negative = (z_frac & 0x8000) ? 1 : 0;
     z_frac &= 0x7FFF;
-    int32_t wc_z_int = z_negative ? -(int32_t)output_report.pos[2].p_int : (int32_t)output_report.pos[2].p_int;
+    int32_t wc_z_int = z_negative ? -(int32_t)p_int[2] : (int32_t)p_int[2];
 
     if (wc_z_int != last_wc_z_int || z_frac != last_wc_z_frac) {
-        format_coordinate(text, (int)output_report.pos[2].p_int, z_frac, z_negative);
+        format_coordinate(text, (int)p_int[2], z_frac, z_negative);
         ST7735_WriteString(50, 32, text, Font_9x11, ST7735_BLACK, ST7735_WHITE);
         last_wc_z_int = wc_z_int;
         last_wc_z_frac = z_frac;
@@ -168,44 +255,59 @@ void xhc_ui_update_coordinates(void)
 
     // MC Koordinaten - gleiche Logik
     // MC X
-    uint16_t mx_frac = output_report.pos[3].p_frac;
+    uint16_t mx_frac = p_frac[3];
     uint8_t mx_negative = (mx_frac & 0x8000) ? 1 : 0;
     mx_frac &= 0x7FFF;
-    int32_t mc_x_int = mx_negative ? -(int32_t)output_report.pos[3].p_int : (int32_t)output_report.pos[3].p_int;
+    int32_t mc_x_int = mx_negative ? -(int32_t)p_int[3] : (int32_t)p_int[3];
 
     if (mc_x_int != last_mc_x_int || mx_frac != last_mc_x_frac) {
-        format_coordinate(text, (int)output_report.pos[3].p_int, mx_frac, mx_negative);
+        format_coordinate(text, (int)p_int[3], mx_frac, mx_negative);
         ST7735_WriteString(50, 49, text, Font_9x11, ST7735_BLACK, ST7735_WHITE);
         last_mc_x_int = mc_x_int;
         last_mc_x_frac = mx_frac;
     }
 
     // MC Y
-    uint16_t my_frac = output_report.pos[4].p_frac;
+    uint16_t my_frac = p_frac[4];
     uint8_t my_negative = (my_frac & 0x8000) ? 1 : 0;
     my_frac &= 0x7FFF;
-    int32_t mc_y_int = my_negative ? -(int32_t)output_report.pos[4].p_int : (int32_t)output_report.pos[4].p_int;
+    int32_t mc_y_int = my_negative ? -(int32_t)p_int[4] : (int32_t)p_int[4];
 
     if (mc_y_int != last_mc_y_int || my_frac != last_mc_y_frac) {
-    	format_coordinate(text, (int)output_report.pos[4].p_int, my_frac, my_negative);
+    	format_coordinate(text, (int)p_int[4], my_frac, my_negative);
         ST7735_WriteString(50, 64, text, Font_9x11, ST7735_BLACK, ST7735_WHITE);
         last_mc_y_int = mc_y_int;
         last_mc_y_frac = my_frac;
     }
 
     // MC Z
-    uint16_t mz_frac = output_report.pos[5].p_frac;
+    uint16_t mz_frac = p_frac[5];
     uint8_t mz_negative = (mz_frac & 0x8000) ? 1 : 0;
     mz_frac &= 0x7FFF;
-    int32_t mc_z_int = mz_negative ? -(int32_t)output_report.pos[5].p_int : (int32_t)output_report.pos[5].p_int;
+    int32_t mc_z_int = mz_negative ? -(int32_t)p_int[5] : (int32_t)p_int[5];
 
     if (mc_z_int != last_mc_z_int || mz_frac != last_mc_z_frac) {
-    	format_coordinate(text, (int)output_report.pos[5].p_int, mz_frac, mz_negative);
+    	format_coordinate(text, (int)p_int[5], mz_frac, mz_negative);
         ST7735_WriteString(50, 79, text, Font_9x11, ST7735_BLACK, ST7735_WHITE);
         last_mc_z_int = mc_z_int;
         last_mc_z_frac = mz_frac;
     }
 
+    // Vorhersage-Markierung rechts neben WC- und MC-Wert der Achse
+    uint8_t marker = xhc_predict_axis();
+    if (marker != last_marker) {
+        if (last_marker != XHC_PREDICT_NONE) {
+            ST7735_FillRectangle(152, dro_row_y[last_marker] + 4, 3, 3, ST7735_WHITE);
+            ST7735_FillRectangle(152, dro_row_y[last_marker + 3] + 4, 3, 3, ST7735_WHITE);
+        }
+        if (marker != XHC_PREDICT_NONE) {
+            ST7735_FillRectangle(152, dro_row_y[marker] + 4, 3, 3, ST7735_BLUE);
+            ST7735_FillRectangle(152, dro_row_y[marker + 3] + 4, 3, 3, ST7735_BLUE);
+        }
+        last_marker = marker;
+    }
+    XHC_PROF_END(PROF_UI_COORDS);
+
 
 
 
@@ -214,6 +316,9 @@ void xhc_ui_update_coordinates(void)
 
 void xhc_ui_update_status_bar(uint8_t rotary_pos, uint8_t step_mul)
 {
+    if (!ui_initialized) return;   // Panel bootet noch (ST7735_InitStep)
+    if (xhc_overlay_active()) return;
+    XHC_PROF_BEGIN(PROF_UI_STATUS);
 
     char text[10];
 
@@ -303,6 +408,7 @@ void xhc_ui_update_status_bar(uint8_t rotary_pos, uint8_t step_mul)
     sprintf(text, "%3u%%", feed_percent);
     ST7735_FillRectangle(63, 105, 31,7,ST7735_BLUE);
     ST7735_WriteString(63, 105, text, Font_7x10, ST7735_WHITE, ST7735_BLUE);
+    XHC_PROF_END(PROF_UI_STATUS);
 
 
 
@@ -0,0 +1,110 @@
+/*
+ * XHC HB04 Interrupt-Prioritäten und verzögerte Arbeit, siehe xhc_irq.h
+ */
+
+#include "xhc_irq.h"
+#include "xhc_atomic.h"
+#include "xhc_profiler.h"
+#include "xhc_receive.h"
+#include "xhc_diag.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+static volatile int32_t  defer_pending = 0;    // Bit je xhc_defer_t
+static volatile uint32_t defer_t0 = 0;         // CYCCNT beim ersten Anstoßen
+
+/**
+ * @brief Arbeit nach PendSV verschieben (aus jeder ISR und der Hauptschleife)
+ *
+ * Mehrfaches Anstoßen vor dem Lauf wird zu einem Aufruf zusammengefasst;
+ * die Jobs müssen ihre Eingaben daher selbst puffern.
+ */
+void xhc_irq_defer(xhc_defer_t job)
+{
+    if (xhc_atomic_fetch_or_i32(&defer_pending, (int32_t)(1u << job)) == 0) {
+        defer_t0 = xhc_prof_now();   // Latenz ab dem ersten offenen Job
+    }
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+/**
+ * @brief Rumpf von PendSV_Handler: alle offenen Jobs abarbeiten
+ */
+void xhc_irq_pendsv(void)
+{
+#if XHC_PROF_ENABLE
+    xhc_prof_record(PROF_LAT_PENDSV, xhc_prof_now() - defer_t0);
+#endif
+
+    int32_t jobs;
+    while ((jobs = xhc_atomic_fetch_clear_i32(&defer_pending)) != 0) {
+        if (jobs & (1 << XHC_DEFER_RX))   xhc_recv_deferred();
+        if (jobs & (1 << XHC_DEFER_DIAG)) xhc_diag_deferred();
+    }
+}
+
+/* Plan aus xhc_irq.h, Reihenfolge = Diagnose-Seite IRQ */
+static const struct {
+    IRQn_Type irq;
+    uint8_t   prio;
+    uint8_t   sub;
+    char      name[8];
+} irq_plan[] = {
+    { SysTick_IRQn,         XHC_IRQ_PRIO_TICK,   XHC_IRQ_SUB_TICK,   "SysTick" },
+    { DMA1_Channel3_IRQn,   XHC_IRQ_PRIO_DMA,    XHC_IRQ_SUB_DMA,    "DMA1_3"  },
+    { USB_LP_CAN1_RX0_IRQn, XHC_IRQ_PRIO_USB,    XHC_IRQ_SUB_USB,    "USB_LP"  },
+    { PendSV_IRQn,          XHC_IRQ_PRIO_PENDSV, XHC_IRQ_SUB_PENDSV, "PendSV"  },
+};
+
+#define IRQ_PLAN_COUNT  (sizeof(irq_plan) / sizeof(irq_plan[0]))
+
+uint8_t xhc_irq_count(void)
+{
+    return (uint8_t)IRQ_PLAN_COUNT;
+}
+
+/**
+ * @brief Ist- und Soll-Priorität eines IRQs aus dem Plan (Diagnose-Seite IRQ)
+ * @return 0 bei ungültigem Index
+ */
+uint8_t xhc_irq_state(uint8_t index, xhc_irq_state_t *out)
+{
+    if (index >= IRQ_PLAN_COUNT) return 0;
+
+    uint32_t prio, sub;
+    HAL_NVIC_GetPriority(irq_plan[index].irq, XHC_IRQ_PRIO_GROUP, &prio, &sub);
+
+    memcpy(out->name, irq_plan[index].name, sizeof(out->name));
+    out->prio       = (uint8_t)prio;
+    out->sub        = (uint8_t)sub;
+    out->plan_prio  = irq_plan[index].prio;
+    out->plan_sub   = irq_plan[index].sub;
+    out->group      = (uint8_t)HAL_NVIC_GetPriorityGrouping();
+    out->plan_group = (uint8_t)XHC_IRQ_PRIO_GROUP;
+    return 1;
+}
+
+/**
+ * @brief Vergleicht die NVIC-Einstellung mit dem Plan in xhc_irq.h
+ * @return 1 wenn alles passt, sonst 0 (Details per printf; der Host sieht
+ *         dieselbe Abweichung auf der Diagnose-Seite IRQ)
+ */
+uint8_t xhc_irq_check(void)
+{
+    xhc_irq_state_t st;
+    uint8_t ok = 1;
+
+    for (uint8_t i = 0; xhc_irq_state(i, &st); i++) {
+        if (i == 0 && st.group != st.plan_group) {
+            printf("IRQ: Prioritätsgruppe %u statt %u\r\n", st.group, st.plan_group);
+            ok = 0;
+        }
+        if (st.prio != st.plan_prio || st.sub != st.plan_sub) {
+            printf("IRQ: %.8s %u/%u statt %u/%u\r\n", st.name,
+                   st.prio, st.sub, st.plan_prio, st.plan_sub);
+            ok = 0;
+        }
+    }
+    return ok;
+}
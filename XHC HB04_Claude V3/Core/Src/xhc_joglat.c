@@ -0,0 +1,218 @@
+/*
+ * XHC HB04 Jog-Latenz (siehe xhc_joglat.h)
+ *
+ * enc_usb schreibt der Task-Kontext, die beiden Echo-Strecken schreibt
+ * PendSV (xhc_recv). Die Echo-Messung gibt der Task mit probe_state frei,
+ * PendSV schließt sie ab; nur der Timeout im Task muss sich den Zustand
+ * atomar zurückholen.
+ */
+
+#include "xhc_joglat.h"
+#include "xhc_predict.h"
+#include "XHC_DataStructures.h"
+#include "rotary_switch.h"
+#include "xhc_atomic.h"
+#include "main.h"
+#include <string.h>
+
+#if (XHC_JOGLAT_WINDOW & (XHC_JOGLAT_WINDOW - 1u)) != 0u
+#error "XHC_JOGLAT_WINDOW muss eine Zweierpotenz sein"
+#endif
+
+enum { PROBE_IDLE = 0, PROBE_ARMED };
+
+/* Letzte XHC_JOGLAT_WINDOW Messungen je Strecke, n = Anzahl gesamt.
+ * Ein Schreiber je Ring (enc_usb: Task, Echo-Strecken: PendSV), gelesen
+ * wird nur über lat_snapshot. */
+static struct {
+    uint32_t us[XHC_JOGLAT_WINDOW];
+    volatile uint32_t n;
+} lat_ring[JOGLAT_COUNT];
+
+/* Task: älteste noch nicht gemeldete Rastung */
+static uint32_t lat_detent_cyc;
+static uint8_t  lat_detent_pending;
+static uint32_t lat_last_wheel_ms;
+static uint32_t lat_timeouts;
+
+/* Echo-Messung: Felder zuerst, probe_state zuletzt (Task), Abschluss in PendSV */
+static volatile int32_t probe_state = PROBE_IDLE;
+static uint8_t  probe_axis;
+static uint32_t probe_detent_cyc;
+static uint32_t probe_sent_cyc;
+
+/* PendSV: letzte Host-Position X/Y/Z (WC) und letzte Bewegung */
+static int32_t  host_pos[3];
+static volatile uint32_t host_moved_ms;
+
+/* Veröffentlichte Auswertung: task_memory schreibt lat_stats[seq + 1 & 1]
+ * und zählt danach lat_stats_seq hoch. Der Telemetrie-Report im USB-IRQ
+ * liest lat_stats[seq & 1] - den schreibt die Task erst im übernächsten
+ * Update, und die Task kann den IRQ nicht unterbrechen. */
+static xhc_joglat_stats_t lat_stats[2];
+static volatile uint32_t  lat_stats_seq;
+
+static inline uint32_t lat_cyc_per_us(void) { return SystemCoreClock / 1000000u; }
+
+static void lat_record(xhc_joglat_path_t p, uint32_t cycles)
+{
+    uint32_t n = lat_ring[p].n;
+    lat_ring[p].us[n & (XHC_JOGLAT_WINDOW - 1u)] = cycles / lat_cyc_per_us();
+    __asm volatile ("" ::: "memory");   // Eintrag vor n, siehe lat_snapshot
+    lat_ring[p].n = n + 1u;
+}
+
+static uint8_t lat_axis_of(uint8_t wheel_mode)
+{
+    switch (wheel_mode) {
+        case ROTARY_X: return 0;
+        case ROTARY_Y: return 1;
+        case ROTARY_Z: return 2;
+        default:       return 0xFF;
+    }
+}
+
+/**
+ * @brief Rastung im Akkumulator (task_encoder); nur die älteste offene zählt
+ */
+void xhc_joglat_detent(void)
+{
+    if (!lat_detent_pending) {
+        lat_detent_cyc = DWT->CYCCNT;
+        lat_detent_pending = 1;
+    }
+}
+
+/**
+ * @brief Offene Rastungen verworfen (Achswechsel, Flush)
+ */
+void xhc_joglat_flush(void)
+{
+    lat_detent_pending = 0;
+}
+
+/**
+ * @brief IN-Report angenommen (task_usb_report)
+ * @param wheel gesendeter Rad-Wert; 0 = Rastungen haben sich aufgehoben
+ */
+void xhc_joglat_report(uint8_t wheel_mode, int8_t wheel, uint32_t now_ms)
+{
+    if (!lat_detent_pending) return;
+    lat_detent_pending = 0;
+    if (wheel == 0) return;
+
+    uint32_t t = DWT->CYCCNT;
+    lat_record(JOGLAT_ENC_USB, t - lat_detent_cyc);
+
+    uint8_t rest = (now_ms - lat_last_wheel_ms) >= XHC_JOGLAT_REST_MS
+                && (now_ms - host_moved_ms) >= XHC_JOGLAT_REST_MS;
+    uint8_t axis = lat_axis_of(wheel_mode);
+    lat_last_wheel_ms = now_ms;
+    if (!rest || axis == 0xFF || probe_state != PROBE_IDLE) return;
+
+    probe_axis = axis;
+    probe_detent_cyc = lat_detent_cyc;
+    probe_sent_cyc = t;
+    __asm volatile ("" ::: "memory");
+    probe_state = PROBE_ARMED;
+}
+
+/**
+ * @brief Vollständiges Host-Paket empfangen (xhc_recv, PendSV)
+ * @param pkt gerade zusammengesetztes Paket (output_report folgt erst im UI-Task)
+ *
+ * Jede Bewegung der Achse nach dem Report aus der Ruhe zählt, unabhängig
+ * von der Richtung (Achsen können auf dem Host invertiert sein).
+ */
+void xhc_joglat_host(const struct whb04_out_data *pkt)
+{
+    uint32_t t = DWT->CYCCNT;
+
+    for (uint8_t i = 0; i < 3u; i++) {
+        int32_t pos = xhc_pos_to_units(pkt->pos[i].p_int, pkt->pos[i].p_frac);
+        if (pos == host_pos[i]) continue;
+        host_pos[i] = pos;
+        host_moved_ms = HAL_GetTick();
+
+        if (probe_state == PROBE_ARMED && i == probe_axis
+            && (t - probe_sent_cyc) / lat_cyc_per_us() < XHC_JOGLAT_ECHO_TIMEOUT_MS * 1000u) {
+            lat_record(JOGLAT_USB_ECHO, t - probe_sent_cyc);
+            lat_record(JOGLAT_ENC_ECHO, t - probe_detent_cyc);
+            probe_state = PROBE_IDLE;
+        }
+    }
+}
+
+/* Ring samt Zähler konsistent kopieren, ohne Interrupt-Sperre: PendSV
+ * (Echo-Strecken) unterbricht die Task und schreibt einen Eintrag immer
+ * ganz, n zuletzt. Ist n nach dem Kopieren unverändert, kam keiner dazwischen. */
+static uint32_t lat_snapshot(xhc_joglat_path_t p, uint32_t v[XHC_JOGLAT_WINDOW])
+{
+    uint32_t total;
+    do {
+        total = lat_ring[p].n;
+        __asm volatile ("" ::: "memory");
+        memcpy(v, lat_ring[p].us, sizeof(lat_ring[p].us));
+        __asm volatile ("" ::: "memory");
+    } while (lat_ring[p].n != total);
+    return total;
+}
+
+/* Perzentile nach Rang über das Fenster, liefert die Anzahl gesamt */
+static uint32_t lat_percentiles(xhc_joglat_path_t p, xhc_joglat_pct_t *out)
+{
+    uint32_t v[XHC_JOGLAT_WINDOW];
+    uint32_t total = lat_snapshot(p, v);
+    uint32_t n = (total > XHC_JOGLAT_WINDOW) ? XHC_JOGLAT_WINDOW : total;
+    if (n == 0u) {
+        memset(out, 0, sizeof(*out));
+        return 0;
+    }
+
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t x = v[i], j = i;
+        while (j > 0u && v[j - 1u] > x) { v[j] = v[j - 1u]; j--; }
+        v[j] = x;
+    }
+    out->p50 = v[(n - 1u) * 50u / 100u];
+    out->p90 = v[(n - 1u) * 90u / 100u];
+    out->p99 = v[(n - 1u) * 99u / 100u];
+    out->max = v[n - 1u];
+    return total;
+}
+
+/**
+ * @brief Echo-Timeout prüfen und Perzentile neu rechnen (task_memory, 1 s)
+ */
+void xhc_joglat_update(void)
+{
+    if (probe_state == PROBE_ARMED
+        && (DWT->CYCCNT - probe_sent_cyc) / lat_cyc_per_us() >= XHC_JOGLAT_ECHO_TIMEOUT_MS * 1000u
+        && xhc_atomic_xchg_i32(&probe_state, PROBE_IDLE) == PROBE_ARMED) {
+        lat_timeouts++;
+    }
+
+    uint32_t seq = lat_stats_seq;
+    xhc_joglat_stats_t *s = &lat_stats[(seq + 1u) & 1u];
+    uint32_t total[JOGLAT_COUNT];
+    for (uint8_t p = 0; p < JOGLAT_COUNT; p++) {
+        total[p] = lat_percentiles((xhc_joglat_path_t)p, &s->pct[p]);
+    }
+    s->reports  = total[JOGLAT_ENC_USB];
+    s->echoes   = total[JOGLAT_ENC_ECHO];
+    s->timeouts = lat_timeouts;
+
+    __asm volatile ("" ::: "memory");
+    lat_stats_seq = seq + 1u;
+}
+
+/**
+ * @brief Zuletzt veröffentlichte Auswertung (Task oder USB-IRQ)
+ *
+ * Gültig bis zum übernächsten xhc_joglat_update; der IRQ kopiert sie
+ * sofort, Tasks lesen sie nicht über ein Update hinweg.
+ */
+const xhc_joglat_stats_t *xhc_joglat_stats(void)
+{
+    return &lat_stats[lat_stats_seq & 1u];
+}
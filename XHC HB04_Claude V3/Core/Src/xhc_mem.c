@@ -0,0 +1,116 @@
+/*
+ * XHC HB04 RAM-Budget und Stack-High-Water, siehe xhc_mem.h
+ */
+
+#include "xhc_mem.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Symbole aus STM32F103C8TX_FLASH.ld */
+extern uint8_t _sdata, _edata, _sbss, _ebss, _end, _estack;
+extern uint8_t _Min_Heap_Size, _Min_Stack_Size;
+extern uint8_t _sramfunc, _eramfunc;
+extern uint8_t _snoinit, _enoinit;
+extern void *_sbrk(ptrdiff_t incr);
+
+#define MEM_RAM_BASE     0x20000000u
+#define MEM_SP_MARGIN    64u          // unterhalb des aktuellen SP nicht anfassen
+
+uint32_t xhc_mem_isr_sp[MEM_ISR_COUNT];
+
+static const char mem_isr_names[MEM_ISR_COUNT][9] = { "i_tick", "i_usb", "i_dma", "i_psv" };
+
+#if XHC_MEM_ENABLE
+static uint32_t *mem_paint_lo = NULL;    // unterstes bemaltes Wort
+static uint32_t *mem_paint_hi = NULL;    // erstes Wort oberhalb
+#endif
+static uintptr_t mem_peak_addr = 0;      // tiefste je benutzte Stack-Adresse
+static uint8_t   mem_warned = 0;
+
+static inline uintptr_t mem_heap_end(void) { return (uintptr_t)_sbrk(0); }
+
+/**
+ * @brief Freien Bereich zwischen Heap-Ende und aktuellem Stack bemalen
+ *
+ * Einmal ganz am Anfang von main() (vor HAL_Init, ohne Interrupts) aufrufen;
+ * später (Reset der Statistik) nur den Teil unterhalb des aktuellen SP.
+ */
+void xhc_mem_paint(void)
+{
+#if XHC_MEM_ENABLE
+    uintptr_t lo = (mem_heap_end() + 3u) & ~(uintptr_t)3u;
+    uintptr_t hi = ((uintptr_t)__get_MSP() - MEM_SP_MARGIN) & ~(uintptr_t)3u;
+    if (hi <= lo) return;
+
+    for (uint32_t *p = (uint32_t *)lo; p < (uint32_t *)hi; p++) *p = XHC_MEM_PAINT;
+
+    mem_paint_lo = (uint32_t *)lo;
+    mem_paint_hi = (uint32_t *)hi;
+    mem_peak_addr = hi;
+    for (uint8_t i = 0; i < MEM_ISR_COUNT; i++) xhc_mem_isr_sp[i] = (uint32_t)(uintptr_t)&_estack;
+#endif
+}
+
+/**
+ * @brief High-Water neu bestimmen (Hauptkontext, ca. 1 Zyklus je freiem Wort)
+ */
+void xhc_mem_update(void)
+{
+#if XHC_MEM_ENABLE
+    if (mem_paint_lo == NULL) return;
+
+    // Heap kann in den bemalten Bereich gewachsen sein -> erst ab Heap-Ende suchen
+    uint32_t *p = mem_paint_lo;
+    uintptr_t heap = mem_heap_end();
+    if ((uintptr_t)p < heap) p = (uint32_t *)((heap + 3u) & ~(uintptr_t)3u);
+
+    while (p < mem_paint_hi && *p == XHC_MEM_PAINT) p++;
+    if ((uintptr_t)p < mem_peak_addr) mem_peak_addr = (uintptr_t)p;
+
+    uint32_t headroom = (mem_peak_addr > heap) ? (uint32_t)(mem_peak_addr - heap) : 0u;
+    if (headroom < XHC_MEM_WARN_BYTES && !mem_warned) {
+        mem_warned = 1;
+        printf("MEM: nur noch %lu Bytes zwischen Heap und Stack\r\n", headroom);
+    }
+#endif
+}
+
+void xhc_mem_stats(xhc_mem_stat_t *s)
+{
+    uintptr_t heap = mem_heap_end();
+
+    s->ram_total  = (uint32_t)((uintptr_t)&_estack - MEM_RAM_BASE);
+    s->data       = (uint32_t)(&_edata - &_sdata);
+    s->bss        = (uint32_t)(&_ebss - &_sbss);
+    s->heap_used  = (uint32_t)(heap - (uintptr_t)&_end);
+    s->heap_min   = (uint32_t)(uintptr_t)&_Min_Heap_Size;
+    s->stack_min  = (uint32_t)(uintptr_t)&_Min_Stack_Size;
+    s->stack_peak = mem_peak_addr ? (uint32_t)((uintptr_t)&_estack - mem_peak_addr) : 0u;
+    s->headroom   = (mem_peak_addr > heap) ? (uint32_t)(mem_peak_addr - heap) : 0u;
+    s->ramfunc    = (uint32_t)(&_eramfunc - &_sramfunc);
+    s->noinit     = (uint32_t)(&_enoinit - &_snoinit);
+}
+
+/**
+ * @brief Stack-Tiefe in Bytes beim tiefsten Eintritt in die ISR (inkl. Exception-Frame)
+ */
+uint32_t xhc_mem_isr_depth(xhc_mem_isr_t id)
+{
+    if (id >= MEM_ISR_COUNT) return 0;
+    return (uint32_t)((uintptr_t)&_estack - xhc_mem_isr_sp[id]);
+}
+
+const char *xhc_mem_isr_name(xhc_mem_isr_t id)
+{
+    return (id < MEM_ISR_COUNT) ? mem_isr_names[id] : "";
+}
+
+/**
+ * @brief Statistik neu starten: Bereich unter dem aktuellen SP neu bemalen
+ */
+void xhc_mem_reset(void)
+{
+    xhc_mem_paint();
+    mem_warned = 0;
+}
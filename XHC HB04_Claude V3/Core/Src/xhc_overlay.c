@@ -0,0 +1,198 @@
+/*
+ * XHC HB04 Diagnoseseite auf dem ST7735 (siehe xhc_overlay.h)
+ */
+
+#include "xhc_overlay.h"
+#include "xhc_display_ui.h"
+#include "xhc_telemetry.h"
+#include "xhc_profiler.h"
+#include "xhc_sched.h"
+#include "st7735_dma.h"
+#include "usbd_custom_hid_if.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+#if XHC_OVERLAY_ENABLE
+
+/* Font_7x10 auf 160 x 128: 22 Spalten, Zeilenabstand 11 px */
+#define OV_COLS      22u
+#define OV_ROWS      11u
+#define OV_ROW_Y(r)  (uint16_t)(2u + (r) * 11u)
+#define OV_ROW_TASKS 7u          // ab hier zwei Tasks je Zeile
+
+static struct {
+    uint8_t  want;               // Tastenkombination hat umgeschaltet
+    uint8_t  shown;              // Seite steht auf dem Display
+    uint8_t  draw;               // Inhalt im nächsten UI-Lauf zeichnen
+    uint8_t  chord_armed;        // erst nach Loslassen wieder schalten
+    uint32_t chord_since;        // 0 = Kombination nicht gedrückt
+    uint32_t last_ms;            // Beginn des laufenden Fensters
+    uint32_t last_loops, last_sent, last_rx, last_enc, last_spi;
+} ov = { .chord_armed = 1 };
+
+/* Zuletzt gezeichneter Text je Zeile, unveränderte Zeilen kosten nichts */
+static char ov_lines[OV_ROWS][OV_COLS + 1u];
+
+/**
+ * @brief Tastenkombination auswerten (task_buttons, entprellter Zustand)
+ */
+void xhc_overlay_keys(uint8_t s1, uint8_t s2, uint32_t now)
+{
+    uint8_t chord = (s1 == XHC_OVERLAY_KEY_A && s2 == XHC_OVERLAY_KEY_B)
+                 || (s1 == XHC_OVERLAY_KEY_B && s2 == XHC_OVERLAY_KEY_A);
+
+    if (!chord) {
+        ov.chord_since = 0;
+        ov.chord_armed = 1;
+        return;
+    }
+    if (!ov.chord_armed) return;
+
+    if (ov.chord_since == 0) {
+        ov.chord_since = now ? now : 1u;
+    } else if (now - ov.chord_since >= XHC_OVERLAY_HOLD_MS) {
+        ov.want ^= 1u;
+        ov.chord_armed = 0;
+    }
+}
+
+uint8_t xhc_overlay_active(void)
+{
+    return ov.want || ov.shown;
+}
+
+/* Zeile auf feste Breite auffüllen (überschreibt den alten Text ohne
+ * FillRectangle) und nur den geänderten Abschnitt ausgeben */
+static void ov_row(uint8_t row, uint16_t color, const char *text)
+{
+    char line[OV_COLS + 1u];
+    snprintf(line, sizeof(line), "%-22s", text);
+
+    uint8_t first = 0, last = OV_COLS;
+    while (first < OV_COLS && line[first] == ov_lines[row][first]) first++;
+    if (first == OV_COLS) return;
+    while (line[last - 1u] == ov_lines[row][last - 1u]) last--;
+
+    memcpy(ov_lines[row], line, sizeof(line));
+    line[last] = '\0';
+    ST7735_WriteString((uint16_t)(first * Font_7x10.width), OV_ROW_Y(row), &line[first],
+                       Font_7x10, color, ST7735_BLACK);
+}
+
+/* Zählerstände als Fensteranfang merken */
+static void ov_window_start(uint32_t now)
+{
+    ov.last_ms    = now;
+    ov.last_loops = xhc_telem.loops;
+    ov.last_sent  = xhc_telem.usb_sent;
+    ov.last_rx    = xhc_telem.rx_packets;
+    ov.last_enc   = xhc_telem.enc_in;
+    ov.last_spi   = xhc_telem.spi_bytes;
+}
+
+static inline uint32_t ov_rate(uint32_t cur, uint32_t last, uint32_t dt)
+{
+    return (uint32_t)((uint64_t)(cur - last) * 1000u / dt);
+}
+
+/* Längste Laufzeit der Task seit dem letzten Profiler-Reset in us */
+static uint32_t ov_task_max_us(uint8_t index)
+{
+    xhc_prof_stat_t st;
+    const xhc_task_t *t = xhc_sched_task(index);
+    if (t == NULL || !xhc_prof_snapshot(t->prof_id, &st)) return 0;
+    return st.max / (SystemCoreClock / 1000000u);
+}
+
+static void ov_draw(uint32_t now)
+{
+    char text[48];   // Platz für volle 32-Bit-Zahlen, ov_row kürzt auf OV_COLS
+    uint32_t dt = now - ov.last_ms;
+    if (dt == 0u) dt = 1u;
+
+    uint32_t loops = xhc_telem.loops, sent = xhc_telem.usb_sent;
+    uint32_t rx = xhc_telem.rx_packets, enc = xhc_telem.enc_in;
+    uint32_t spi = xhc_telem.spi_bytes;
+
+    /* Display-SPI: PCLK2 = HCLK, Teiler 2^(BR+1), 8 Bit je Byte */
+    uint32_t spi_div  = 2u << (ST7735_SPI_PORT.Init.BaudRatePrescaler >> 3);
+    uint32_t spi_max  = SystemCoreClock / spi_div / 8u;
+    uint32_t spi_rate = ov_rate(spi, ov.last_spi, dt);
+
+    snprintf(text, sizeof(text), "DIAG        %6lus", (unsigned long)(now / 1000u));
+    ov_row(0, ST7735_YELLOW, text);
+    snprintf(text, sizeof(text), "Loop  %7lu/s",
+             (unsigned long)ov_rate(loops, ov.last_loops, dt));
+    ov_row(1, ST7735_WHITE, text);
+    snprintf(text, sizeof(text), "USB   %4lu/s bsy %5lu",
+             (unsigned long)ov_rate(sent, ov.last_sent, dt), (unsigned long)xhc_telem.usb_busy);
+    ov_row(2, ST7735_WHITE, text);
+    snprintf(text, sizeof(text), "Host  %4lu/s drp %5lu",
+             (unsigned long)ov_rate(rx, ov.last_rx, dt),
+             (unsigned long)(xhc_telem.rx_dropped + XHC_RX_Dropped()));
+    ov_row(3, ST7735_WHITE, text);
+    snprintf(text, sizeof(text), "Enc   %4lu/s",
+             (unsigned long)ov_rate(enc, ov.last_enc, dt));
+    ov_row(4, ST7735_WHITE, text);
+    snprintf(text, sizeof(text), "SPI   %3lu%% %5lu B/s",
+             (unsigned long)(spi_rate * 100u / spi_max), (unsigned long)spi_rate);
+    ov_row(5, ST7735_WHITE, text);
+    ov_row(6, ST7735_CYAN, "Task max us");
+
+    uint8_t n = xhc_sched_task_count();
+    for (uint8_t r = OV_ROW_TASKS; r < OV_ROWS; r++) {
+        uint8_t i = (uint8_t)((r - OV_ROW_TASKS) * 2u);
+        if (i >= n) {
+            text[0] = '\0';
+        } else if (i + 1u >= n) {
+            snprintf(text, sizeof(text), "%-3.3s%6lu",
+                     xhc_sched_task(i)->name, (unsigned long)ov_task_max_us(i));
+        } else {
+            snprintf(text, sizeof(text), "%-3.3s%6lu  %-3.3s%6lu",
+                     xhc_sched_task(i)->name, (unsigned long)ov_task_max_us(i),
+                     xhc_sched_task(i + 1u)->name, (unsigned long)ov_task_max_us(i + 1u));
+        }
+        ov_row(r, ST7735_WHITE, text);
+    }
+
+    ov_window_start(now);
+}
+
+/**
+ * @brief Seite ein-/ausblenden und im Raster neu zeichnen (UI-Task)
+ *
+ * Umschalten kostet je ein Vollbild; der Inhalt folgt erst im nächsten
+ * UI-Lauf, damit kein einzelner Lauf zwei Vollbilder lang dauert.
+ */
+void xhc_overlay_service(uint32_t now)
+{
+    if (ov.want && !ov.shown) {
+        ST7735_FillScreen(ST7735_BLACK);
+        for (uint8_t r = 0; r < OV_ROWS; r++) {      // schwarz = Leerzeile
+            memset(ov_lines[r], ' ', OV_COLS);
+            ov_lines[r][OV_COLS] = '\0';
+        }
+        ov_window_start(now);
+        ov.shown = 1;
+        ov.draw = 1;
+        return;
+    }
+    if (!ov.want && ov.shown) {
+        ov.shown = 0;
+        xhc_ui_redraw();
+        return;
+    }
+    if (ov.shown && (ov.draw || (now - ov.last_ms) >= XHC_OVERLAY_PERIOD_MS)) {
+        ov.draw = 0;
+        ov_draw(now);   // erster Aufruf: Raten erst ab dem nächsten Fenster
+    }
+}
+
+#else
+
+void    xhc_overlay_keys(uint8_t s1, uint8_t s2, uint32_t now) { (void)s1; (void)s2; (void)now; }
+void    xhc_overlay_service(uint32_t now) { (void)now; }
+uint8_t xhc_overlay_active(void) { return 0; }
+
+#endif /* XHC_OVERLAY_ENABLE */
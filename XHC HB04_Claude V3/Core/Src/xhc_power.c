@@ -0,0 +1,83 @@
+/*
+ * XHC HB04 Idle-Power-Management
+ *
+ * Nur aus dem Hauptkontext (Scheduler-Tasks) aufrufen. xhc_power_activity
+ * kann auch aus einer in eine Display-Ausgabe eingeschobenen Task kommen
+ * (xhc_sched_yield), deshalb schickt erst xhc_power_update das
+ * ST7735-Kommando für den Panel-Idle-Mode - nie mitten in einen Transfer.
+ */
+
+#include "xhc_power.h"
+#include "st7735_dma.h"
+#include "main.h"
+
+static xhc_power_level_t pwr_level = XHC_PWR_ACTIVE;
+static uint32_t          pwr_last_activity = 0;
+static xhc_power_hook_t  pwr_hook = NULL;
+static uint8_t           pwr_panel_idle = 0;    // Zustand des Panels (ST7735_SetIdleMode)
+
+/*
+ * F1: AHBENR.FLITFEN/SRAMEN schalten nur den Takt im Sleep-Mode.
+ * Im Idle läuft während WFI kein DMA (alle Display-Transfers warten im
+ * Task auf ihr Ende), also können beide Takte im Sleep aus sein.
+ */
+static void pwr_sleep_clocks(uint8_t gated)
+{
+    if (gated) {
+        __HAL_RCC_FLITF_CLK_DISABLE();
+        __HAL_RCC_SRAM_CLK_DISABLE();
+    } else {
+        __HAL_RCC_FLITF_CLK_ENABLE();
+        __HAL_RCC_SRAM_CLK_ENABLE();
+    }
+}
+
+static void pwr_set(xhc_power_level_t level)
+{
+    if (level == pwr_level) return;
+
+    pwr_sleep_clocks(level != XHC_PWR_ACTIVE);
+
+    pwr_level = level;
+    if (pwr_hook) pwr_hook(level);
+}
+
+void xhc_power_init(xhc_power_hook_t on_change)
+{
+    pwr_hook = on_change;
+    pwr_last_activity = HAL_GetTick();
+    pwr_level = XHC_PWR_ACTIVE;
+}
+
+/**
+ * @brief Meldet Benutzer- oder Host-Aktivität, weckt sofort auf ACTIVE
+ */
+void xhc_power_activity(void)
+{
+    pwr_last_activity = HAL_GetTick();
+    if (pwr_level != XHC_PWR_ACTIVE) pwr_set(XHC_PWR_ACTIVE);
+}
+
+/**
+ * @brief Zyklisch aufrufen; stuft nach Ablauf der Idle-Zeiten herunter
+ */
+xhc_power_level_t xhc_power_update(uint32_t now)
+{
+    uint32_t idle = now - pwr_last_activity;
+
+    if (idle >= XHC_PWR_DEEP_IDLE_MS)  pwr_set(XHC_PWR_DEEP_IDLE);
+    else if (idle >= XHC_PWR_IDLE_MS)  pwr_set(XHC_PWR_IDLE);
+
+    uint8_t deep = (pwr_level == XHC_PWR_DEEP_IDLE);
+    if (deep != pwr_panel_idle && ST7735_IsReady()) {
+        ST7735_SetIdleMode(deep);
+        pwr_panel_idle = deep;
+    }
+
+    return pwr_level;
+}
+
+xhc_power_level_t xhc_power_level(void)
+{
+    return pwr_level;
+}
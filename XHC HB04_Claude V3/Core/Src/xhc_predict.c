@@ -0,0 +1,141 @@
+/*
+ * XHC HB04 Vorhersage-DRO (Dead Reckoning), siehe xhc_predict.h
+ */
+
+#include "xhc_predict.h"
+#include "XHC_DataStructures.h"
+#include "rotary_switch.h"
+
+/* Schrittweite je step_mul-Low-Nibble in 1/10000 (gleiche Stufen wie die Statusleiste) */
+static const uint16_t predict_step_units[16] = {
+    10,                                 // 0x00: wie 0.001
+    10, 50, 100, 200, 300, 400, 500,    // 0x01..0x07: 0.001 .. 0.050
+    1000, 5000, 10000,                  // 0x08..0x0A: 0.100, 0.500, 1.000
+    10, 10, 10, 10, 10                  // unbekannt: kleinste Stufe
+};
+
+static uint8_t  predict_axis = XHC_PREDICT_NONE;   // 0..2 (WC), MC = axis + 3
+static int32_t  predict_offset = 0;                // noch nicht vom Host gemeldet
+static int32_t  predict_host_last = 0;             // letzte Host-Position der Achse (WC)
+static uint32_t predict_last_wheel = 0;
+static uint8_t  predict_dirty = 0;                 // Anzeige neu zeichnen
+
+int32_t xhc_pos_to_units(uint16_t p_int, uint16_t p_frac)
+{
+    int32_t v = (int32_t)p_int * 10000 + (int32_t)(p_frac & 0x7FFFu);
+    return (p_frac & 0x8000u) ? -v : v;
+}
+
+void xhc_units_to_pos(int32_t units, uint16_t *p_int, uint16_t *p_frac)
+{
+    uint32_t a = (units < 0) ? (uint32_t)(-units) : (uint32_t)units;
+    *p_int  = (uint16_t)(a / 10000u);
+    *p_frac = (uint16_t)((a % 10000u) | ((units < 0) ? 0x8000u : 0u));
+}
+
+static uint8_t predict_axis_of(uint8_t wheel_mode)
+{
+    switch (wheel_mode) {
+        case ROTARY_X: return 0;
+        case ROTARY_Y: return 1;
+        case ROTARY_Z: return 2;
+        default:       return XHC_PREDICT_NONE;   // Feed/Spindel/A: keine DRO-Zeile
+    }
+}
+
+/**
+ * @brief Verwirft die Vorhersage (Achswechsel, Rad-Flush)
+ */
+void xhc_predict_reset(void)
+{
+    if (predict_offset != 0) predict_dirty = 1;
+    predict_offset = 0;
+    predict_axis = XHC_PREDICT_NONE;
+}
+
+/**
+ * @brief Meldet einen erfolgreich gesendeten Rad-Wert
+ */
+void xhc_predict_on_wheel(uint8_t wheel_mode, int8_t wheel, uint8_t step_mul, uint32_t now)
+{
+#if XHC_DRO_PREDICT
+    uint8_t axis = predict_axis_of(wheel_mode);
+    if (axis == XHC_PREDICT_NONE || wheel == 0) return;
+
+    if (axis != predict_axis) {
+        predict_offset = 0;
+        predict_axis = axis;
+        predict_host_last = xhc_pos_to_units(output_report.pos[axis].p_int,
+                                             output_report.pos[axis].p_frac);
+    }
+    predict_offset += (int32_t)wheel * (int32_t)predict_step_units[step_mul & 0x0Fu];
+    predict_last_wheel = now;
+    predict_dirty = 1;
+#else
+    (void)wheel_mode; (void)wheel; (void)step_mul; (void)now;
+#endif
+}
+
+/**
+ * @brief Neues Host-Paket: gemeldete Bewegung vom vorausgesagten Anteil abziehen
+ */
+void xhc_predict_on_host(void)
+{
+    if (predict_axis == XHC_PREDICT_NONE) return;
+
+    int32_t host = xhc_pos_to_units(output_report.pos[predict_axis].p_int,
+                                    output_report.pos[predict_axis].p_frac);
+    int32_t moved = host - predict_host_last;
+    predict_host_last = host;
+    if (moved == 0 || predict_offset == 0) return;
+
+    // Gegen die Vorhersage (Achse am Host invertiert, anderer Auftraggeber):
+    // die Vorhersage taugt nicht, sonst liefe der Versatz bis zum Timeout weg
+    if ((moved > 0) != (predict_offset > 0)) {
+        predict_offset = 0;
+        predict_dirty = 1;
+        return;
+    }
+
+    int32_t rest = predict_offset - moved;
+    // Host ist weiter gefahren als vorausgesagt -> nichts mehr offen
+    if ((predict_offset > 0 && rest < 0) || (predict_offset < 0 && rest > 0)) rest = 0;
+    predict_offset = rest;
+    predict_dirty = 1;
+}
+
+/**
+ * @brief Timeout prüfen
+ * @return 1 wenn sich die angezeigte Position geändert hat (Koordinaten neu zeichnen)
+ */
+uint8_t xhc_predict_service(uint32_t now)
+{
+    if (predict_offset != 0 && (now - predict_last_wheel) >= XHC_PREDICT_TIMEOUT_MS) {
+        predict_offset = 0;     // Host hat nicht (vollständig) nachgezogen
+        predict_dirty = 1;
+    }
+    uint8_t d = predict_dirty;
+    predict_dirty = 0;
+    return d;
+}
+
+/**
+ * @brief Offenen Anteil auf die Anzeige-Kopie der Positionen anwenden (WC und MC)
+ */
+void xhc_predict_apply(uint16_t p_int[6], uint16_t p_frac[6])
+{
+    if (predict_axis == XHC_PREDICT_NONE || predict_offset == 0) return;
+
+    for (uint8_t i = predict_axis; i < 6; i += 3) {
+        int32_t v = xhc_pos_to_units(p_int[i], p_frac[i]) + predict_offset;
+        xhc_units_to_pos(v, &p_int[i], &p_frac[i]);
+    }
+}
+
+/**
+ * @brief Achse mit offenem Vorhersage-Anteil (0..2) oder XHC_PREDICT_NONE
+ */
+uint8_t xhc_predict_axis(void)
+{
+    return (predict_offset != 0) ? predict_axis : XHC_PREDICT_NONE;
+}
@@ -0,0 +1,125 @@
+/*
+ * XHC HB04 Zyklen-Profiler (DWT CYCCNT)
+ */
+
+#include "xhc_profiler.h"
+#include "xhc_atomic.h"
+#include <string.h>
+
+/* Kurznamen für den Host (max. 8 Zeichen, gleiche Reihenfolge wie xhc_prof_id_t) */
+static const char prof_names[PROF_COUNT][9] = {
+    "m_enc",  "m_btn",  "m_rot",  "m_usb",  "m_ui",   "m_pwr",  "m_mem",  "m_wfi",
+    "i_tick", "i_usb",  "i_dma",  "i_psv",  "l_tick", "l_psv",
+    "st_fill", "st_str", "st_img", "st_bar", "fb_flsh",
+    "ui_crd", "ui_stat"
+};
+
+/*
+ * Ohne Interrupt-Sperre: jede ID hat genau einen Schreiber (eine ISR oder
+ * den Hauptkontext, eingeschobene Tasks laufen nacheinander, nie
+ * verschränkt). Der Schreiber baut die neue Statistik in der freien Hälfte
+ * auf und veröffentlicht sie mit prof_seq[id]++. Leser (Diagnose im
+ * USB-IRQ, Overlay, Sim) kopieren die veröffentlichte Hälfte und
+ * wiederholen, falls prof_seq sich dabei geändert hat. Ein Leser in einer
+ * höheren ISR als der Schreiber kommt so immer im ersten Anlauf durch.
+ *
+ * Reset zählt nur prof_gen hoch; Hälften einer älteren Generation gelten
+ * als leer, der nächste Schreiber fängt bei 0 an.
+ */
+typedef struct {
+    xhc_prof_stat_t st;
+    uint32_t        gen;
+} prof_slot_t;
+
+static prof_slot_t       prof_slots[PROF_COUNT][2];
+static volatile uint32_t prof_seq[PROF_COUNT];
+static volatile uint32_t prof_gen = 1u;         // Hälften mit gen 0 sind leer
+
+static void prof_clear(xhc_prof_stat_t *st)
+{
+    memset(st, 0, sizeof(*st));
+    st->min = 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Schaltet den DWT-Zyklenzähler ein und leert die Statistik
+ */
+void xhc_prof_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+    xhc_prof_reset();
+}
+
+void xhc_prof_reset(void)
+{
+    xhc_atomic_fetch_inc_u32(&prof_gen);
+}
+
+static inline uint8_t prof_bin(uint32_t cycles)
+{
+    if (cycles < (1u << (XHC_PROF_HIST_SHIFT + 1u))) return 0;
+    uint32_t bin = 31u - __CLZ(cycles) - XHC_PROF_HIST_SHIFT;
+    return (bin >= XHC_PROF_HIST_BINS) ? (XHC_PROF_HIST_BINS - 1u) : (uint8_t)bin;
+}
+
+/**
+ * @brief Verbucht eine gemessene Dauer
+ *
+ * Schreiber sind die Tasks (m_*, st_*, ui_*) und die ISRs mit eigenen IDs:
+ * SysTick, USB-IRQ, SPI-DMA-IRQ und PendSV (Empfang, i_psv/l_psv).
+ * Kostet eine Kopie der Statistik (~60 Byte), sperrt aber nie Interrupts.
+ */
+void xhc_prof_record(xhc_prof_id_t id, uint32_t cycles)
+{
+    if ((unsigned)id >= PROF_COUNT) return;
+    uint32_t seq = prof_seq[id];
+    const prof_slot_t *cur = &prof_slots[id][seq & 1u];
+    prof_slot_t *next = &prof_slots[id][(seq + 1u) & 1u];
+    uint32_t gen = prof_gen;
+
+    if (cur->gen == gen) {
+        next->st = cur->st;
+    } else {
+        prof_clear(&next->st);
+    }
+    next->gen = gen;
+
+    xhc_prof_stat_t *s = &next->st;
+    uint8_t bin = prof_bin(cycles);
+    s->count++;
+    s->sum += cycles;
+    if (cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+    if (s->hist[bin] != 0xFFFFu) s->hist[bin]++;
+
+    __asm volatile ("" ::: "memory");   // erst die Hälfte, dann veröffentlichen
+    prof_seq[id] = seq + 1u;
+}
+
+/**
+ * @brief Konsistente Kopie eines Messpunkts
+ * @return 0 bei ungültiger ID
+ */
+uint8_t xhc_prof_snapshot(uint8_t id, xhc_prof_stat_t *out)
+{
+    if (id >= PROF_COUNT || out == NULL) return 0;
+    uint32_t seq, gen;
+    do {
+        seq = prof_seq[id];
+        __asm volatile ("" ::: "memory");
+        *out = prof_slots[id][seq & 1u].st;
+        gen = prof_slots[id][seq & 1u].gen;
+        __asm volatile ("" ::: "memory");
+    } while (prof_seq[id] != seq);
+
+    if (gen != prof_gen) prof_clear(out);
+    if (out->count == 0) out->min = 0;
+    return 1;
+}
+
+const char *xhc_prof_name(uint8_t id)
+{
+    return (id < PROF_COUNT) ? prof_names[id] : "";
+}
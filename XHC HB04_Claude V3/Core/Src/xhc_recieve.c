@@ -9,13 +9,21 @@
 #include <stdio.h>
 #include "xhc_display_ui.h"
 #include "rotary_switch.h"
+#include "xhc_power.h"
+#include "xhc_predict.h"
+#include "xhc_irq.h"
+#include "xhc_telemetry.h"
+#include "xhc_joglat.h"
 
 /* Konstanten für den Empfang */
 #define TMP_BUFF_SIZE   42
 #define CHUNK_SIZE      7
 #define HW_TYPE         DEV_WHB04  // Nur WHB04 (37 Bytes)
+#define RX_QUEUE_LEN    8          // Chunks zwischen USB-IRQ und PendSV (2er-Potenz)
 
-/* Globale Variablen */
+/* Globale Variablen
+ * output_report ist die Kopie des Hauptkontexts: nur xhc_rx_take_update
+ * (UI-Task) schreibt sie, alle Tasks lesen sie ohne Sperre. */
 struct whb04_out_data output_report = { 0 };
 struct whb0x_in_data in_report = { .id = 0x04 };
 uint8_t day = 0;  // XOR-Schlüssel
@@ -25,6 +33,18 @@ static int offset = 0;
 static uint8_t magic_found = 0;
 static uint8_t tmp_buff[TMP_BUFF_SIZE];
 
+/* Doppelpuffer PendSV -> UI-Task: Paket n liegt in rx_buf[n & 1], rx_seq = n
+ * wird erst nach dem Schreiben veröffentlicht. Der Leser kopiert und prüft
+ * danach rx_seq; hat PendSV inzwischen veröffentlicht, liest er neu. */
+static struct whb04_out_data rx_buf[2];
+static volatile uint32_t rx_seq = 0;
+static uint32_t rx_seq_taken = 0;                 // zuletzt übernommenes Paket (UI-Task)
+
+/* Einzel-Erzeuger (USB-IRQ) / Einzel-Verbraucher (PendSV), freilaufende Indizes */
+static uint8_t rx_queue[RX_QUEUE_LEN][CHUNK_SIZE];
+static volatile uint8_t rx_queue_head = 0;
+static volatile uint8_t rx_queue_tail = 0;
+
 /**
  * @brief Empfängt Daten vom Host über HID SET_REPORT
  * @param data Zeiger auf die empfangenen 7-Byte-Chunks
@@ -34,8 +54,9 @@ static uint8_t tmp_buff[TMP_BUFF_SIZE];
  */
 void xhc_recv(uint8_t *data)
 {
-    /* Prüfe auf Magic-Wert am Anfang eines neuen Pakets */
-    if (*(uint16_t*)data == WHBxx_MAGIC)
+    /* Prüfe auf Magic-Wert am Anfang eines neuen Pakets (byteweise: die
+     * Chunks liegen in rx_queue auf 7-Byte-Raster, also oft ungerade) */
+    if (data[0] == (uint8_t)(WHBxx_MAGIC & 0xFF) && data[1] == (uint8_t)(WHBxx_MAGIC >> 8))
     {
         offset = 0;
         magic_found = 1;
@@ -60,21 +81,87 @@ void xhc_recv(uint8_t *data)
     /* Alle Daten empfangen - verarbeite das Paket */
     magic_found = 0;
 
-    /* Kopiere die empfangenen Daten in die output_report Struktur */
-    output_report = *((struct whb04_out_data*)tmp_buff);
+    /* In den gerade nicht veröffentlichten Puffer kopieren */
+    uint32_t seq = rx_seq;
+    const struct whb04_out_data *prev = &rx_buf[seq & 1u];
+    struct whb04_out_data *next = &rx_buf[(seq + 1u) & 1u];
+
+    XHC_TELEM_INC(rx_packets);
+    if (memcmp(prev, tmp_buff, sizeof(*prev)) == 0) {
+        XHC_TELEM_INC(rx_duplicates);
+    }
+    memcpy(next, tmp_buff, sizeof(*next));
 
     /* Aktualisiere den XOR-Schlüssel */
-    day = output_report.day;
+    day = next->day;
+
+    /* Jog-Latenz: bewegt sich die Achse nach dem Rad-Report? */
+    xhc_joglat_host(next);
+
+    /* Veröffentlichen (Zeichnen im UI-Task, nicht im USB-IRQ) */
+    __asm volatile ("" ::: "memory");
+    rx_seq = seq + 1u;
+}
+
+/**
+ * @brief Nimmt einen Chunk im USB-IRQ entgegen
+ * @param data 7-Byte-Chunk (nach der Report-ID)
+ *
+ * Nur kopieren; der Zusammenbau (xhc_recv) läuft in PendSV, damit der
+ * USB-IRQ kurz bleibt.
+ */
+void xhc_recv_isr(const uint8_t *data)
+{
+    uint8_t head = rx_queue_head;
+    if ((uint8_t)(head - rx_queue_tail) >= RX_QUEUE_LEN) {
+        XHC_TELEM_INC(rx_dropped);
+        return;
+    }
+    memcpy(rx_queue[head & (RX_QUEUE_LEN - 1u)], data, CHUNK_SIZE);
+    rx_queue_head = (uint8_t)(head + 1u);
+    xhc_irq_defer(XHC_DEFER_RX);
+}
+
+/**
+ * @brief Gepufferte Chunks in der Reihenfolge des Eingangs verarbeiten (PendSV)
+ */
+void xhc_recv_deferred(void)
+{
+    while (rx_queue_tail != rx_queue_head) {
+        xhc_recv(rx_queue[rx_queue_tail & (RX_QUEUE_LEN - 1u)]);
+        rx_queue_tail = (uint8_t)(rx_queue_tail + 1u);
+    }
+}
 
-    /* Signalisiere dass neue Daten verfügbar sind */
-    xhc_process_received_data();
+/**
+ * @brief Übernimmt das neueste Paket nach output_report (nur UI-Task)
+ * @return 1 wenn seit dem letzten Aufruf ein vollständiges Paket kam
+ *
+ * PendSV schreibt immer in den anderen Puffer; erst ein zweites Paket
+ * während des Kopierens trifft den gelesenen, dann ändert sich rx_seq
+ * und die Kopie wird wiederholt.
+ */
+uint8_t xhc_rx_take_update(void)
+{
+    uint32_t seq = rx_seq;
+    if (seq == rx_seq_taken) return 0;
+
+    do {
+        seq = rx_seq;
+        __asm volatile ("" ::: "memory");
+        output_report = rx_buf[seq & 1u];
+        __asm volatile ("" ::: "memory");
+    } while (seq != rx_seq);
+
+    rx_seq_taken = seq;
+    return 1;
 }
 
 /**
  * @brief Verarbeitet die empfangenen Daten
  *
- * Diese Funktion wird aufgerufen wenn ein vollständiges Datenpaket
- * empfangen wurde. Hier können die Daten weiterverarbeitet werden
+ * Wird vom UI-Task aufgerufen, nachdem ein vollständiges Datenpaket
+ * empfangen wurde (xhc_rx_take_update). Hier können die Daten weiterverarbeitet werden
  * (z.B. LCD-Update, LED-Steuerung, etc.)
  */
 void xhc_process_received_data(void)
@@ -87,12 +174,14 @@ void xhc_process_received_data(void)
 
     // Timing
     static uint32_t last_coord_ts  = 0;
-    static uint32_t last_status_ts = 0;
     static uint8_t  settling_mode  = 1;   // anfänglich empfindlicher
     static uint16_t updates_since_settle = 0;
 
     uint32_t now = HAL_GetTick();
 
+    // Gemeldete Bewegung gegen die lokale Vorhersage verrechnen
+    xhc_predict_on_host();
+
     // === 1) Positionsänderungen erkennen ===
     uint8_t pos_changed = 0;
     for (int i = 0; i < 6; i++) {
@@ -129,6 +218,11 @@ void xhc_process_received_data(void)
         (rotary   != last_rotary)   ||
         (state    != last_state);
 
+    // Host bewegt die Maschine oder ändert den Status -> kein Idle
+    if (pos_changed || status_changed) {
+        xhc_power_activity();
+    }
+
     // === 3) Zeichnen (gezielt & mit Fallback) ===
     if (pos_changed || (now - last_coord_ts >= 100)) {
         xhc_ui_update_coordinates();
@@ -137,7 +231,6 @@ void xhc_process_received_data(void)
 
     if (status_changed) {
         xhc_ui_update_status_bar(rotary, step);
-        last_status_ts = now;
 
         // Caches erst NACH erfolgreichem Draw updaten
         last_feed      = feed;
@@ -0,0 +1,153 @@
+/*
+ * XHC HB04 kooperativer Scheduler
+ */
+
+#include "xhc_sched.h"
+#include "xhc_profiler.h"
+#include "main.h"
+
+static xhc_task_t *sched_tasks = NULL;
+static uint8_t     sched_count = 0;
+static uint8_t     sched_yield_count = 0;           // Tasks 0..n-1 dürfen eingeschoben werden
+static uint8_t     sched_running = SCHED_NONE;      // Index der laufenden Task
+
+static inline uint8_t is_due(uint32_t now, uint32_t at)
+{
+    return (int32_t)(now - at) >= 0;   // überlaufsicher
+}
+
+/**
+ * @brief Übernimmt die Task-Tabelle, alle Tasks sind sofort fällig
+ */
+void xhc_sched_init(xhc_task_t *tasks, uint8_t count)
+{
+    uint32_t now = HAL_GetTick();
+    sched_tasks = tasks;
+    sched_count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        tasks[i].next_ms = now;
+    }
+    xhc_sched_reset_stats();
+
+#ifdef DEBUG
+    HAL_DBGMCU_EnableDBGSleepMode();   // SWD bleibt während WFI verbunden
+#endif
+}
+
+void xhc_sched_reset_stats(void)
+{
+    for (uint8_t i = 0; i < sched_count; i++) {
+        sched_tasks[i].runs = 0;
+        sched_tasks[i].misses = 0;
+        sched_tasks[i].max_late_ms = 0;
+    }
+}
+
+static void sched_dispatch(uint8_t index, uint32_t now)
+{
+    xhc_task_t *t = &sched_tasks[index];
+    uint32_t late = now - t->next_ms;
+    if (late > t->max_late_ms) t->max_late_ms = (late > 0xFFFFu) ? 0xFFFFu : (uint16_t)late;
+    if (late > t->deadline_ms) t->misses++;
+    t->runs++;
+
+    // Raster halten; wer mehr als eine Periode hinterher ist, springt auf jetzt
+    t->next_ms += t->period_ms;
+    if (is_due(now, t->next_ms)) t->next_ms = now + t->period_ms;
+
+    uint8_t outer = sched_running;   // != SCHED_NONE: eingeschoben aus xhc_sched_yield
+    sched_running = index;
+#if XHC_PROF_ENABLE
+    uint32_t t0 = xhc_prof_now();
+    t->run(now);
+    xhc_prof_record((xhc_prof_id_t)t->prof_id, xhc_prof_now() - t0);
+#else
+    t->run(now);
+#endif
+    sched_running = outer;
+}
+
+/**
+ * @brief Ein Scheduler-Durchlauf: höchstpriore fällige Task ausführen oder schlafen
+ */
+void xhc_sched_run_once(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    for (uint8_t i = 0; i < sched_count; i++) {
+        if (is_due(now, sched_tasks[i].next_ms)) {
+            sched_dispatch(i, now);
+            return;
+        }
+    }
+
+    // Nichts fällig -> bis zum nächsten Interrupt schlafen. Prüfung und WFI
+    // unter PRIMASK: ein Tick genau dazwischen bleibt pending und weckt sofort.
+    // Der weckende IRQ läuft erst nach __enable_irq, m_wfi ist reine
+    // Schlafzeit; verbucht wird erst danach, die Sperre bleibt kurz.
+    uint32_t slept = 0;
+    __disable_irq();
+    if (HAL_GetTick() == now) {
+        uint32_t t0 = xhc_prof_now();
+        __WFI();
+        slept = xhc_prof_now() - t0;
+    }
+    __enable_irq();
+#if XHC_PROF_ENABLE
+    if (slept) xhc_prof_record(PROF_MAIN_SLEEP, slept);
+#else
+    (void)slept;
+#endif
+}
+
+/**
+ * @brief Fällige Tasks 0..yield_count-1 aus einer Warteschleife heraus bedienen
+ *
+ * Für Wartestellen in langen Tasks (Display-DMA, ST7735_SetYieldHook).
+ * Läuft die aufrufende Task selbst schon in diesem Bereich oder gar keine
+ * Task, passiert nichts - eingeschobene Tasks werden nie verschachtelt.
+ */
+void xhc_sched_yield(void)
+{
+    if (sched_running == SCHED_NONE || sched_running < sched_yield_count) return;
+
+    uint32_t now = HAL_GetTick();
+    for (uint8_t i = 0; i < sched_yield_count; i++) {
+        if (is_due(now, sched_tasks[i].next_ms)) {
+            sched_dispatch(i, now);
+            return;
+        }
+    }
+}
+
+void xhc_sched_set_yield_count(uint8_t count)
+{
+    sched_yield_count = (count <= sched_count) ? count : sched_count;
+}
+
+/**
+ * @brief Periode einer Task zur Laufzeit ändern
+ *
+ * Wird die Periode kürzer, ist die Task sofort wieder im neuen Raster
+ * (sonst wartet sie noch den Rest der alten, langen Periode ab).
+ */
+void xhc_sched_set_period(uint8_t index, uint16_t period_ms)
+{
+    if (index >= sched_count || period_ms == 0) return;
+    xhc_task_t *t = &sched_tasks[index];
+    uint32_t now = HAL_GetTick();
+    if (period_ms < t->period_ms && (int32_t)(t->next_ms - now) > (int32_t)period_ms) {
+        t->next_ms = now;
+    }
+    t->period_ms = period_ms;
+}
+
+uint8_t xhc_sched_task_count(void)
+{
+    return sched_count;
+}
+
+const xhc_task_t *xhc_sched_task(uint8_t index)
+{
+    return (index < sched_count) ? &sched_tasks[index] : NULL;
+}
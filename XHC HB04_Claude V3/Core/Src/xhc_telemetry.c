@@ -0,0 +1,114 @@
+/*
+ * XHC HB04 Telemetrie-Feature-Report (Report ID 0x11)
+ *
+ * GET_REPORT läuft im USB-IRQ: nur Zähler und die zuletzt berechneten
+ * Raten kopieren. Alles, was Zeit kostet (Stack-Suche, Divisionen über
+ * das Fenster), macht xhc_telem_update im Task.
+ */
+
+#include "xhc_telemetry.h"
+#include "xhc_mem.h"
+#include "xhc_trace.h"
+#include "xhc_joglat.h"
+#include "st7735_fb.h"
+#include "main.h"
+#include <string.h>
+
+volatile xhc_telem_t xhc_telem;
+
+/* Ergebnis des letzten 1-s-Fensters */
+static struct {
+    uint32_t last_ms;
+    uint32_t last_loops;
+    uint32_t last_spi;
+    uint32_t loop_rate;         // Durchläufe/s
+    uint32_t spi_rate;          // Bytes/s
+    uint32_t stack_peak;
+    uint32_t headroom;
+} telem_win;
+
+static uint8_t telem_buf[XHC_TELEM_REPORT_LEN];
+
+static inline void put_u32(uint8_t *p, uint32_t v) { memcpy(p, &v, 4); }
+
+/**
+ * @brief Raten und Stack-Werte nachführen (task_memory, 1 s)
+ */
+void xhc_telem_update(uint32_t now_ms)
+{
+    uint32_t dt = now_ms - telem_win.last_ms;
+    uint32_t loops = xhc_telem.loops;
+    uint32_t spi = xhc_telem.spi_bytes;
+
+    if (dt != 0u && telem_win.last_ms != 0u) {
+        telem_win.loop_rate = (uint32_t)((uint64_t)(loops - telem_win.last_loops) * 1000u / dt);
+        telem_win.spi_rate  = (uint32_t)((uint64_t)(spi - telem_win.last_spi) * 1000u / dt);
+    }
+    telem_win.last_ms = now_ms;
+    telem_win.last_loops = loops;
+    telem_win.last_spi = spi;
+
+    xhc_mem_stat_t m;
+    xhc_mem_stats(&m);
+    telem_win.stack_peak = m.stack_peak;
+    telem_win.headroom = m.headroom;
+}
+
+/*
+ * Layout (little endian, je uint32):
+ *  [0]  0x11     [1] Layout-Version   [2] Reset-Ursache (XHC_RESET_*)   [3] Starts (max. 255)
+ *  [4]  Laufzeit ms
+ *  [8]  Scheduler-Durchläufe/s
+ *  [12] IN-Reports gesendet            [16] IN-Endpunkt belegt
+ *  [20] Host-Pakete empfangen          [24] Chunks verworfen   [28] Duplikate
+ *  [32] Rastungen Encoder              [36] gemeldet           [40] verworfen
+ *  [44] Display Bytes/s                [48] Display Bytes gesamt
+ *  [52] Stack-Spitze Bytes             [56] Luft Heap/Stack Bytes
+ *  [60] SET_REPORTs vom Host
+ *  [64] Reports mit Rad-Wert            [68] Echos gemessen      [72] Echo-Timeouts
+ *  [76] Rastung -> IN-Report   p50/p90/p99/max us (je 4 Byte)
+ *  [92] IN-Report -> Echo      p50/p90/p99/max us
+ *  [108] Rastung -> Echo       p50/p90/p99/max us (xhc_joglat.h)
+ *  [124] Schattenspeicher Bytes (uint16, 0 wenn aus)   [126] SRAM gesamt Bytes (uint16)
+ */
+uint8_t *xhc_telem_get_report(uint16_t *len)
+{
+    telem_buf[0] = XHC_TELEM_REPORT_ID;
+    telem_buf[1] = XHC_TELEM_VERSION;
+    telem_buf[2] = (uint8_t)(xhc_trace_buf.reset_cause >> 24);
+    telem_buf[3] = (uint8_t)(xhc_trace_buf.boots > 255u ? 255u : xhc_trace_buf.boots);
+    put_u32(&telem_buf[4],  HAL_GetTick());
+    put_u32(&telem_buf[8],  telem_win.loop_rate);
+    put_u32(&telem_buf[12], xhc_telem.usb_sent);
+    put_u32(&telem_buf[16], xhc_telem.usb_busy);
+    put_u32(&telem_buf[20], xhc_telem.rx_packets);
+    put_u32(&telem_buf[24], xhc_telem.rx_dropped);
+    put_u32(&telem_buf[28], xhc_telem.rx_duplicates);
+    put_u32(&telem_buf[32], xhc_telem.enc_in);
+    put_u32(&telem_buf[36], xhc_telem.enc_out);
+    put_u32(&telem_buf[40], xhc_telem.enc_discarded);
+    put_u32(&telem_buf[44], telem_win.spi_rate);
+    put_u32(&telem_buf[48], xhc_telem.spi_bytes);
+    put_u32(&telem_buf[52], telem_win.stack_peak);
+    put_u32(&telem_buf[56], telem_win.headroom);
+    put_u32(&telem_buf[60], xhc_telem.host_reports);
+
+    const xhc_joglat_stats_t *jl = xhc_joglat_stats();   // veröffentlichte Hälfte, siehe xhc_joglat.c
+    put_u32(&telem_buf[64], jl->reports);
+    put_u32(&telem_buf[68], jl->echoes);
+    put_u32(&telem_buf[72], jl->timeouts);
+    for (uint8_t p = 0; p < JOGLAT_COUNT; p++) {
+        uint8_t *d = &telem_buf[76 + p * 16];
+        put_u32(&d[0],  jl->pct[p].p50);
+        put_u32(&d[4],  jl->pct[p].p90);
+        put_u32(&d[8],  jl->pct[p].p99);
+        put_u32(&d[12], jl->pct[p].max);
+    }
+
+    uint16_t fb_ram = (uint16_t)ST7735_FB_RamUsage(), sram = (uint16_t)ST7735_SRAM_TOTAL;
+    memcpy(&telem_buf[124], &fb_ram, 2);
+    memcpy(&telem_buf[126], &sram, 2);
+
+    *len = XHC_TELEM_REPORT_LEN;
+    return telem_buf;
+}
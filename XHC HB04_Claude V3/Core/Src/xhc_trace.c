@@ -0,0 +1,51 @@
+/*
+ * XHC HB04 Binär-Trace (Ring im RAM, siehe xhc_trace.h)
+ */
+
+#include "xhc_trace.h"
+#include <string.h>
+
+#if (XHC_TRACE_DEPTH & (XHC_TRACE_DEPTH - 1u)) != 0u
+#error "XHC_TRACE_DEPTH muss eine Zweierpotenz sein"
+#endif
+
+/* .noinit: Startup-Code löscht den Ring nicht, er überlebt jeden Reset außer Power-On */
+__attribute__((section(".noinit"))) xhc_trace_buf_t xhc_trace_buf;
+
+/**
+ * @brief Flugschreiber übernehmen oder neu anlegen (einmal beim Start, nach xhc_prof_init)
+ * @param reset_flags RCC->CSR vor dem Löschen der Reset-Flags
+ */
+void xhc_trace_init(uint32_t reset_flags)
+{
+    /* Power-On: RAM-Inhalt ist Zufall, auch wenn die Magic zufällig passt */
+    if (xhc_trace_buf.magic != XHC_TRACE_MAGIC || xhc_trace_buf.depth != XHC_TRACE_DEPTH
+        || ((reset_flags >> 24) & XHC_RESET_POR)) {
+        memset(&xhc_trace_buf, 0, sizeof(xhc_trace_buf));
+        xhc_trace_buf.magic = XHC_TRACE_MAGIC;
+        xhc_trace_buf.depth = XHC_TRACE_DEPTH;
+    }
+
+    uint32_t open_dma = xhc_trace_buf.dma_started - xhc_trace_buf.dma_done;
+    uint32_t last_len = xhc_trace_buf.dma_last_len;
+    xhc_trace_buf.dma_started = xhc_trace_buf.dma_done = 0;
+    xhc_trace_buf.boots++;
+    xhc_trace_buf.reset_cause = reset_flags;
+
+    XHC_TRACE(TRC_BOOT, xhc_trace_buf.boots, reset_flags >> 24);
+    if (open_dma != 0u) {
+        XHC_TRACE(TRC_DMA_HUNG, open_dma, last_len);
+    }
+}
+
+/**
+ * @brief Ring leeren (PendSV, über Feature-Report 0x10 Seite 4)
+ *
+ * Schreibt währenddessen eine ISR, passt ihre Folgenummer nicht zum neuen
+ * Zähler und der Host verwirft den Eintrag; mehr geht dabei nicht verloren.
+ */
+void xhc_trace_reset(void)
+{
+    memset(xhc_trace_buf.rec, 0, sizeof(xhc_trace_buf.rec));
+    xhc_trace_buf.head = 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Statischer UI-Hintergrund (160x128), RLE-kodiert.
+ * GENERIERT von Tools/gen_ui_background.py - nicht von Hand bearbeiten.
+ * 1154 Bytes statt 40960 Bytes RGB565.
+ */
+
+#include "xhc_ui_background.h"
+
+const uint16_t xhc_ui_bg_palette[4] = { 0x0000, 0xFFFF, 0x001F, 0x0000 };
+
+const uint8_t xhc_ui_bg_rle[XHC_UI_BG_RLE_SIZE] = {
+    0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x65, 0x01, 0x43, 0x01, 0x7F, 0x73, 0x01, 0x45, 0x01, 0x43, 0x03,
+    0x51, 0x01, 0x43, 0x01, 0x7F, 0x73, 0x01, 0x45, 0x01, 0x42, 0x05, 0x50, 0x01, 0x43, 0x01, 0x7F,
+    0x73, 0x01, 0x45, 0x01, 0x42, 0x01, 0x42, 0x01, 0x50, 0x01, 0x41, 0x01, 0x45, 0x01, 0x7F, 0x6C,
+    0x01, 0x45, 0x01, 0x41, 0x01, 0x43, 0x01, 0x51, 0x03, 0x46, 0x01, 0x7F, 0x6C, 0x01, 0x45, 0x01,
+    0x41, 0x01, 0x57, 0x03, 0x7F, 0x75, 0x01, 0x41, 0x01, 0x41, 0x01, 0x41, 0x01, 0x56, 0x01, 0x41,
+    0x01, 0x7F, 0x75, 0x00, 0x41, 0x01, 0x41, 0x00, 0x42, 0x01, 0x55, 0x01, 0x43, 0x01, 0x7F, 0x74,
+    0x00, 0x41, 0x01, 0x41, 0x00, 0x42, 0x01, 0x55, 0x01, 0x43, 0x01, 0x7F, 0x74, 0x00, 0x40, 0x03,
+    0x40, 0x00, 0x42, 0x01, 0x55, 0x01, 0x43, 0x01, 0x44, 0x01, 0x7F, 0x6D, 0x00, 0x40, 0x00, 0x41,
+    0x00, 0x40, 0x00, 0x42, 0x01, 0x55, 0x01, 0x43, 0x01, 0x44, 0x01, 0x7F, 0x6D, 0x00, 0x40, 0x00,
+    0x41, 0x00, 0x40, 0x00, 0x42, 0x01, 0x43, 0x01, 0x7F, 0x7F, 0x4C, 0x02, 0x41, 0x02, 0x43, 0x01,
+    0x42, 0x01, 0x7F, 0x7F, 0x4C, 0x01, 0x43, 0x01, 0x43, 0x05, 0x7F, 0x7F, 0x4D, 0x01, 0x43, 0x01,
+    0x44, 0x03, 0x7F, 0x7F, 0x71, 0x01, 0x43, 0x01, 0x7F, 0x7F, 0x57, 0x01, 0x43, 0x01, 0x7F, 0x7F,
+    0x58, 0x01, 0x41, 0x01, 0x7F, 0x7F, 0x59, 0x01, 0x41, 0x01, 0x45, 0x01, 0x7F, 0x7F, 0x52, 0x03,
+    0x46, 0x01, 0x7F, 0x7F, 0x53, 0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x7F, 0x7F,
+    0x5D, 0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x47, 0x01, 0x7F, 0x7F, 0x53, 0x01, 0x47, 0x01, 0x7F, 0x7F,
+    0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x50, 0x07, 0x7F, 0x7F, 0x5D, 0x01,
+    0x7F, 0x7F, 0x5D, 0x01, 0x7F, 0x7F, 0x5C, 0x01, 0x45, 0x01, 0x7F, 0x7F, 0x54, 0x01, 0x46, 0x01,
+    0x7F, 0x7F, 0x53, 0x01, 0x7F, 0x7F, 0x5C, 0x01, 0x7F, 0x7F, 0x5C, 0x01, 0x7F, 0x7F, 0x5C, 0x01,
+    0x7F, 0x7F, 0x5D, 0x01, 0x4A, 0x01, 0x7F, 0x7F, 0x50, 0x07, 0x44, 0x01, 0x7F, 0x7F, 0x7F, 0x7F,
+    0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x4C, 0x3F, 0x3F, 0x1B, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x67, 0x01,
+    0x43, 0x01, 0x7F, 0x74, 0x02, 0x42, 0x02, 0x43, 0x03, 0x51, 0x01, 0x43, 0x01, 0x7F, 0x74, 0x02,
+    0x42, 0x02, 0x42, 0x05, 0x50, 0x01, 0x43, 0x01, 0x7F, 0x74, 0x03, 0x40, 0x03, 0x42, 0x01, 0x42,
+    0x01, 0x50, 0x01, 0x41, 0x01, 0x45, 0x01, 0x7F, 0x6D, 0x03, 0x40, 0x00, 0x40, 0x01, 0x41, 0x01,
+    0x43, 0x01, 0x51, 0x03, 0x46, 0x01, 0x7F, 0x6D, 0x01, 0x40, 0x00, 0x40, 0x00, 0x40, 0x01, 0x41,
+    0x01, 0x57, 0x03, 0x7F, 0x76, 0x01, 0x40, 0x00, 0x40, 0x00, 0x40, 0x01, 0x41, 0x01, 0x56, 0x01,
+    0x41, 0x01, 0x7F, 0x75, 0x01, 0x40, 0x02, 0x40, 0x01, 0x41, 0x01, 0x55, 0x01, 0x43, 0x01, 0x7F,
+    0x74, 0x01, 0x41, 0x00, 0x41, 0x01, 0x41, 0x01, 0x55, 0x01, 0x43, 0x01, 0x7F, 0x74, 0x01, 0x44,
+    0x01, 0x41, 0x01, 0x55, 0x01, 0x43, 0x01, 0x44, 0x01, 0x7F, 0x6D, 0x01, 0x44, 0x01, 0x41, 0x01,
+    0x55, 0x01, 0x43, 0x01, 0x44, 0x01, 0x7F, 0x6D, 0x01, 0x44, 0x01, 0x41, 0x01, 0x43, 0x01, 0x7F,
+    0x7F, 0x4C, 0x01, 0x44, 0x01, 0x42, 0x01, 0x42, 0x01, 0x7F, 0x7F, 0x4C, 0x01, 0x44, 0x01, 0x42,
+    0x05, 0x7F, 0x7F, 0x4D, 0x01, 0x44, 0x01, 0x43, 0x03, 0x7F, 0x7F, 0x71, 0x01, 0x43, 0x01, 0x7F,
+    0x7F, 0x57, 0x01, 0x43, 0x01, 0x7F, 0x7F, 0x58, 0x01, 0x41, 0x01, 0x7F, 0x7F, 0x59, 0x01, 0x41,
+    0x01, 0x45, 0x01, 0x7F, 0x7F, 0x52, 0x03, 0x46, 0x01, 0x7F, 0x7F, 0x53, 0x01, 0x7F, 0x7F, 0x5D,
+    0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x47, 0x01, 0x7F,
+    0x7F, 0x53, 0x01, 0x47, 0x01, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F,
+    0x7F, 0x50, 0x07, 0x7F, 0x7F, 0x5D, 0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x7F, 0x7F, 0x5C, 0x01, 0x45,
+    0x01, 0x7F, 0x7F, 0x54, 0x01, 0x46, 0x01, 0x7F, 0x7F, 0x53, 0x01, 0x7F, 0x7F, 0x5C, 0x01, 0x7F,
+    0x7F, 0x5C, 0x01, 0x7F, 0x7F, 0x5C, 0x01, 0x7F, 0x7F, 0x5D, 0x01, 0x4A, 0x01, 0x7F, 0x7F, 0x50,
+    0x07, 0x44, 0x01, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x4A, 0x3F, 0x3F, 0x1F,
+    0xBB, 0x00, 0xBF, 0xA6, 0x42, 0x8A, 0x42, 0x85, 0x40, 0x83, 0x42, 0x83, 0x42, 0x83, 0x42, 0x83,
+    0x42, 0x83, 0x00, 0xBF, 0xA5, 0x40, 0x82, 0x40, 0x88, 0x40, 0x82, 0x40, 0x83, 0x41, 0x82, 0x40,
+    0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x82, 0x00,
+    0xBF, 0xA5, 0x40, 0x87, 0x40, 0x83, 0x40, 0x82, 0x40, 0x82, 0x40, 0x80, 0x40, 0x82, 0x40, 0x82,
+    0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x82, 0x00, 0xBF,
+    0xA6, 0x41, 0x8E, 0x40, 0x82, 0x40, 0x80, 0x40, 0x82, 0x40, 0x80, 0x40, 0x80, 0x40, 0x81, 0x40,
+    0x80, 0x40, 0x80, 0x40, 0x81, 0x40, 0x80, 0x40, 0x80, 0x40, 0x81, 0x40, 0x80, 0x40, 0x80, 0x40,
+    0x82, 0x00, 0xBF, 0xA8, 0x40, 0x8C, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x82, 0x40, 0x81,
+    0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x82, 0x00, 0xBF, 0xA9, 0x40,
+    0x8A, 0x40, 0x83, 0x44, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40,
+    0x81, 0x40, 0x82, 0x40, 0x82, 0x00, 0xBF, 0xA5, 0x40, 0x82, 0x40, 0x89, 0x40, 0x87, 0x40, 0x82,
+    0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x82,
+    0x00, 0xBF, 0xA6, 0x42, 0x84, 0x40, 0x83, 0x44, 0x84, 0x40, 0x83, 0x42, 0x83, 0x42, 0x83, 0x42,
+    0x83, 0x42, 0x83, 0x00, 0xBF, 0xBF, 0x9E, 0x00, 0xBF, 0xBF, 0x9E, 0x00, 0xBF, 0xBF, 0x9E, 0x00,
+    0xBF, 0xA5, 0x44, 0x89, 0x42, 0x82, 0x44, 0x82, 0x42, 0x83, 0x42, 0x91, 0x00, 0xBF, 0xA5, 0x40,
+    0x8C, 0x40, 0x82, 0x40, 0x81, 0x40, 0x85, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x90, 0x00,
+    0xBF, 0xA5, 0x40, 0x87, 0x40, 0x87, 0x40, 0x81, 0x40, 0x85, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82,
+    0x40, 0x90, 0x00, 0xBF, 0xA5, 0x43, 0x8B, 0x41, 0x82, 0x43, 0x82, 0x40, 0x80, 0x40, 0x80, 0x40,
+    0x81, 0x40, 0x80, 0x40, 0x80, 0x40, 0x90, 0x00, 0xBF, 0xA5, 0x40, 0x90, 0x40, 0x85, 0x40, 0x81,
+    0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x90, 0x00, 0xBF, 0xA5, 0x40, 0x90, 0x40, 0x85, 0x40,
+    0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x90, 0x00, 0xBF, 0xA5, 0x40, 0x8C, 0x40, 0x82,
+    0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x90, 0x00, 0xBF,
+    0xA5, 0x40, 0x87, 0x40, 0x84, 0x42, 0x83, 0x42, 0x83, 0x42, 0x83, 0x42, 0x91, 0x00, 0xBF, 0xBF,
+    0x9E, 0x00, 0xBF, 0xA2, 0x3F, 0x3F, 0x1F, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x82, 0x43, 0x83, 0x42,
+    0x83, 0x42, 0xBF, 0x88, 0x42, 0x82, 0x44, 0x81, 0x43, 0xB3, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82,
+    0x40, 0x81, 0x40, 0x82, 0x40, 0xBF, 0x86, 0x40, 0x82, 0x40, 0x83, 0x40, 0x83, 0x40, 0x82, 0x40,
+    0xB2, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x81, 0x40, 0x87, 0x40, 0xBF, 0x81, 0x40, 0x87,
+    0x40, 0x83, 0x40, 0x82, 0x40, 0x83, 0x40, 0xAD, 0x40, 0x82, 0x40, 0x81, 0x40, 0x82, 0x40, 0x82,
+    0x41, 0xBF, 0x89, 0x41, 0x85, 0x40, 0x83, 0x40, 0x82, 0x40, 0xB2, 0x43, 0x82, 0x40, 0x82, 0x40,
+    0x84, 0x40, 0xBF, 0x8A, 0x40, 0x84, 0x40, 0x83, 0x43, 0xB3, 0x40, 0x85, 0x40, 0x82, 0x40, 0x85,
+    0x40, 0xBF, 0x8A, 0x40, 0x83, 0x40, 0x83, 0x40, 0xB6, 0x40, 0x85, 0x40, 0x82, 0x40, 0x81, 0x40,
+    0x82, 0x40, 0xBF, 0x86, 0x40, 0x82, 0x40, 0x83, 0x40, 0x83, 0x40, 0xB6, 0x40, 0x86, 0x42, 0x83,
+    0x42, 0x84, 0x40, 0xBF, 0x82, 0x42, 0x84, 0x40, 0x83, 0x40, 0x87, 0x40, 0xBF, 0xBF, 0xBF, 0xBF,
+    0xBF, 0xAA,
+};
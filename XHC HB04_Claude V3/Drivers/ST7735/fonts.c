@@ -1,6 +1,13 @@
 /* vim: set ai et ts=4 sw=4: */
 #include "fonts.h"
 
+/*
+ * Quelle aller Glyphen. Mit ST7735_PACKED_FONTS=1 werden die Tabellen nicht
+ * gelinkt, sondern von Tools/gen_packed_fonts.py nach fonts_packed.c übersetzt
+ * (die Tools lesen diese Datei, also hier ändern und neu generieren).
+ */
+#if !ST7735_PACKED_FONTS
+
 static const uint16_t Font7x10 [] = {
 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // sp
 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x0000, 0x1000, 0x0000, 0x0000,  // !
@@ -419,7 +426,7 @@ static const uint16_t Font9x12[] = {
 
 	    0x0000, 0x0000, 0x0000, 0x1800, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1000, 0x1800, // [
 
-	    0x0000, 0x0000, 0x0000, 0x4000, 0x2000, 0x2000, 0x1000, 0x0800, 0x0800, 0x0400, 0x0400, 0x0200, // \
+	    0x0000, 0x0000, 0x0000, 0x4000, 0x2000, 0x2000, 0x1000, 0x0800, 0x0800, 0x0400, 0x0400, 0x0200, // Backslash
 
 	    0x0000, 0x0000, 0x0000, 0x1800, 0x0800, 0x0800, 0x0800, 0x0800, 0x0800, 0x0800, 0x0800, 0x1800, // ]
 
@@ -615,7 +622,7 @@ static const uint16_t Font9x11[] = {
 
 		    0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, // [
 
-		    0xc000, 0x6000, 0x6000, 0x3800, 0x3800, 0x1c00, 0x1c00, 0x1c00, 0x0600, 0x0600, 0x0300, // \
+		    0xc000, 0x6000, 0x6000, 0x3800, 0x3800, 0x1c00, 0x1c00, 0x1c00, 0x0600, 0x0600, 0x0300, // Backslash
 
 		    0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, 0x0600, // ]
 
@@ -693,3 +700,31 @@ FontDef Font_16x26 = {16,26,Font16x26};
 FontDef Font_9x12 = {9,12,Font9x12};
 FontDef Font_9x11 = {9,11,Font9x11};
 
+#endif /* !ST7735_PACKED_FONTS */
+
+/**
+ * @brief Zeile eines Glyphs im klassischen Format (Bit 15 = linkes Pixel)
+ *
+ * Für beide Formate; Zeichen, die im Font fehlen, liefern 0 (Hintergrund).
+ */
+uint16_t Font_GlyphRow(const FontDef *font, char ch, uint16_t row)
+{
+    if (font->data) {
+        return font->data[(ch - 32) * font->height + row];
+    }
+
+    const uint8_t *g = Font_PackedGlyph(font, ch);
+    if (g == NULL) return 0;
+
+    uint16_t bit   = (uint16_t)(row * font->width);
+    uint16_t first = bit >> 3;
+    uint16_t last  = (uint16_t)((bit + font->width - 1u) >> 3);   // max. first+2
+    // bis zu 16 Bit ab beliebiger Bitposition -> 24 Bit Fenster
+    uint32_t win = 0;
+    for (uint16_t k = first; k <= last; k++) {
+        win |= (uint32_t)g[k] << (16u - 8u * (k - first));
+    }
+    win <<= (bit & 7u);
+    return (uint16_t)((win >> 8) & (0xFFFFu << (16u - font->width)));
+}
+
@@ -3,20 +3,64 @@
 #define __FONTS_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
+/* 1 = gepackte, reduzierte Fonts aus fonts_packed.c (Tools/gen_packed_fonts.py),
+ * 0 = klassische Tabellen aus fonts.c (alle Fonts, voller ASCII-Satz) */
+#ifndef ST7735_PACKED_FONTS
+#define ST7735_PACKED_FONTS 1
+#endif
+
+/* Layout muss mit Core/Inc/fonts.h übereinstimmen (FontDef wird by value übergeben) */
 typedef struct {
     const uint8_t width;
     uint8_t height;
-    const uint16_t *data;
+    const uint16_t *data;     // klassisch: ein uint16 je Zeile, Bit 15 = linkes Pixel
+    const uint8_t *packed;    // gepackt: width*height Bit je Glyph, MSB zuerst, Glyph auf Byte aufgefüllt
+    const uint8_t *map;       // gepackt: Zeichen-32 -> Glyph-Index, 0xFF = fehlt; NULL = alle 95
 } FontDef;
 
 
 extern FontDef Font_7x10;
 extern FontDef Font_11x18;
+extern FontDef Font_9x11;
+#if !ST7735_PACKED_FONTS
 extern FontDef Font_16x26;
 extern FontDef Font_9x12;
-extern FontDef Font_9x11;
+#endif
+
+/* Gepacktes Glyph zu ch, NULL wenn nicht im Font enthalten */
+static inline const uint8_t *Font_PackedGlyph(const FontDef *font, char ch)
+{
+    uint8_t c = (uint8_t)ch;
+    if (c < 32u || c > 126u) return NULL;
+    uint8_t idx = font->map ? font->map[c - 32u] : (uint8_t)(c - 32u);
+    if (idx == 0xFFu) return NULL;
+    return font->packed + (uint16_t)idx * (uint16_t)((font->width * font->height + 7u) / 8u);
+}
+
+uint16_t Font_GlyphRow(const FontDef *font, char ch, uint16_t row);
 
+/* Proportionale Adafruit-GFX-Fonts (Core/Src/dosis_bold8pt7b.c, FreeSansBold9pt7b.c).
+ * Layout wie in Core/Inc/fonts.h. Bitmap: width*height Bit je Glyph, MSB zuerst. */
+typedef struct {
+    const uint8_t *bitmap;
+    const void *glyph;
+    uint8_t first;
+    uint8_t last;
+    uint8_t yAdvance;
+} GFXfont;
+
+typedef struct {
+    uint16_t bitmapOffset;
+    uint8_t width;
+    uint8_t height;
+    uint8_t xAdvance;
+    int8_t xOffset;
+    int8_t yOffset;
+} GFXglyph;
 
+extern const GFXfont FreeSansBold9pt7b;
+extern const GFXfont dosis_bold8pt7b;
 
 #endif // __FONTS_H__
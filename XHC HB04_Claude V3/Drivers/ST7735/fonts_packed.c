@@ -0,0 +1,118 @@
+/* vim: set ai et ts=4 sw=4: */
+/*
+ * Gepackte, auf die benutzten Zeichen reduzierte Fonts.
+ * GENERIERT von Tools/gen_packed_fonts.py aus fonts.c - nicht von Hand bearbeiten.
+ */
+#include "fonts.h"
+
+#if ST7735_PACKED_FONTS
+
+/* Font_7x10: 95 Zeichen, 9 Bytes je Glyph (vorher 20) */
+static const uint8_t Font7x10_bits[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20, 0x40, 0x81, 0x02, 0x00, 0x08,
+    0x00, 0x00, 0x28, 0x50, 0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x49, 0xF1, 0x24, 0x8F,
+    0x92, 0x24, 0x00, 0x00, 0x38, 0xA9, 0x41, 0xC1, 0x4A, 0x95, 0x1C, 0x10, 0x00, 0x20, 0xA9, 0x61,
+    0x82, 0x8A, 0x85, 0x04, 0x00, 0x00, 0x10, 0x50, 0xA0, 0x83, 0x49, 0x12, 0x1A, 0x00, 0x00, 0x10,
+    0x20, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x20, 0x81, 0x02, 0x04, 0x08, 0x10, 0x10,
+    0x10, 0x20, 0x20, 0x20, 0x40, 0x81, 0x02, 0x04, 0x10, 0x40, 0x10, 0x70, 0x41, 0x40, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x87, 0xC2, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x08, 0x10, 0x20, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x08, 0x10, 0x40, 0x81, 0x02, 0x08, 0x10, 0x00, 0x00,
+    0x38, 0x89, 0x12, 0xA4, 0x48, 0x91, 0x1C, 0x00, 0x00, 0x10, 0x61, 0x40, 0x81, 0x02, 0x04, 0x08,
+    0x00, 0x00, 0x38, 0x89, 0x10, 0x20, 0x82, 0x08, 0x3E, 0x00, 0x00, 0x38, 0x88, 0x10, 0xC0, 0x40,
+    0x91, 0x1C, 0x00, 0x00, 0x08, 0x30, 0xA1, 0x44, 0x8F, 0x82, 0x04, 0x00, 0x00, 0x7C, 0x81, 0x03,
+    0xC0, 0x40, 0x91, 0x1C, 0x00, 0x00, 0x38, 0x89, 0x03, 0xC4, 0x48, 0x91, 0x1C, 0x00, 0x00, 0x7C,
+    0x08, 0x20, 0x81, 0x04, 0x08, 0x10, 0x00, 0x00, 0x38, 0x89, 0x11, 0xC4, 0x48, 0x91, 0x1C, 0x00,
+    0x00, 0x38, 0x89, 0x12, 0x23, 0xC0, 0x91, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x08, 0x10, 0x20, 0x00, 0x00, 0x31, 0x84,
+    0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xE0, 0x0F, 0x80, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x80, 0xC0, 0x43, 0x18, 0x00, 0x00, 0x00, 0x38, 0x88, 0x10, 0x41, 0x02, 0x00, 0x08, 0x00, 0x00,
+    0x38, 0x89, 0x32, 0xA5, 0xC8, 0x10, 0x1C, 0x00, 0x00, 0x10, 0x50, 0xA1, 0x42, 0x8F, 0x91, 0x22,
+    0x00, 0x00, 0x78, 0x89, 0x13, 0xC4, 0x48, 0x91, 0x3C, 0x00, 0x00, 0x38, 0x89, 0x02, 0x04, 0x08,
+    0x11, 0x1C, 0x00, 0x00, 0x70, 0x91, 0x12, 0x24, 0x48, 0x92, 0x38, 0x00, 0x00, 0x7C, 0x81, 0x03,
+    0xE4, 0x08, 0x10, 0x3E, 0x00, 0x00, 0x7C, 0x81, 0x03, 0xC4, 0x08, 0x10, 0x20, 0x00, 0x00, 0x38,
+    0x89, 0x02, 0x05, 0xC8, 0x91, 0x1C, 0x00, 0x00, 0x44, 0x89, 0x13, 0xE4, 0x48, 0x91, 0x22, 0x00,
+    0x00, 0x38, 0x20, 0x40, 0x81, 0x02, 0x04, 0x1C, 0x00, 0x00, 0x04, 0x08, 0x10, 0x20, 0x40, 0x91,
+    0x1C, 0x00, 0x00, 0x44, 0x91, 0x43, 0x05, 0x09, 0x12, 0x22, 0x00, 0x00, 0x40, 0x81, 0x02, 0x04,
+    0x08, 0x10, 0x3E, 0x00, 0x00, 0x44, 0xD9, 0xB2, 0xA4, 0x48, 0x91, 0x22, 0x00, 0x00, 0x44, 0xC9,
+    0x92, 0xA5, 0x49, 0x93, 0x22, 0x00, 0x00, 0x38, 0x89, 0x12, 0x24, 0x48, 0x91, 0x1C, 0x00, 0x00,
+    0x78, 0x89, 0x12, 0x27, 0x88, 0x10, 0x20, 0x00, 0x00, 0x38, 0x89, 0x12, 0x24, 0x48, 0x95, 0x1C,
+    0x04, 0x00, 0x78, 0x89, 0x12, 0x27, 0x89, 0x12, 0x22, 0x00, 0x00, 0x38, 0x89, 0x01, 0x80, 0x80,
+    0x91, 0x1C, 0x00, 0x00, 0x7C, 0x20, 0x40, 0x81, 0x02, 0x04, 0x08, 0x00, 0x00, 0x44, 0x89, 0x12,
+    0x24, 0x48, 0x91, 0x1C, 0x00, 0x00, 0x44, 0x89, 0x11, 0x42, 0x85, 0x04, 0x08, 0x00, 0x00, 0x44,
+    0x89, 0x52, 0xA5, 0x4D, 0x8A, 0x14, 0x00, 0x00, 0x44, 0x50, 0xA0, 0x81, 0x05, 0x0A, 0x22, 0x00,
+    0x00, 0x44, 0x88, 0xA1, 0x41, 0x02, 0x04, 0x08, 0x00, 0x00, 0x7C, 0x08, 0x20, 0x81, 0x04, 0x10,
+    0x3E, 0x00, 0x00, 0x18, 0x20, 0x40, 0x81, 0x02, 0x04, 0x08, 0x10, 0x30, 0x20, 0x40, 0x40, 0x81,
+    0x02, 0x02, 0x04, 0x00, 0x00, 0x30, 0x20, 0x40, 0x81, 0x02, 0x04, 0x08, 0x10, 0x60, 0x10, 0x50,
+    0xA2, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xFC,
+    0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE2, 0x23, 0xC8, 0x93, 0x1A,
+    0x00, 0x00, 0x40, 0x81, 0x63, 0x24, 0x48, 0x99, 0x2C, 0x00, 0x00, 0x00, 0x00, 0xE2, 0x24, 0x08,
+    0x11, 0x1C, 0x00, 0x00, 0x04, 0x08, 0xD2, 0x64, 0x48, 0x93, 0x1A, 0x00, 0x00, 0x00, 0x00, 0xE2,
+    0x27, 0xC8, 0x11, 0x1C, 0x00, 0x00, 0x0C, 0x21, 0xF0, 0x81, 0x02, 0x04, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0xD2, 0x64, 0x48, 0x93, 0x1A, 0x04, 0xF0, 0x40, 0x81, 0x63, 0x24, 0x48, 0x91, 0x22, 0x00,
+    0x00, 0x10, 0x01, 0xC0, 0x81, 0x02, 0x04, 0x08, 0x00, 0x00, 0x10, 0x01, 0xC0, 0x81, 0x02, 0x04,
+    0x08, 0x11, 0xC0, 0x40, 0x81, 0x22, 0x86, 0x0A, 0x12, 0x22, 0x00, 0x00, 0x70, 0x20, 0x40, 0x81,
+    0x02, 0x04, 0x08, 0x00, 0x00, 0x00, 0x01, 0xE2, 0xA5, 0x4A, 0x95, 0x2A, 0x00, 0x00, 0x00, 0x01,
+    0x63, 0x24, 0x48, 0x91, 0x22, 0x00, 0x00, 0x00, 0x00, 0xE2, 0x24, 0x48, 0x91, 0x1C, 0x00, 0x00,
+    0x00, 0x01, 0x63, 0x24, 0x48, 0x99, 0x2C, 0x40, 0x80, 0x00, 0x00, 0xD2, 0x64, 0x48, 0x93, 0x1A,
+    0x04, 0x08, 0x00, 0x01, 0x63, 0x24, 0x08, 0x10, 0x20, 0x00, 0x00, 0x00, 0x00, 0xE2, 0x23, 0x01,
+    0x11, 0x1C, 0x00, 0x00, 0x20, 0x41, 0xE1, 0x02, 0x04, 0x08, 0x0C, 0x00, 0x00, 0x00, 0x01, 0x12,
+    0x24, 0x48, 0x93, 0x1A, 0x00, 0x00, 0x00, 0x01, 0x12, 0x22, 0x85, 0x0A, 0x08, 0x00, 0x00, 0x00,
+    0x01, 0x52, 0xA5, 0x4D, 0x8A, 0x14, 0x00, 0x00, 0x00, 0x01, 0x11, 0x41, 0x02, 0x0A, 0x22, 0x00,
+    0x00, 0x00, 0x01, 0x12, 0x22, 0x85, 0x04, 0x08, 0x10, 0xC0, 0x00, 0x01, 0xF0, 0x41, 0x04, 0x10,
+    0x3E, 0x00, 0x00, 0x18, 0x20, 0x40, 0x82, 0x04, 0x04, 0x08, 0x10, 0x30, 0x10, 0x20, 0x40, 0x81,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x30, 0x20, 0x40, 0x80, 0x81, 0x04, 0x08, 0x10, 0x60, 0x00, 0x00,
+    0x03, 0xA4, 0xC0, 0x00, 0x00, 0x00, 0x00,
+};
+FontDef Font_7x10 = {7, 10, NULL, Font7x10_bits, NULL};
+
+/* Font_9x11: 21 Zeichen, 13 Bytes je Glyph (vorher 22) */
+static const uint8_t Font9x11_bits[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x81, 0xC3, 0xF9, 0xFC, 0x38, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+    0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x06, 0x03, 0x00, 0x7E, 0x61, 0xB0, 0xD8, 0xED, 0xF7, 0xDB, 0xED, 0xC6, 0xC3, 0x61, 0x9F,
+    0x80, 0x1C, 0x1E, 0x1B, 0x09, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x0F, 0xC0, 0x7E, 0x61,
+    0x80, 0xC0, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x61, 0xBF, 0xC0, 0x7E, 0x61, 0x80, 0xC0, 0x63,
+    0xE0, 0x18, 0x0C, 0x06, 0x03, 0x61, 0x9F, 0x80, 0xC0, 0x60, 0x31, 0x98, 0xCC, 0x66, 0x33, 0x19,
+    0xFE, 0x06, 0x03, 0x01, 0x80, 0xFF, 0x61, 0xB0, 0x18, 0x0F, 0xE0, 0x18, 0x0C, 0x06, 0x03, 0x61,
+    0x9F, 0x80, 0x7E, 0x61, 0xB0, 0x18, 0x0F, 0xE6, 0x1B, 0x0D, 0x86, 0xC3, 0x61, 0x9F, 0x80, 0xFF,
+    0x61, 0x80, 0xC0, 0x60, 0x70, 0x70, 0x70, 0x30, 0x18, 0x0C, 0x06, 0x00, 0x7E, 0x61, 0xB0, 0xD8,
+    0x67, 0xE6, 0x1B, 0x0D, 0x86, 0xC3, 0x61, 0x9F, 0x80, 0x7E, 0x61, 0xB0, 0xD8, 0x6C, 0x33, 0xF9,
+    0xFC, 0x06, 0x03, 0x61, 0x9F, 0x80, 0x00, 0x00, 0x00, 0x01, 0x80, 0xC0, 0x00, 0x00, 0x00, 0x00,
+    0x06, 0x03, 0x00, 0x7E, 0x61, 0xB0, 0xD8, 0x6F, 0xF6, 0x1B, 0x0D, 0x86, 0xC3, 0x61, 0xB0, 0xC0,
+    0xFE, 0x61, 0xB0, 0xD8, 0x6F, 0xE6, 0x1B, 0x0D, 0x86, 0xC3, 0x61, 0xBF, 0x80, 0x7F, 0x60, 0x30,
+    0x18, 0x0C, 0x06, 0x03, 0x01, 0x80, 0xC0, 0x60, 0x1F, 0xC0, 0xC3, 0x61, 0xB0, 0xCC, 0xC3, 0xC1,
+    0xE1, 0x99, 0x86, 0xC3, 0x61, 0xB0, 0xC0, 0xC3, 0x61, 0x99, 0x8C, 0xC3, 0xC0, 0xC0, 0x60, 0x30,
+    0x18, 0x0C, 0x06, 0x00, 0xFF, 0x01, 0x80, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x60, 0x3F,
+    0xC0,
+};
+static const uint8_t Font9x11_map[95] = {
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0x02, 0x03, 0xFF,
+    0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0F, 0x10, 0x11, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x12, 0x13, 0x14, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+FontDef Font_9x11 = {9, 11, NULL, Font9x11_bits, Font9x11_map};
+
+/* Font_11x18: 3 Zeichen, 25 Bytes je Glyph (vorher 36) */
+static const uint8_t Font11x18_bits[] = {
+    0x00, 0x03, 0xC0, 0xFC, 0x18, 0xC6, 0x18, 0xC0, 0x18, 0x03, 0x00, 0x60, 0x0C, 0x01, 0x80, 0x30,
+    0xC3, 0x18, 0x7E, 0x07, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x39, 0xC7, 0x3D, 0xE7, 0xAC,
+    0xD5, 0x9A, 0xB3, 0x76, 0x64, 0xCC, 0x19, 0x83, 0x30, 0x66, 0x0C, 0xC1, 0x98, 0x30, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x18, 0x1B, 0x03, 0x60, 0x6C, 0x0D, 0x81, 0xB3, 0x32, 0x64, 0x4C, 0x8B, 0xD1,
+    0x4A, 0x29, 0x47, 0x38, 0xC3, 0x18, 0x60, 0x00, 0x00, 0x00, 0x00,
+};
+static const uint8_t Font11x18_map[95] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+FontDef Font_11x18 = {11, 18, NULL, Font11x18_bits, Font11x18_map};
+
+#endif /* ST7735_PACKED_FONTS */
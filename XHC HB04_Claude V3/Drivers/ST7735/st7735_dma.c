@@ -1,5 +1,10 @@
 /* vim: set ai et ts=4 sw=4: */
 #include "st7735_dma.h"
+#include "st7735_fb.h"
+#include "xhc_profiler.h"
+#include "xhc_telemetry.h"
+#include "xhc_trace.h"
+#include "xhc_wdg.h"
 
 #include "stm32f1xx_hal.h"
 #include <string.h>
@@ -43,14 +48,23 @@ static uint8_t linebuf[ST7735_WIDTH * 2];
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
 {
     if (hspi == &ST7735_SPI_PORT) {
+        XHC_TRACE_DMA_DONE();
         st_dma_busy = 0;
     }
 }
 
-static inline void ST_WaitDMA(void)     { while (st_dma_busy) { __NOP(); } }
+/* Läuft an jeder Wartestelle (ST7735_SetYieldHook), z.B. xhc_sched_yield */
+static void (*st_yield_hook)(void) = NULL;
+
+void ST7735_SetYieldHook(void (*hook)(void)) { st_yield_hook = hook; }
+
+static inline void ST_Yield(void)       { if (st_yield_hook) st_yield_hook(); }
+static inline void ST_WaitDMA(void)     { while (st_dma_busy) { ST_Yield(); __NOP(); } }
 static inline void ST_StartDMA(uint8_t *buf, uint16_t len)
 {
     st_dma_busy = 1;
+    XHC_TELEM_ADD(spi_bytes, len);
+    XHC_TRACE_DMA_START(len);
     HAL_SPI_Transmit_DMA(&ST7735_SPI_PORT, buf, len);
 }
 
@@ -59,6 +73,7 @@ static inline void ST_StartDMA(uint8_t *buf, uint16_t len)
 static void ST_WriteCommand(uint8_t cmd)
 {
     CS_LOW();   DC_CMD();
+    XHC_TELEM_ADD(spi_bytes, 1);
     HAL_SPI_Transmit(&ST7735_SPI_PORT, &cmd, 1, HAL_MAX_DELAY);
     CS_HIGH();
 }
@@ -66,6 +81,7 @@ static void ST_WriteCommand(uint8_t cmd)
 static void ST_WriteData8(uint8_t d)
 {
     CS_LOW();   DC_DATA();
+    XHC_TELEM_ADD(spi_bytes, 1);
     HAL_SPI_Transmit(&ST7735_SPI_PORT, &d, 1, HAL_MAX_DELAY);
     CS_HIGH();
 }
@@ -74,6 +90,7 @@ static void ST_WriteData(const uint8_t *buf, uint16_t len)
 {
     if (!len) return;
     CS_LOW();   DC_DATA();
+    XHC_TELEM_ADD(spi_bytes, len);
     HAL_SPI_Transmit(&ST7735_SPI_PORT, (uint8_t*)buf, len, HAL_MAX_DELAY);
     CS_HIGH();
 }
@@ -85,6 +102,24 @@ static void ST_WriteData(const uint8_t *buf, uint16_t len)
 static inline void ST_BeginData(void) { CS_LOW();  DC_DATA(); }
 static inline void ST_EndData(void)   { CS_HIGH(); }
 
+void ST7735_StreamBegin(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    ST7735_SetAddressWindow(x, y, x + w - 1, y + h - 1);
+    ST_BeginData();
+}
+
+void ST7735_StreamData(uint8_t *buf, uint16_t len)
+{
+    ST_WaitDMA();
+    ST_StartDMA(buf, len);
+}
+
+void ST7735_StreamEnd(void)
+{
+    ST_WaitDMA();
+    ST_EndData();
+}
+
 /* --------------------------- Init Command Tables --------------------------- */
 
 static const uint8_t init_cmds1[] = {
@@ -133,29 +168,6 @@ static const uint8_t init_cmds3[] = {
     ST7735_DISPON , DELAY, 100
 };
 
-static void ST_ExecCmdList(const uint8_t *p)
-{
-    uint8_t n = *p++;
-    while (n--) {
-        uint8_t cmd = *p++;
-        ST_WriteCommand(cmd);
-
-        uint8_t numArgs = *p++;
-        uint16_t ms = numArgs & DELAY;
-        numArgs &= ~DELAY;
-
-        if (numArgs) {
-            ST_WriteData(p, numArgs);
-            p += numArgs;
-        }
-        if (ms) {
-            ms = *p++;
-            if (ms == 255) ms = 500;
-            HAL_Delay(ms);
-        }
-    }
-}
-
 /* ------------------------------ Address Window ---------------------------- */
 
 void ST7735_SetAddressWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
@@ -185,20 +197,375 @@ void ST7735_Select(void) {
 
 void ST7735_Unselect(void) { CS_HIGH(); }
 
-static void ST_Reset(void)
+/* ---------------------- SPI-Takt mit Rücklese-Prüfung --------------------- */
+/*
+ * Das Panel nimmt Schreibzugriffe meist weit über den 15 MHz des
+ * Datenblatts an, wie weit hängt von Modul und Leitungslänge ab. Deshalb
+ * wird einmal beim Boot gemessen: Testmuster in ein 8-Pixel-Fenster oben
+ * links schreiben (Kommandos und Daten beim Kandidaten-Takt), dann beim
+ * CubeMX-Takt per RAMRD zurücklesen und mit der Referenz vergleichen.
+ *
+ * Gelesen wird per Bit-Bang: SPI1 läuft 1-Line (nur SDA, kein MISO), der
+ * Lesetakt des Panels ist ohnehin auf 6,6 MHz begrenzt. SCK wird dafür
+ * kurz zum GPIO-Ausgang, SDA zum Eingang. Byte-Ausrichtung und Dummy-Takte
+ * sind egal, verglichen werden nur Rohdaten gleicher Lesevorgänge.
+ *
+ * Ein verfälschtes Kommando-Byte kann Panel-Register verstellen; ist ein
+ * Kandidat durchgefallen, läuft die Init deshalb ab dem Reset noch einmal
+ * beim gewählten Takt (~1 s länger bis zur UI).
+ */
+#if ST7735_SPI_AUTOTUNE
+
+#define ST_PROBE_PIXELS  8u
+#define ST_PROBE_READ    (ST_PROBE_PIXELS * 3u + 1u)   // RAMRD liefert 18 Bit je Pixel, + Dummy
+#define ST_TUNE_ROUNDS   4u                           // je Kandidat, Muster abwechselnd invertiert
+#define ST_BR_STEP       (SPI_BAUDRATEPRESCALER_4 - SPI_BAUDRATEPRESCALER_2)
+
+static const uint16_t st_probe_px[ST_PROBE_PIXELS] = {
+    0xAA55, 0x55AA, 0xFFFF, 0x0000, 0xF0F0, 0x0F0F, 0xCCCC, 0x3333
+};
+
+static void ST_SetPrescaler(uint32_t br)
+{
+    ST7735_SPI_PORT.Init.BaudRatePrescaler = br;
+    if (HAL_SPI_Init(&ST7735_SPI_PORT) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+static void ST_PinMode(GPIO_TypeDef *port, uint16_t pin, uint32_t mode)
 {
-    RST_LOW();  HAL_Delay(5);
-    RST_HIGH(); HAL_Delay(120);
+    GPIO_InitTypeDef g = {0};
+    g.Pin   = pin;
+    g.Mode  = mode;
+    g.Pull  = GPIO_NOPULL;
+    g.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(port, &g);
 }
 
-void ST7735_Init(void)
+/* Halbe Taktperiode, > 60 ns (tRDH/tRDL) auch ohne Funktionsaufruf-Overhead */
+static inline void ST_BitDelay(void)
+{
+    __NOP(); __NOP(); __NOP(); __NOP(); __NOP(); __NOP();
+}
+
+/* Ein Takt, Panel schiebt mit der fallenden Flanke, gelesen vor der nächsten */
+static inline uint8_t ST_ClockBit(void)
+{
+    HAL_GPIO_WritePin(ST77_SCK_GPIO, ST77_SCK_PIN, GPIO_PIN_SET);
+    ST_BitDelay();
+    uint8_t bit = HAL_GPIO_ReadPin(ST77_SDA_GPIO, ST77_SDA_PIN) == GPIO_PIN_SET;
+    HAL_GPIO_WritePin(ST77_SCK_GPIO, ST77_SCK_PIN, GPIO_PIN_RESET);
+    ST_BitDelay();
+    return bit;
+}
+
+/* Lesekommando senden und len Bytes nach einem Dummy-Takt einlesen */
+static void ST_ReadCommand(uint8_t cmd, uint8_t *buf, uint16_t len)
+{
+    CS_LOW();   DC_CMD();
+    XHC_TELEM_ADD(spi_bytes, 1);
+    HAL_SPI_Transmit(&ST7735_SPI_PORT, &cmd, 1, HAL_MAX_DELAY);
+
+    // SCK ist nach dem Transfer low (CPOL 0), der GPIO übernimmt ohne Flanke
+    HAL_GPIO_WritePin(ST77_SCK_GPIO, ST77_SCK_PIN, GPIO_PIN_RESET);
+    ST_PinMode(ST77_SCK_GPIO, ST77_SCK_PIN, GPIO_MODE_OUTPUT_PP);
+    ST_PinMode(ST77_SDA_GPIO, ST77_SDA_PIN, GPIO_MODE_INPUT);
+    DC_DATA();
+
+    (void)ST_ClockBit();
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t b = 0;
+        for (uint8_t k = 0; k < 8u; k++) {
+            b = (uint8_t)((b << 1) | ST_ClockBit());
+        }
+        buf[i] = b;
+    }
+    CS_HIGH();
+
+    ST_PinMode(ST77_SCK_GPIO, ST77_SCK_PIN, GPIO_MODE_AF_PP);
+    ST_PinMode(ST77_SDA_GPIO, ST77_SDA_PIN, GPIO_MODE_AF_PP);
+}
+
+static void ST_ProbeWrite(uint8_t invert)
+{
+    uint8_t buf[ST_PROBE_PIXELS * 2u];
+    for (uint8_t i = 0; i < ST_PROBE_PIXELS; i++) {
+        uint16_t c = invert ? (uint16_t)~st_probe_px[i] : st_probe_px[i];
+        buf[2u * i]      = (uint8_t)(c >> 8);
+        buf[2u * i + 1u] = (uint8_t)(c & 0xFF);
+    }
+    ST7735_SetAddressWindow(0, 0, ST_PROBE_PIXELS - 1u, 0);
+    ST_WriteData(buf, sizeof(buf));
+}
+
+static void ST_ProbeRead(uint8_t *buf)
+{
+    ST7735_SetAddressWindow(0, 0, ST_PROBE_PIXELS - 1u, 0);   // RAMWR ohne Daten schadet nicht
+    ST_ReadCommand(ST7735_RAMRD, buf, ST_PROBE_READ);
+}
+
+/*
+ * Messung in Schritten (ST_BOOT_TUNE, ein Schritt je ST7735_InitStep-Aufruf,
+ * also je UI-Task-Lauf), damit die 1-ms-Tasks dazwischen weiterlaufen:
+ *   step 0..3   Referenz beim CubeMX-Takt: Muster schreiben + lesen, noch
+ *               einmal lesen, dasselbe invertiert. Ohne Rückkanal (SDA am
+ *               Modul nur Eingang, Leitung offen oder fest) kommen für beide
+ *               Muster dieselben Bytes, dann bleibt der CubeMX-Teiler.
+ *   danach      je Schritt eine Runde: bei br schreiben, bei safe lesen.
+ *               Vom schnellsten Teiler abwärts; der erste fehlerfreie wird
+ *               nicht benutzt, sondern die Stufe darunter noch einmal geprüft
+ *               (margin) und betrieben.
+ */
+static struct {
+    uint32_t safe;          // CubeMX-Teiler, Referenz und Lesetakt
+    uint32_t br;            // Kandidat
+    uint32_t chosen;
+    uint8_t  step;
+    uint8_t  round;
+    uint8_t  margin;        // br liegt eine Stufe unter dem schnellsten fehlerfreien
+    uint8_t  failed;        // ein Kandidat hat falsch zurückgelesen
+    uint8_t  readback;      // Rückkanal vorhanden
+    uint8_t  ref[2][ST_PROBE_READ];
+} st_tune;
+
+static void ST_TuneStart(void)
+{
+    memset(&st_tune, 0, sizeof(st_tune));
+    st_tune.safe   = ST7735_SPI_PORT.Init.BaudRatePrescaler;
+    st_tune.chosen = st_tune.safe;
+    st_tune.br     = SPI_BAUDRATEPRESCALER_2;
+}
+
+static uint8_t ST_TuneDone(void)
+{
+    ST_SetPrescaler(st_tune.chosen);
+    if (!st_tune.failed) {
+        uint8_t black[ST_PROBE_PIXELS * 2u] = {0};
+        ST7735_SetAddressWindow(0, 0, ST_PROBE_PIXELS - 1u, 0);
+        ST_WriteData(black, sizeof(black));
+    }
+    XHC_TRACE(TRC_SPI_TUNE, ST7735_SpiDivider(), st_tune.readback);
+    return 1;
+}
+
+/* Nächster Kandidat; keiner mehr schneller als safe -> fertig */
+static uint8_t ST_TuneNext(void)
+{
+    st_tune.br += ST_BR_STEP;
+    st_tune.round = 0;
+    return (st_tune.br >= st_tune.safe) ? ST_TuneDone() : 0;
+}
+
+/**
+ * @brief Ein Messschritt (< 0,5 ms)
+ * @return 1 wenn der Teiler feststeht und eingestellt ist
+ */
+static uint8_t ST_TuneStep(void)
+{
+    uint8_t rd[ST_PROBE_READ];
+
+    if (st_tune.step < 4u) {
+        uint8_t inv = st_tune.step >> 1;
+        if ((st_tune.step++ & 1u) == 0u) {
+            ST_ProbeWrite(inv);
+            ST_ProbeRead(st_tune.ref[inv]);
+            return 0;
+        }
+        ST_ProbeRead(rd);
+        if (memcmp(rd, st_tune.ref[inv], ST_PROBE_READ) != 0) return ST_TuneDone();
+        if (inv == 0u) return 0;
+        st_tune.readback = memcmp(st_tune.ref[0], st_tune.ref[1], ST_PROBE_READ) != 0;
+        if (!st_tune.readback || st_tune.br >= st_tune.safe) return ST_TuneDone();
+        return 0;
+    }
+
+    uint8_t inv = st_tune.round & 1u;
+    ST_SetPrescaler(st_tune.br);
+    ST_ProbeWrite(inv);
+    ST_SetPrescaler(st_tune.safe);
+    ST_ProbeRead(rd);
+
+    if (memcmp(rd, st_tune.ref[inv], ST_PROBE_READ) != 0) {
+        st_tune.failed = 1;
+        if (st_tune.margin) return ST_TuneDone();   // Stufe darunter wackelt: CubeMX-Teiler
+        return ST_TuneNext();
+    }
+    if (++st_tune.round < ST_TUNE_ROUNDS) return 0;
+
+    if (st_tune.margin) {
+        st_tune.chosen = st_tune.br;
+        return ST_TuneDone();
+    }
+    st_tune.margin = 1;
+    return ST_TuneNext();
+}
+
+#endif /* ST7735_SPI_AUTOTUNE */
+
+uint16_t ST7735_SpiDivider(void)
+{
+    // Kodierung wie im BR-Feld von SPI_CR1: Teiler 2^(BR+1)
+    return (uint16_t)(2u << (ST7735_SPI_PORT.Init.BaudRatePrescaler >> 3));
+}
+
+/* ------------------------- Zeitscheiben-Initialisierung ------------------- */
+
+/*
+ * Reset + init_cmds1/2/3 wie gehabt (Format: cmd, n|DELAY, args, [ms]),
+ * aber statt HAL_Delay wird nur ein Wartezeitpunkt gemerkt. ST7735_InitStep()
+ * kehrt sofort zurück, solange die Wartezeit läuft; sonst schickt es die
+ * Kommandos bis zum nächsten Delay-Eintrag (nur wenige Bytes SPI).
+ * So laufen USB-Enumeration und Eingabe-Scan während der ~1 s Panel-Init weiter.
+ */
+typedef enum {
+    ST_BOOT_IDLE = 0,
+    ST_BOOT_RST_LOW,      // RST low halten (5 ms)
+    ST_BOOT_RST_HIGH,     // Panel nach Reset hochlaufen lassen (120 ms)
+    ST_BOOT_CMDS,         // Kommandolisten abarbeiten
+    ST_BOOT_TUNE,         // SPI-Takt einmessen (ST7735_SPI_AUTOTUNE)
+    ST_BOOT_READY
+} st_boot_phase_t;
+
+static struct {
+    st_boot_phase_t phase;
+    uint8_t         list;       // 0..2 = init_cmds1..3
+    uint8_t         remaining;  // Kommandos in aktueller Liste
+    const uint8_t  *p;          // nächstes Kommando
+    uint32_t        wait_from;  // Tick beim Start der Wartezeit
+    uint16_t        wait_ms;
+    uint8_t         tuned;      // SPI-Takt eingemessen, nicht noch einmal
+} st_boot;
+
+static const uint8_t * const st_boot_lists[] = { init_cmds1, init_cmds2, init_cmds3 };
+
+static inline void ST_BootWait(uint16_t ms)
 {
-    CS_HIGH(); RST_HIGH(); HAL_Delay(5);
+    st_boot.wait_from = HAL_GetTick();
+    st_boot.wait_ms   = ms;
+}
 
-    ST_Reset();
-    ST_ExecCmdList(init_cmds1);
-    ST_ExecCmdList(init_cmds2);
-    ST_ExecCmdList(init_cmds3);
+static void ST_BootLoadList(uint8_t list)
+{
+    st_boot.list      = list;
+    st_boot.p         = st_boot_lists[list];
+    st_boot.remaining = *st_boot.p++;
+}
+
+static uint8_t ST_BootFinish(void)
+{
+    ST7735_FB_Init();
+    st_boot.phase = ST_BOOT_READY;
+    return 1;
+}
+
+void ST7735_InitStart(void)
+{
+    CS_HIGH(); RST_HIGH();
+    st_boot.tuned = 0;
+    st_boot.phase = ST_BOOT_RST_LOW;
+    ST_BootWait(5);
+}
+
+/**
+ * @brief Ein Schritt der Panel-Initialisierung, nicht blockierend
+ * @return 1 wenn das Panel bereit ist, sonst 0
+ *
+ * Aus der Hauptschleife aufrufen, bis 1 zurückkommt. Bis dahin darf sonst
+ * niemand auf das Display zugreifen.
+ */
+uint8_t ST7735_InitStep(void)
+{
+    if (st_boot.phase == ST_BOOT_READY) return 1;
+    if (st_boot.phase == ST_BOOT_IDLE)  return 0;
+
+    // HAL_Delay(ms) wartet mindestens ms+1 Ticks -> hier ebenso ">"
+    if ((HAL_GetTick() - st_boot.wait_from) <= st_boot.wait_ms) return 0;
+
+    switch (st_boot.phase) {
+        case ST_BOOT_RST_LOW:
+            RST_LOW();
+            st_boot.phase = ST_BOOT_RST_HIGH;
+            ST_BootWait(5);
+            return 0;
+
+        case ST_BOOT_RST_HIGH:
+            RST_HIGH();
+            st_boot.phase = ST_BOOT_CMDS;
+            ST_BootLoadList(0);
+            ST_BootWait(120);
+            return 0;
+
+        case ST_BOOT_CMDS:
+            for (;;) {
+                while (st_boot.remaining == 0) {
+                    if (st_boot.list + 1u >= (sizeof(st_boot_lists) / sizeof(st_boot_lists[0]))) {
+#if ST7735_SPI_AUTOTUNE
+                        if (!st_boot.tuned) {
+                            st_boot.tuned = 1;
+                            ST_TuneStart();
+                            st_boot.phase = ST_BOOT_TUNE;
+                            ST_BootWait(0);
+                            return 0;
+                        }
+#endif
+                        return ST_BootFinish();
+                    }
+                    ST_BootLoadList(st_boot.list + 1u);
+                }
+
+                const uint8_t *p = st_boot.p;
+                st_boot.remaining--;
+                ST_WriteCommand(*p++);
+
+                uint8_t numArgs = *p++;
+                uint16_t ms = numArgs & DELAY;
+                numArgs &= ~DELAY;
+                if (numArgs) {
+                    ST_WriteData(p, numArgs);
+                    p += numArgs;
+                }
+                if (ms) {
+                    ms = *p++;
+                    if (ms == 255) ms = 500;
+                }
+                st_boot.p = p;
+
+                if (ms) {
+                    ST_BootWait(ms);
+                    return 0;
+                }
+            }
+
+#if ST7735_SPI_AUTOTUNE
+        case ST_BOOT_TUNE:
+            ST_BootWait(0);                     // nächster Schritt frühestens im nächsten Tick
+            if (!ST_TuneStep()) return 0;
+            if (st_tune.failed) {               // Init beim neuen Takt wiederholen
+                st_boot.phase = ST_BOOT_RST_LOW;
+                ST_BootWait(5);
+                return 0;
+            }
+            return ST_BootFinish();
+#endif
+
+        default:
+            return 0;
+    }
+}
+
+uint8_t ST7735_IsReady(void)
+{
+    return st_boot.phase == ST_BOOT_READY;
+}
+
+/* Blockierende Variante (wie bisher): Sequenz am Stück + Bild löschen */
+void ST7735_Init(void)
+{
+    ST7735_InitStart();
+    while (!ST7735_InitStep()) {
+        xhc_wdg_feed();     // Sequenz dauert ~1 s, mit Wiederholung nach dem Einmessen ~2 s
+    }
 
     /* optional clear */
     uint16_t bg = ST7735_BLACK;
@@ -208,33 +575,120 @@ void ST7735_Init(void)
 void ST7735_DrawPixel(uint16_t x, uint16_t y, uint16_t color)
 {
     if (x >= ST7735_WIDTH || y >= ST7735_HEIGHT) return;
+#if ST7735_USE_SHADOW_FB
+    ST7735_FB_FillRect(x, y, 1, 1, color);
+    return;
+#endif
     ST7735_SetAddressWindow(x, y, x, y);
     uint8_t d[2] = { (uint8_t)(color >> 8), (uint8_t)(color & 0xFF) };
     ST_WriteData(d, 2);
 }
 
+/* ------------------------- Glyph-Expansion (LUT) ------------------------- */
+/*
+ * Nibble -> 4 fertige RGB565-Pixel (Big Endian, Vorder-/Hintergrund).
+ * 16 x 8 Byte RAM; wird nur neu gebaut, wenn sich das Farbpaar ändert.
+ * Pro Schleifendurchlauf werden so 4 Pixel ohne Sprung kopiert, statt
+ * jedes Bit einzeln zu testen.
+ */
+static uint16_t st_glyph_lut[16][4];
+static uint16_t st_lut_fg = 0, st_lut_bg = 0;
+static uint8_t  st_lut_valid = 0;
+
+static inline uint16_t ST_Swap16(uint16_t c) { return (uint16_t)((c >> 8) | (c << 8)); }
+
+static void ST_GlyphLUT(uint16_t color, uint16_t bgcolor)
+{
+    if (st_lut_valid && st_lut_fg == color && st_lut_bg == bgcolor) return;
+
+    uint16_t fg = ST_Swap16(color), bg = ST_Swap16(bgcolor);
+    for (uint8_t n = 0; n < 16; n++) {
+        for (uint8_t k = 0; k < 4; k++) {
+            st_glyph_lut[n][k] = (n & (0x8u >> k)) ? fg : bg;
+        }
+    }
+    st_lut_fg = color;
+    st_lut_bg = bgcolor;
+    st_lut_valid = 1;
+}
+
+/* width Pixel aus bits (MSB = linkes Pixel) nach d expandieren; liefert Zeiger dahinter */
+static inline uint8_t *ST_ExpandBits(uint8_t *d, uint32_t bits, uint16_t width)
+{
+    while (width >= 4) {
+        memcpy(d, st_glyph_lut[bits >> 28], 8);
+        d += 8;
+        bits <<= 4;
+        width -= 4;
+    }
+    if (width) {
+        memcpy(d, st_glyph_lut[bits >> 28], width * 2u);
+        d += width * 2u;
+    }
+    return d;
+}
+
+/* Bitstrom-Leser für gepackte Glyphen (Zeilen liegen lückenlos hintereinander) */
+typedef struct {
+    const uint8_t *p;       // NULL -> liefert nur Nullen (fehlende Glyphe)
+    uint32_t acc;           // MSB-ausgerichtet
+    uint8_t  n;             // gültige Bits in acc
+} st_bits_t;
+
+/* Nächste w (<= 24) Bits, MSB-ausgerichtet; Bits unterhalb von w sind undefiniert */
+static inline uint32_t ST_BitsTake(st_bits_t *br, uint8_t w)
+{
+    while (br->n < w) {
+        br->acc |= (uint32_t)(br->p ? *br->p++ : 0u) << (24u - br->n);
+        br->n += 8u;
+    }
+    uint32_t v = br->acc;
+    br->acc <<= w;
+    br->n -= w;
+    return v;
+}
+
+/*
+ * Glyph zeilenweise in linebuf / st_color_burst_buf expandieren und per DMA
+ * rausschicken (ein Adressfenster je Zeichen, Ping-Pong wie ST7735_DrawRLE).
+ * Gepackte Fonts werden direkt aus dem Bitstrom gelesen.
+ */
 static void ST_WriteChar(uint16_t x, uint16_t y, char ch,
                          FontDef font, uint16_t color, uint16_t bgcolor)
 {
-    uint32_t i, b, j;
-
-    ST7735_SetAddressWindow(x, y, x + font.width - 1, y + font.height - 1);
+#if ST7735_USE_SHADOW_FB
+    ST7735_FB_DrawChar(x, y, ch, font, color, bgcolor);
+    return;
+#endif
 
-    ST_BeginData();
-    for (i = 0; i < font.height; i++) {
-        b = font.data[(ch - 32) * font.height + i];
-        for (j = 0; j < font.width; j++) {
-            uint16_t c = ((b << j) & 0x8000) ? color : bgcolor;
-            uint8_t d[2] = { (uint8_t)(c >> 8), (uint8_t)(c & 0xFF) };
-            HAL_SPI_Transmit(&ST7735_SPI_PORT, d, 2, HAL_MAX_DELAY);
+    uint8_t *bufs[2] = { linebuf, st_color_burst_buf };
+    uint8_t  cur = 0;
+    uint16_t fill = 0;                                  // Bytes im aktuellen Puffer
+    uint16_t row_bytes = (uint16_t)(font.width * 2u);
+    st_bits_t br = { font.data ? NULL : Font_PackedGlyph(&font, ch), 0, 0 };
+
+    ST_GlyphLUT(color, bgcolor);
+    ST7735_StreamBegin(x, y, font.width, font.height);
+    for (uint16_t i = 0; i < font.height; i++) {
+        if ((uint16_t)(fill + row_bytes) > sizeof(st_color_burst_buf)) {
+            ST7735_StreamData(bufs[cur], fill);
+            cur ^= 1u;
+            fill = 0;
         }
+        uint32_t bits = font.data
+                      ? (uint32_t)font.data[(ch - 32) * font.height + i] << 16
+                      : ST_BitsTake(&br, font.width);
+        ST_ExpandBits(&bufs[cur][fill], bits, font.width);
+        fill += row_bytes;
     }
-    ST_EndData();
+    if (fill) ST7735_StreamData(bufs[cur], fill);
+    ST7735_StreamEnd();
 }
 
 void ST7735_WriteString(uint16_t x, uint16_t y, const char* s,
                         FontDef font, uint16_t color, uint16_t bgcolor)
 {
+    XHC_PROF_BEGIN(PROF_ST_STRING);
     while (*s) {
         if (x + font.width >= ST7735_WIDTH) {
             x = 0;
@@ -246,16 +700,214 @@ void ST7735_WriteString(uint16_t x, uint16_t y, const char* s,
         x += font.width;
         s++;
     }
+    XHC_PROF_END(PROF_ST_STRING);
 }
 
 
 
 /* Blocking Fill (klein & simpel) – bleibt als Referenz */
+/* ------------------------------ GFX-Fonts ------------------------------ */
+/*
+ * Jedes Zeichen wird als Zelle gezeichnet: Breite xAdvance (plus Überhang
+ * des Glyphs), Höhe = Ober-/Unterlänge des ganzen Fonts. Zelle inkl.
+ * Hintergrund wird zeilenweise über die Nibble-LUT expandiert und in EINEM
+ * Adressfenster per DMA gestreamt. Damit übermalt ein neuer String den alten
+ * vollständig, ein Lösch-Cache ist nicht nötig (kürzere Strings selbst
+ * auffüllen, wie bei FontDef).
+ */
+
+/* Baseline liegt bei y + 55 % von yAdvance (wie bisher: y = Oberkante) */
+#define ST_GFX_BASELINE(f)   ((int16_t)(((f)->yAdvance * 55) / 100))
+
+static const GFXfont *st_gfx_font = NULL;
+static int8_t st_gfx_top = 0, st_gfx_bottom = 0;    // Zeilenbox relativ zur Baseline
+
+static void ST_GfxLineBox(const GFXfont *f)
+{
+    if (f == st_gfx_font) return;
+
+    const GFXglyph *g = (const GFXglyph *)f->glyph;
+    int8_t top = 0, bottom = 0;
+    for (uint16_t c = f->first; c <= f->last; c++, g++) {
+        if (g->height == 0) continue;
+        if (g->yOffset < top) top = g->yOffset;
+        if (g->yOffset + g->height > bottom) bottom = (int8_t)(g->yOffset + g->height);
+    }
+    st_gfx_font = f;
+    st_gfx_top = top;
+    st_gfx_bottom = bottom;
+}
+
+/* Pixel [c0, c0+n) einer Zeile ausgeben, begrenzt auf das sichtbare Intervall [vl, vr) */
+static inline uint8_t *ST_EmitClipped(uint8_t *d, uint32_t bits, int16_t c0, int16_t n,
+                                      int16_t vl, int16_t vr)
+{
+    int16_t lo = (c0 > vl) ? c0 : vl;
+    int16_t hi = (c0 + n < vr) ? (int16_t)(c0 + n) : vr;
+    if (lo >= hi) return d;
+    uint16_t skip = (uint16_t)(lo - c0);
+    if (skip) bits = (skip < 32u) ? (bits << skip) : 0;
+    return ST_ExpandBits(d, bits, (uint16_t)(hi - lo));
+}
+
+/**
+ * @brief Zeichnet ein Zeichen eines GFX-Fonts (deckend, inkl. Hintergrund)
+ * @param x Stiftposition (linker Rand der Zelle)
+ * @param y Oberkante der Textzeile
+ */
+void ST7735_WriteChar_GFX(uint16_t x, uint16_t y, char c, const GFXfont *gfxFont,
+                          uint16_t color, uint16_t bgcolor)
+{
+    if (!gfxFont) return;
+    if (((uint8_t)c < gfxFont->first) || ((uint8_t)c > gfxFont->last)) return;
+
+    const GFXglyph *glyph = &((const GFXglyph *)gfxFont->glyph)[(uint8_t)c - gfxFont->first];
+    ST_GfxLineBox(gfxFont);
+
+    /* Zelle relativ zu (x, Baseline) */
+    int16_t gx0 = glyph->xOffset, gx1 = (int16_t)(glyph->xOffset + glyph->width);
+    int16_t cx0 = (gx0 < 0) ? gx0 : 0;
+    int16_t cx1 = (gx1 > glyph->xAdvance) ? gx1 : glyph->xAdvance;
+    int16_t base = (int16_t)(y + ST_GFX_BASELINE(gfxFont));
+
+    /* Auf den Bildschirm begrenzen */
+    int16_t vl = (int16_t)((cx0 > -(int16_t)x) ? cx0 : -(int16_t)x);
+    int16_t vr = (int16_t)((cx1 < (int16_t)(ST7735_WIDTH - x)) ? cx1 : (int16_t)(ST7735_WIDTH - x));
+    int16_t ry0 = (int16_t)(base + st_gfx_top), ry1 = (int16_t)(base + st_gfx_bottom);
+    if (ry0 < 0) ry0 = 0;
+    if (ry1 > ST7735_HEIGHT) ry1 = ST7735_HEIGHT;
+    if (vl >= vr || ry0 >= ry1) return;
+
+    st_bits_t br = { gfxFont->bitmap + glyph->bitmapOffset, 0, 0 };
+    int16_t gy0 = (int16_t)(base + glyph->yOffset);
+
+#if ST7735_USE_SHADOW_FB
+    ST7735_FB_FillRect((uint16_t)(x + vl), (uint16_t)ry0, (uint16_t)(vr - vl),
+                       (uint16_t)(ry1 - ry0), bgcolor);
+    for (int16_t r = 0; r < glyph->height; r++) {
+        int16_t py = (int16_t)(gy0 + r);
+        for (int16_t cc = 0; cc < glyph->width; cc++) {
+            uint32_t bit = ST_BitsTake(&br, 1) & 0x80000000u;
+            int16_t px = (int16_t)(gx0 + cc);
+            if (bit && py >= ry0 && py < ry1 && px >= vl && px < vr) {
+                ST7735_FB_FillRect((uint16_t)(x + px), (uint16_t)py, 1, 1, color);
+            }
+        }
+    }
+    return;
+#endif
+
+    uint16_t row_bytes = (uint16_t)((vr - vl) * 2);
+    if (row_bytes > sizeof(st_color_burst_buf)) return;    // breiter als 128 px: gibt es nicht
+
+    uint8_t *bufs[2] = { linebuf, st_color_burst_buf };
+    uint8_t  cur = 0;
+    uint16_t fill = 0;
+
+    ST_GlyphLUT(color, bgcolor);
+    ST7735_StreamBegin((uint16_t)(x + vl), (uint16_t)ry0, (uint16_t)(vr - vl), (uint16_t)(ry1 - ry0));
+
+    for (int16_t py = (int16_t)(base + st_gfx_top); py < ry1; py++) {
+        int16_t gr = (int16_t)(py - gy0);
+        uint8_t in_glyph = (gr >= 0 && gr < glyph->height);
+        if (py < ry0) {
+            // oberhalb des Bildschirms: Bits des Glyphs trotzdem verbrauchen
+            for (int16_t cc = 0; in_glyph && cc < glyph->width; cc += 16) {
+                ST_BitsTake(&br, (uint8_t)((glyph->width - cc > 16) ? 16 : glyph->width - cc));
+            }
+            continue;
+        }
+
+        if ((uint16_t)(fill + row_bytes) > sizeof(st_color_burst_buf)) {
+            ST7735_StreamData(bufs[cur], fill);
+            cur ^= 1u;
+            fill = 0;
+        }
+        uint8_t *d = &bufs[cur][fill];
+
+        if (!in_glyph) {
+            d = ST_EmitClipped(d, 0, cx0, (int16_t)(cx1 - cx0), vl, vr);
+        } else {
+            d = ST_EmitClipped(d, 0, cx0, (int16_t)(gx0 - cx0), vl, vr);
+            for (int16_t cc = 0; cc < glyph->width; cc += 16) {
+                int16_t n = (int16_t)((glyph->width - cc > 16) ? 16 : glyph->width - cc);
+                d = ST_EmitClipped(d, ST_BitsTake(&br, (uint8_t)n), (int16_t)(gx0 + cc), n, vl, vr);
+            }
+            d = ST_EmitClipped(d, 0, gx1, (int16_t)(cx1 - gx1), vl, vr);
+        }
+        fill += row_bytes;
+    }
+    if (fill) ST7735_StreamData(bufs[cur], fill);
+    ST7735_StreamEnd();
+}
+
+/**
+ * @brief Schreibt String mit GFX Font, '\n' beginnt eine neue Zeile
+ */
+void ST7735_WriteString_GFX(uint16_t x, uint16_t y, const char* str,
+                            const GFXfont *gfxFont, uint16_t color, uint16_t bgcolor)
+{
+    if (!gfxFont || !str) return;
+
+    XHC_PROF_BEGIN(PROF_ST_STRING);
+    const GFXglyph *glyph_array = (const GFXglyph *)gfxFont->glyph;
+    uint16_t cursor_x = x;
+    uint16_t cursor_y = y;
+
+    while (*str) {
+        uint8_t c = (uint8_t)*str++;
+
+        if (c == '\n') {
+            cursor_x = x;
+            cursor_y += gfxFont->yAdvance;
+            continue;
+        }
+        if ((c < gfxFont->first) || (c > gfxFont->last)) continue;
+
+        if (cursor_x >= ST7735_WIDTH) {
+            cursor_x = x;
+            cursor_y += gfxFont->yAdvance;
+            if (cursor_y >= ST7735_HEIGHT) break;
+        }
+
+        ST7735_WriteChar_GFX(cursor_x, cursor_y, (char)c, gfxFont, color, bgcolor);
+        cursor_x += glyph_array[c - gfxFont->first].xAdvance;
+    }
+    XHC_PROF_END(PROF_ST_STRING);
+}
+
+/**
+ * @brief Berechnet String-Breite mit GFX Font
+ * @return Breite in Pixeln (Summe der xAdvance)
+ */
+uint16_t ST7735_GetStringWidth_GFX(const char* str, const GFXfont *gfxFont)
+{
+    if (!gfxFont || !str) return 0;
+
+    uint16_t width = 0;
+    const GFXglyph *glyph_array = (const GFXglyph *)gfxFont->glyph;
+
+    while (*str) {
+        uint8_t c = (uint8_t)*str++;
+        if ((c >= gfxFont->first) && (c <= gfxFont->last)) {
+            width += glyph_array[c - gfxFont->first].xAdvance;
+        }
+    }
+    return width;
+}
+
 void ST7735_FillRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
 {
     if (x >= ST7735_WIDTH || y >= ST7735_HEIGHT) return;
     if ((x + w) > ST7735_WIDTH)  w = ST7735_WIDTH - x;
     if ((y + h) > ST7735_HEIGHT) h = ST7735_HEIGHT - y;
+    XHC_PROF_BEGIN(PROF_ST_FILL);
+
+#if ST7735_USE_SHADOW_FB
+    ST7735_FB_FillRect(x, y, w, h, color);
+    XHC_PROF_END(PROF_ST_FILL);
+    return;
+#endif
 
     ST7735_SetAddressWindow(x, y, x + w - 1, y + h - 1);
 
@@ -265,9 +917,12 @@ void ST7735_FillRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16
             linebuf[2*i] = hi; linebuf[2*i+1] = lo;
         }
         ST_BeginData();
+        XHC_TELEM_ADD(spi_bytes, w * 2u);
         HAL_SPI_Transmit(&ST7735_SPI_PORT, linebuf, (uint16_t)(w*2), HAL_MAX_DELAY);
         ST_EndData();
+        ST_Yield();   // blockierend, also nach jeder Zeile
     }
+    XHC_PROF_END(PROF_ST_FILL);
 }
 
 /* DMA-Fast: Address Window EINMAL setzen, dann streamen (CS dauerhaft LOW) */
@@ -276,6 +931,13 @@ void ST7735_FillRectangleFast(uint16_t x, uint16_t y, uint16_t w, uint16_t h, ui
     if (x >= ST7735_WIDTH || y >= ST7735_HEIGHT) return;
     if ((x + w) > ST7735_WIDTH)  w = ST7735_WIDTH - x;
     if ((y + h) > ST7735_HEIGHT) h = ST7735_HEIGHT - y;
+    XHC_PROF_BEGIN(PROF_ST_FILL);
+
+#if ST7735_USE_SHADOW_FB
+    ST7735_FB_FillRect(x, y, w, h, color);
+    XHC_PROF_END(PROF_ST_FILL);
+    return;
+#endif
 
     ST7735_SetAddressWindow(x, y, x + w - 1, y + h - 1);
 
@@ -291,6 +953,7 @@ void ST7735_FillRectangleFast(uint16_t x, uint16_t y, uint16_t w, uint16_t h, ui
         ST_WaitDMA();
     }
     ST_EndData();   /* CS HIGH */
+    XHC_PROF_END(PROF_ST_FILL);
 }
 
 // interne Helfer: ohne Select/Unselect (für gebündelte Transfers)
@@ -300,6 +963,11 @@ static void ST7735_FillRectDMA_NoSelect(uint16_t x, uint16_t y, uint16_t w, uint
     if((x + w - 1) >= ST7735_WIDTH)  w = ST7735_WIDTH  - x;
     if((y + h - 1) >= ST7735_HEIGHT) h = ST7735_HEIGHT - y;
 
+#if ST7735_USE_SHADOW_FB
+    ST7735_FB_FillRect(x, y, w, h, color);
+    return;
+#endif
+
     ST7735_SetAddressWindow(x, y, x + w - 1, y + h - 1);
 
     static uint16_t line_buf[ST7735_WIDTH];              // 1 Zeile
@@ -308,6 +976,8 @@ static void ST7735_FillRectDMA_NoSelect(uint16_t x, uint16_t y, uint16_t w, uint
     HAL_GPIO_WritePin(ST77_DC_GPIO, ST77_DC_PIN, GPIO_PIN_SET);
 
     for (uint16_t row = 0; row < h; ++row) {
+        XHC_TELEM_ADD(spi_bytes, w * 2u);
+        XHC_TRACE_DMA_START(w * 2u);
         HAL_SPI_Transmit_DMA(&ST7735_SPI_PORT, (uint8_t*)line_buf, w * 2);
         HAL_DMA_PollForTransfer(ST7735_SPI_PORT.hdmatx, HAL_DMA_FULL_TRANSFER, HAL_MAX_DELAY);
     }
@@ -341,6 +1011,25 @@ void ST7735_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint
     if ((x + w) > ST7735_WIDTH)  w = ST7735_WIDTH - x;
     if ((y + h) > ST7735_HEIGHT) h = ST7735_HEIGHT - y;
 
+    XHC_PROF_BEGIN(PROF_ST_IMAGE);
+
+#if ST7735_USE_SHADOW_FB
+    // Läufe gleicher Farbe je Zeile; Farben außerhalb der Palette werden zur
+    // Akzentfarbe der Zeile (st7735_fb.h), für Fotos ist der Modus nicht gedacht
+    for (uint16_t row = 0; row < h; ++row) {
+        const uint16_t *src = data + (uint32_t)row * w;
+        uint16_t i = 0;
+        while (i < w) {
+            uint16_t n = 1;
+            while (i + n < w && src[i + n] == src[i]) n++;
+            ST7735_FB_FillRect(x + i, y + row, n, 1, src[i]);
+            i += n;
+        }
+    }
+    XHC_PROF_END(PROF_ST_IMAGE);
+    return;
+#endif
+
     ST7735_SetAddressWindow(x, y, x + w - 1, y + h - 1);
 
     ST_BeginData();
@@ -355,6 +1044,69 @@ void ST7735_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint
         ST_WaitDMA();
     }
     ST_EndData();
+    XHC_PROF_END(PROF_ST_IMAGE);
+}
+
+/**
+ * @brief Zeichnet ein lauflängenkodiertes Bild mit 4-Farben-Palette
+ * @param rle     Byte = (Palettenindex << 6) | (Lauflänge - 1), Läufe gehen über Zeilenenden
+ * @param rle_len Anzahl Bytes in rle
+ * @param palette 4 Farben RGB565
+ *
+ * Ein Adressfenster für das ganze Bild; dekodiert wird abwechselnd in
+ * linebuf und st_color_burst_buf, während der jeweils andere Puffer per
+ * DMA rausgeht. Erzeugt werden die Daten von Tools/gen_ui_background.py.
+ */
+void ST7735_DrawRLE(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                    const uint8_t *rle, uint16_t rle_len, const uint16_t *palette)
+{
+    if (x >= ST7735_WIDTH || y >= ST7735_HEIGHT || w == 0 || h == 0) return;
+    if ((x + w) > ST7735_WIDTH || (y + h) > ST7735_HEIGHT) return;   // Läufe sind an w gebunden
+    XHC_PROF_BEGIN(PROF_ST_IMAGE);
+
+#if ST7735_USE_SHADOW_FB
+    uint16_t px = 0, py = 0;
+    for (uint16_t k = 0; k < rle_len && py < h; k++) {
+        uint16_t color = palette[rle[k] >> 6];
+        uint16_t n = (uint16_t)((rle[k] & 0x3Fu) + 1u);
+        while (n && py < h) {
+            uint16_t seg = (uint16_t)(w - px);
+            if (seg > n) seg = n;
+            ST7735_FB_FillRect(x + px, y + py, seg, 1, color);
+            n -= seg; px += seg;
+            if (px == w) { px = 0; py++; }
+        }
+    }
+    XHC_PROF_END(PROF_ST_IMAGE);
+    return;
+#endif
+
+    uint8_t *bufs[2] = { linebuf, st_color_burst_buf };
+    uint8_t  cur = 0;
+    uint16_t fill = 0;
+    uint32_t left = (uint32_t)w * h;
+
+    ST7735_StreamBegin(x, y, w, h);
+    for (uint16_t k = 0; k < rle_len && left; k++) {
+        uint16_t c = palette[rle[k] >> 6];
+        uint8_t  hi = (uint8_t)(c >> 8), lo = (uint8_t)(c & 0xFF);
+        uint16_t n = (uint16_t)((rle[k] & 0x3Fu) + 1u);
+        if (n > left) n = (uint16_t)left;
+        left -= n;
+
+        while (n--) {
+            bufs[cur][2*fill]   = hi;
+            bufs[cur][2*fill+1] = lo;
+            if (++fill == ST_COLOR_BURST_PIXELS) {
+                ST7735_StreamData(bufs[cur], (uint16_t)(fill * 2));
+                cur ^= 1u;
+                fill = 0;   // StreamData hat auf den Vorgänger gewartet -> bufs[cur] ist frei
+            }
+        }
+    }
+    if (fill) ST7735_StreamData(bufs[cur], (uint16_t)(fill * 2));
+    ST7735_StreamEnd();
+    XHC_PROF_END(PROF_ST_IMAGE);
 }
 
 void ST7735_InvertColors(bool invert)
@@ -362,6 +1114,17 @@ void ST7735_InvertColors(bool invert)
     ST_WriteCommand(invert ? ST7735_INVON : ST7735_INVOFF);
 }
 
+/*
+ * Idle-Mode des Controllers: nur noch 8 Farben (MSB je Kanal), Frame-Rate
+ * laut FRMCTR2, deutlich weniger Strom im Panel-Treiber. Die UI-Farben
+ * (schwarz/weiß/blau/rot/grün) bleiben dabei unverändert sichtbar.
+ * Das Modul hat keinen schaltbaren Backlight-Pin, das ist das "Dimmen".
+ */
+void ST7735_SetIdleMode(bool idle)
+{
+    ST_WriteCommand(idle ? ST7735_IDMON : ST7735_IDMOFF);
+}
+
 void ST7735_SetGamma(GammaDef gamma)
 {
     ST_WriteCommand(ST7735_GAMSET);
@@ -386,9 +1149,54 @@ void ST7735_DrawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
     ST7735_FillRectangle(x + w - thickness, y, thickness, h, color);
 }
 
+/* Zuletzt gezeichneter Zustand je Balken-Widget (Schlüssel: x/y).
+   Damit muss bei einer Wertänderung nur noch die Differenz gezeichnet werden. */
+#define ST_BAR_SLOTS 4
+typedef struct {
+    uint16_t x, y, w, h;
+    uint16_t col_left, col_right, col_bg, col_mid, gap;
+    uint16_t lenL, lenR;      // aktuell sichtbare Balkenlänge links / rechts
+    uint8_t  valid;
+} st_bar_state_t;
+
+static st_bar_state_t st_bar_state[ST_BAR_SLOTS];
+static uint8_t st_bar_next_slot = 0;
+
+static st_bar_state_t *ST_BarSlot(uint16_t x, uint16_t y)
+{
+    for (uint8_t i = 0; i < ST_BAR_SLOTS; i++) {
+        if (st_bar_state[i].valid && st_bar_state[i].x == x && st_bar_state[i].y == y)
+            return &st_bar_state[i];
+    }
+    for (uint8_t i = 0; i < ST_BAR_SLOTS; i++) {
+        if (!st_bar_state[i].valid) return &st_bar_state[i];
+    }
+    // alle belegt -> reihum ersetzen
+    st_bar_state_t *s = &st_bar_state[st_bar_next_slot];
+    st_bar_next_slot = (uint8_t)((st_bar_next_slot + 1) % ST_BAR_SLOTS);
+    s->valid = 0;
+    return s;
+}
+
+/**
+ * @brief Verwirft den gemerkten Balken-Zustand
+ *
+ * Muss aufgerufen werden, wenn der Bereich der Balken anderweitig
+ * übermalt wurde (z.B. kompletter Bildschirmaufbau), damit der nächste
+ * Aufruf von ST7735_barProgressRange wieder vollständig zeichnet.
+ */
+void ST7735_barProgressInvalidate(void)
+{
+    for (uint8_t i = 0; i < ST_BAR_SLOTS; i++) st_bar_state[i].valid = 0;
+}
+
 // v: aktueller Wert in Prozent
 // min_p, max_p: sichtbarer Bereich (z.B. 0..200, 10..150, ...)
 // Farben frei wählbar; "gap" = optionaler Abstand (0/1) zwischen Mittellinie und Balken
+//
+// Beim ersten Aufruf (bzw. nach Geometrie-/Farbwechsel) wird das ganze Widget
+// gezeichnet. Danach werden nur noch die Spalten übertragen, um die der Balken
+// gewachsen oder geschrumpft ist - höchstens ein Fill je Seite.
 void ST7735_barProgressRange(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                              int v, int min_p, int max_p,
                              uint16_t col_left, uint16_t col_right,
@@ -396,6 +1204,7 @@ void ST7735_barProgressRange(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                              uint16_t gap)
 {
     if (w < 5 || h < 3) return;
+    XHC_PROF_BEGIN(PROF_ST_BAR);
 
     // 1) Clamp Bereich und Wert
     if (min_p > 100) min_p = 100;        // links existiert nur bis 100
@@ -406,39 +1215,72 @@ void ST7735_barProgressRange(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
     if (v < min_p) v = min_p;
     if (v > max_p) v = max_p;
 
-    // 2) Hintergrund & Mittellinie
-    ST7735_FillRectangle(x, y, w, h, col_bg);
     uint16_t midx = x + (w / 2);
-    ST7735_FillRectangle(midx, y + 1, 1, h - 2, col_mid);
 
-    // 3) verfügbare Breite je Seite (ggf. kleiner "gap" neben der Mittellinie)
+    // 2) verfügbare Breite je Seite (ggf. kleiner "gap" neben der Mittellinie)
     uint16_t right_avail = (uint16_t)(w - (w / 2) - 1);
     uint16_t left_avail  = (uint16_t)(w / 2);
     if (right_avail > gap) right_avail -= gap;
     if (left_avail  > gap) left_avail  -= gap;
 
-    // 4) Balkenlängen berechnen (mit Rundung)
+    // 3) Balkenlängen berechnen (mit Rundung)
     // Links: mappe 100..min_p  → 0..left_avail (größerer Len je näher an min_p)
+    uint16_t lenL = 0, lenR = 0;
     if (v < 100 && min_p < 100 && left_avail > 0) {
         uint32_t spanL = (uint32_t)(100 - min_p);         // z.B. 90 für 10..100
         if (spanL == 0) spanL = 1;
-        uint32_t lenL = ((uint32_t)(100 - v) * left_avail + (spanL/2)) / spanL;
-        if (lenL > 0) {
-            uint16_t start_x = (uint16_t)(midx - gap - lenL);
-            ST7735_FillRectangle(start_x, y + 1, (uint16_t)lenL, h - 2, col_left);
-        }
+        lenL = (uint16_t)(((uint32_t)(100 - v) * left_avail + (spanL/2)) / spanL);
     }
 
     // Rechts: mappe 100..max_p → 0..right_avail
     if (v > 100 && max_p > 100 && right_avail > 0) {
         uint32_t spanR = (uint32_t)(max_p - 100);         // z.B. 50 für 100..150
         if (spanR == 0) spanR = 1;
-        uint32_t lenR = ((uint32_t)(v - 100) * right_avail + (spanR/2)) / spanR;
-        if (lenR > 0) {
-            uint16_t start_x = (uint16_t)(midx + 1 + gap);
-            ST7735_FillRectangle(start_x, y + 1, (uint16_t)lenR, h - 2, col_right);
-        }
+        lenR = (uint16_t)(((uint32_t)(v - 100) * right_avail + (spanR/2)) / spanR);
     }
-}
 
+    uint16_t left_end    = (uint16_t)(midx - gap);       // exklusiv
+    uint16_t right_start = (uint16_t)(midx + 1 + gap);
+
+    st_bar_state_t *s = ST_BarSlot(x, y);
+    uint8_t same = s->valid &&
+                   s->w == w && s->h == h && s->gap == gap &&
+                   s->col_left == col_left && s->col_right == col_right &&
+                   s->col_bg == col_bg && s->col_mid == col_mid;
+
+    if (!same) {
+        // 4a) Vollständig: Hintergrund, Mittellinie, Balken
+        ST7735_FillRectangle(x, y, w, h, col_bg);
+        ST7735_FillRectangle(midx, y + 1, 1, h - 2, col_mid);
+        if (lenL > 0)
+            ST7735_FillRectangle((uint16_t)(left_end - lenL), y + 1, lenL, h - 2, col_left);
+        if (lenR > 0)
+            ST7735_FillRectangle(right_start, y + 1, lenR, h - 2, col_right);
+
+        s->x = x; s->y = y; s->w = w; s->h = h; s->gap = gap;
+        s->col_left = col_left; s->col_right = col_right;
+        s->col_bg = col_bg; s->col_mid = col_mid;
+        s->valid = 1;
+    } else {
+        // 4b) Inkrementell: nur die Differenzspalten.
+        // Links zuerst, damit beim Wechsel über 100 % erst der alte Balken
+        // verschwindet und dann der neue wächst.
+        if (lenL > s->lenL)
+            ST7735_FillRectangle((uint16_t)(left_end - lenL), y + 1,
+                                 (uint16_t)(lenL - s->lenL), h - 2, col_left);
+        else if (lenL < s->lenL)
+            ST7735_FillRectangle((uint16_t)(left_end - s->lenL), y + 1,
+                                 (uint16_t)(s->lenL - lenL), h - 2, col_bg);
+
+        if (lenR > s->lenR)
+            ST7735_FillRectangle((uint16_t)(right_start + s->lenR), y + 1,
+                                 (uint16_t)(lenR - s->lenR), h - 2, col_right);
+        else if (lenR < s->lenR)
+            ST7735_FillRectangle((uint16_t)(right_start + lenR), y + 1,
+                                 (uint16_t)(s->lenR - lenR), h - 2, col_bg);
+    }
 
+    s->lenL = lenL;
+    s->lenR = lenR;
+    XHC_PROF_END(PROF_ST_BAR);
+}
@@ -25,6 +25,14 @@ extern SPI_HandleTypeDef ST7735_SPI_PORT;
 #define ST77_RST_GPIO  LCD_RST_GPIO_Port
 #define ST77_RST_PIN   LCD_RST_Pin
 
+// SCK und Datenleitung für das Rücklesen (ST7735_SPI_AUTOTUNE). Auf dieser
+// Platine ist kein MISO verdrahtet, gelesen wird über SDA (1-Line); mit
+// eigener SDO-Leitung hier deren Pin eintragen.
+#define ST77_SCK_GPIO  GPIOA
+#define ST77_SCK_PIN   GPIO_PIN_5
+#define ST77_SDA_GPIO  GPIOA
+#define ST77_SDA_PIN   GPIO_PIN_7
+
 // Alias-Namen, die st7735.c erwartet:
 #define ST7735_CS_GPIO_Port   ST77_CS_GPIO
 #define ST7735_CS_Pin         ST77_CS_PIN
@@ -183,6 +191,24 @@ extern SPI_HandleTypeDef ST7735_SPI_PORT;
 
 /****************************/
 
+/* 1 = alle Zeichenfunktionen schreiben in den 2bpp-Schattenspeicher (st7735_fb.c),
+       ST7735_FB_Flush() muss dann zyklisch aus der Hauptschleife laufen.
+   0 = direktes Zeichnen wie bisher */
+#ifndef ST7735_USE_SHADOW_FB
+#define ST7735_USE_SHADOW_FB 0
+#endif
+
+/* 1 = SPI-Takt beim Boot einmessen (ST_TuneStep in st7735_dma.c): nach den
+       Init-Listen wird ein Testmuster bei /2, /4, ... geschrieben und per
+       RAMRD beim CubeMX-Takt zurückgelesen. Betrieben wird eine Stufe
+       langsamer als der schnellste fehlerfreie Teiler. Ohne Rückkanal
+       (Modul liest SDA nicht zurück) bleibt der CubeMX-Teiler.
+       Vollbild 160x128: /16 ~73 ms, /8 ~36 ms, /4 ~18 ms.
+   0 = fester Teiler aus MX_SPI1_Init */
+#ifndef ST7735_SPI_AUTOTUNE
+#define ST7735_SPI_AUTOTUNE 1
+#endif
+
 #define ST7735_NOP     0x00
 #define ST7735_SWRESET 0x01
 #define ST7735_RDDID   0x04
@@ -206,6 +232,8 @@ extern SPI_HandleTypeDef ST7735_SPI_PORT;
 #define ST7735_PTLAR   0x30
 #define ST7735_COLMOD  0x3A
 #define ST7735_MADCTL  0x36
+#define ST7735_IDMOFF  0x38
+#define ST7735_IDMON   0x39
 
 #define ST7735_FRMCTR1 0xB1
 #define ST7735_FRMCTR2 0xB2
@@ -256,14 +284,28 @@ extern "C" {
 void ST7735_Unselect();
 
 void ST7735_Init(void);
+// Nicht blockierende Init: InitStart() einmal, dann InitStep() zyklisch bis 1
+void ST7735_InitStart(void);
+uint8_t ST7735_InitStep(void);
+uint8_t ST7735_IsReady(void);
+// Aktueller SPI-Teiler (2..256), nach der Init ggf. eingemessen
+uint16_t ST7735_SpiDivider(void);
 void ST7735_DrawPixel(uint16_t x, uint16_t y, uint16_t color);
 void ST7735_WriteString(uint16_t x, uint16_t y, const char* str, FontDef font, uint16_t color, uint16_t bgcolor);
+void ST7735_WriteChar_GFX(uint16_t x, uint16_t y, char c, const GFXfont *gfxFont,
+                          uint16_t color, uint16_t bgcolor);
+void ST7735_WriteString_GFX(uint16_t x, uint16_t y, const char* str,
+                            const GFXfont *gfxFont, uint16_t color, uint16_t bgcolor);
+uint16_t ST7735_GetStringWidth_GFX(const char* str, const GFXfont *gfxFont);
 void ST7735_FillRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 void ST7735_FillRectangleFast(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 void ST7735_FillScreen(uint16_t color);
 void ST7735_FillScreenFast(uint16_t color);
 void ST7735_DrawImage(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t* data);
+void ST7735_DrawRLE(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                    const uint8_t *rle, uint16_t rle_len, const uint16_t *palette);
 void ST7735_InvertColors(bool invert);
+void ST7735_SetIdleMode(bool idle);
 void ST7735_SetGamma(GammaDef gamma);
 void ST7735_Select(void);
 void ST7735_Unselect(void);
@@ -280,6 +322,21 @@ void ST7735_barProgressRange(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                              uint16_t col_left, uint16_t col_right,
                              uint16_t col_bg, uint16_t col_mid,
                              uint16_t gap);
+void ST7735_barProgressInvalidate(void);
+
+// Rohes Streaming in ein Adressfenster (DMA, Zeile für Zeile).
+// StreamData wartet auf die vorige Übertragung, der Aufrufer kann also
+// während des Transfers schon den nächsten Puffer füllen (Ping-Pong).
+// Geht am Schattenspeicher vorbei (ST7735_FB_Flush benutzt es selbst);
+// wer bei ST7735_USE_SHADOW_FB=1 direkt streamt, muss danach
+// ST7735_FB_InvalidateAll() rufen.
+void ST7735_StreamBegin(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void ST7735_StreamData(uint8_t *buf, uint16_t len);
+void ST7735_StreamEnd(void);
+
+// Wird gerufen, solange ein DMA-Block läuft (und nach jeder Zeile von
+// ST7735_FillRectangle). Der Haken darf selbst nicht zeichnen.
+void ST7735_SetYieldHook(void (*hook)(void));
 
 
 
@@ -0,0 +1,224 @@
+/* vim: set ai et ts=4 sw=4: */
+#include "st7735_dma.h"
+#include "st7735_fb.h"
+#include "xhc_profiler.h"
+
+#if ST7735_USE_SHADOW_FB
+
+#include <string.h>
+
+#if (ST7735_WIDTH != ST7735_FB_WIDTH) || (ST7735_HEIGHT != ST7735_FB_HEIGHT)
+# error "Schattenspeicher ist fuer 160x128 (Landscape) ausgelegt"
+#endif
+
+_Static_assert(ST7735_FB_RAM_BYTES <= ST7735_FB_RAM_BUDGET,
+               "Schattenspeicher sprengt das RAM-Budget");
+
+#define FB_CLEAN_X0 0xFF
+#define FB_CLEAN_X1 0x00
+
+/* 2 Bit pro Pixel, Pixel x liegt in Byte x/4 an Bitposition (x%4)*2 */
+static uint8_t  fb[ST7735_FB_HEIGHT][ST7735_FB_STRIDE];
+static uint16_t fb_accent[ST7735_FB_HEIGHT];             // Farbe für Index 3 je Zeile
+static uint8_t  fb_dirty_x0[ST7735_FB_HEIGHT];           // erster geänderter Pixel
+static uint8_t  fb_dirty_x1[ST7735_FB_HEIGHT];           // letzter geänderter Pixel
+static uint16_t fb_line[2][ST7735_FB_WIDTH];             // Ping-Pong für DMA (big endian)
+static uint32_t fb_last_flush = 0;
+
+static inline uint16_t fb_swap(uint16_t c) { return (uint16_t)((c >> 8) | (c << 8)); }
+
+static inline void fb_mark(uint16_t y, uint16_t x0, uint16_t x1)
+{
+    // sauber = x0 0xFF / x1 0 -> min/max funktioniert ohne Sonderfall
+    if (x0 < fb_dirty_x0[y]) fb_dirty_x0[y] = (uint8_t)x0;
+    if (x1 > fb_dirty_x1[y]) fb_dirty_x1[y] = (uint8_t)x1;
+}
+
+/* Farbe -> Paletten-Index; unbekannte Farben werden Akzentfarbe der Zeile */
+static uint8_t fb_color_index(uint16_t y, uint16_t color)
+{
+    switch (color) {
+        case ST7735_BLACK: return 0;
+        case ST7735_WHITE: return 1;
+        case ST7735_BLUE:  return 2;
+        default:
+            if (fb_accent[y] != color) {
+                // vorhandene Akzentpixel der Zeile wechseln mit -> ganze Zeile neu
+                fb_accent[y] = color;
+                fb_mark(y, 0, ST7735_FB_WIDTH - 1);
+            }
+            return 3;
+    }
+}
+
+static void fb_span(uint16_t y, uint16_t x0, uint16_t x1, uint8_t idx)
+{
+    uint8_t *row = fb[y];
+    uint8_t pat = (uint8_t)(idx * 0x55u);
+    int16_t ch0 = -1, ch1 = -1;
+
+    uint16_t x = x0;
+    while (x <= x1) {
+        uint16_t b = x >> 2;
+        uint8_t  mask;
+        uint16_t next;
+        if ((x & 3u) == 0 && (x + 3u) <= x1) {        // ganzes Byte = 4 Pixel
+            mask = 0xFF; next = x + 4u;
+        } else {
+            mask = (uint8_t)(3u << ((x & 3u) * 2u)); next = x + 1u;
+        }
+        uint8_t nv = (uint8_t)((row[b] & (uint8_t)~mask) | (pat & mask));
+        if (nv != row[b]) {
+            row[b] = nv;
+            if (ch0 < 0) ch0 = (int16_t)x;
+            ch1 = (int16_t)(next - 1u);
+        }
+        x = next;
+    }
+    if (ch0 >= 0) fb_mark(y, (uint16_t)ch0, (uint16_t)ch1);
+}
+
+void ST7735_FB_InvalidateAll(void)
+{
+    for (uint16_t y = 0; y < ST7735_FB_HEIGHT; y++) {
+        fb_dirty_x0[y] = 0;
+        fb_dirty_x1[y] = ST7735_FB_WIDTH - 1;
+    }
+}
+
+void ST7735_FB_Init(void)
+{
+    memset(fb, 0, sizeof(fb));
+    for (uint16_t y = 0; y < ST7735_FB_HEIGHT; y++) fb_accent[y] = ST7735_RED;
+    ST7735_FB_InvalidateAll();    // Panel-Inhalt nach Reset ist undefiniert
+}
+
+void ST7735_FB_FillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    if (x >= ST7735_FB_WIDTH || y >= ST7735_FB_HEIGHT || w == 0 || h == 0) return;
+    if ((x + w) > ST7735_FB_WIDTH)  w = ST7735_FB_WIDTH - x;
+    if ((y + h) > ST7735_FB_HEIGHT) h = ST7735_FB_HEIGHT - y;
+
+    for (uint16_t row = y; row < y + h; row++) {
+        fb_span(row, x, (uint16_t)(x + w - 1), fb_color_index(row, color));
+    }
+}
+
+void ST7735_FB_DrawChar(uint16_t x, uint16_t y, char ch, FontDef font,
+                        uint16_t color, uint16_t bgcolor)
+{
+    for (uint16_t i = 0; i < font.height; i++) {
+        uint16_t py = y + i;
+        if (py >= ST7735_FB_HEIGHT) break;
+
+        uint8_t fg = fb_color_index(py, color);
+        uint8_t bg = fb_color_index(py, bgcolor);
+        uint16_t b = Font_GlyphRow(&font, ch, i);
+        uint8_t *row = fb[py];
+        int16_t ch0 = -1, ch1 = -1;
+
+        for (uint16_t j = 0; j < font.width; j++) {
+            uint16_t px = x + j;
+            if (px >= ST7735_FB_WIDTH) break;
+            uint8_t idx   = ((b << j) & 0x8000) ? fg : bg;
+            uint8_t shift = (uint8_t)((px & 3u) * 2u);
+            uint8_t nv = (uint8_t)((row[px >> 2] & ~(3u << shift)) | (idx << shift));
+            if (nv != row[px >> 2]) {
+                row[px >> 2] = nv;
+                if (ch0 < 0) ch0 = (int16_t)px;
+                ch1 = (int16_t)px;
+            }
+        }
+        if (ch0 >= 0) fb_mark(py, (uint16_t)ch0, (uint16_t)ch1);
+    }
+}
+
+/* Eine Zeile (Spalten x0..x1) über die Palette nach RGB565 expandieren */
+static void fb_expand(uint16_t y, uint16_t x0, uint16_t x1, uint16_t *dst)
+{
+    const uint16_t pal[4] = {
+        fb_swap(ST7735_BLACK), fb_swap(ST7735_WHITE),
+        fb_swap(ST7735_BLUE),  fb_swap(fb_accent[y])
+    };
+    const uint8_t *row = fb[y];
+    for (uint16_t x = x0; x <= x1; x++) {
+        *dst++ = pal[(row[x >> 2] >> ((x & 3u) * 2u)) & 3u];
+    }
+}
+
+/**
+ * @brief Überträgt alle geänderten Bereiche zum Display
+ * @return 1 wenn ein Flush stattgefunden hat, 0 wenn durch Frame-Deckel übersprungen
+ *
+ * Aufeinanderfolgende Zeilen mit identischem Dirty-Span werden in einem
+ * Adressfenster übertragen. Nur aus dem Hauptkontext aufrufen (DMA-IRQ nötig).
+ * Zeichnen und Flush laufen beide nur in task_ui (in DMA-Wartezeiten
+ * eingeschobene Tasks zeichnen nicht), die Dirty-Spans brauchen also
+ * keine Interrupt-Sperre.
+ */
+uint8_t ST7735_FB_Flush(void)
+{
+    if (!ST7735_IsReady()) return 0;   // Panel-Init läuft noch
+
+    uint32_t now = HAL_GetTick();
+    if (now - fb_last_flush < ST7735_FB_MIN_FRAME_MS) return 0;
+    fb_last_flush = now;
+    XHC_PROF_BEGIN(PROF_FB_FLUSH);
+
+    uint16_t y = 0;
+    while (y < ST7735_FB_HEIGHT) {
+        uint8_t x0, x1;
+
+        x0 = fb_dirty_x0[y];
+        x1 = fb_dirty_x1[y];
+        fb_dirty_x0[y] = FB_CLEAN_X0;
+        fb_dirty_x1[y] = FB_CLEAN_X1;
+
+        if (x0 > x1) { y++; continue; }
+
+        uint16_t y_end = y + 1;
+        while (y_end < ST7735_FB_HEIGHT &&
+               fb_dirty_x0[y_end] == x0 && fb_dirty_x1[y_end] == x1) {
+            fb_dirty_x0[y_end] = FB_CLEAN_X0;
+            fb_dirty_x1[y_end] = FB_CLEAN_X1;
+            y_end++;
+        }
+
+        uint16_t w = (uint16_t)(x1 - x0 + 1u);
+        ST7735_StreamBegin(x0, y, w, (uint16_t)(y_end - y));
+        for (uint16_t row = y; row < y_end; row++) {
+            uint16_t *lb = fb_line[row & 1u];
+            fb_expand(row, x0, x1, lb);     // läuft während die andere Zeile per DMA rausgeht
+            ST7735_StreamData((uint8_t*)lb, (uint16_t)(w * 2u));
+        }
+        ST7735_StreamEnd();
+
+        y = y_end;
+    }
+    XHC_PROF_END(PROF_FB_FLUSH);
+    return 1;
+}
+
+#else
+
+void     ST7735_FB_Init(void) { }
+void     ST7735_FB_InvalidateAll(void) { }
+uint8_t  ST7735_FB_Flush(void) { return 0; }
+
+#endif /* ST7735_USE_SHADOW_FB */
+
+/**
+ * @brief RAM-Bedarf des Schattenspeichers (0 wenn deaktiviert)
+ *
+ * Zum Vergleich mit dem Gesamtbudget ST7735_SRAM_TOTAL (20 KB); gemeldet
+ * auf der Speicher-Diagnoseseite (0x10) und in der Telemetrie (0x11).
+ */
+uint32_t ST7735_FB_RamUsage(void)
+{
+#if ST7735_USE_SHADOW_FB
+    return (uint32_t)(sizeof(fb) + sizeof(fb_accent) + sizeof(fb_dirty_x0)
+                      + sizeof(fb_dirty_x1) + sizeof(fb_line));
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,47 @@
+/* vim: set ai et ts=4 sw=4: */
+#ifndef __ST7735_FB_H__
+#define __ST7735_FB_H__
+
+#include <stdint.h>
+#include "fonts.h"
+
+/*
+ * Optionaler 2bpp-Schattenspeicher (160x128, 4 Pixel pro Byte = 5 KB).
+ *
+ * Alle Zeichenfunktionen des Treibers schreiben bei ST7735_USE_SHADOW_FB=1
+ * nur in diesen Speicher. ST7735_FB_Flush() überträgt danach je Zeile nur
+ * den geänderten Spaltenbereich per DMA. Mehrfaches Übermalen (Label-
+ * Hervorhebung + Text + Fill) kostet damit nur einen SPI-Write pro Pixel,
+ * unveränderte Pixel gar keinen.
+ *
+ * Palette: 0=schwarz, 1=weiß, 2=blau, 3=Akzentfarbe der Zeile.
+ * Jede Zeile hat genau EINE Akzentfarbe (rot ODER grün ...). Das reicht für
+ * die UI: rote Achs-Labels und die Override-Balken liegen in getrennten
+ * Zeilen, und ein Balken ist immer nur links (rot) oder rechts (grün) aktiv.
+ */
+
+#define ST7735_FB_WIDTH        160
+#define ST7735_FB_HEIGHT       128
+#define ST7735_FB_STRIDE       (ST7735_FB_WIDTH / 4)
+
+/* Minimaler Abstand zwischen zwei Flushes (Frame-Rate-Deckel, 25 ms = 40 fps) */
+#define ST7735_FB_MIN_FRAME_MS 25u
+
+/* RAM-Bedarf: Bitmap + Akzentfarbe je Zeile + Dirty-Span je Zeile + 2 DMA-Zeilen */
+#define ST7735_FB_RAM_BYTES    (ST7735_FB_STRIDE * ST7735_FB_HEIGHT  /* 5120 */ \
+                                + 2u * ST7735_FB_HEIGHT              /*  256 */ \
+                                + 2u * ST7735_FB_HEIGHT              /*  256 */ \
+                                + 2u * 2u * ST7735_FB_WIDTH)         /*  640 */
+/* Anteil am 20-KB-SRAM des STM32F103C8, den der Schattenspeicher maximal belegen darf */
+#define ST7735_FB_RAM_BUDGET   (7u * 1024u)
+#define ST7735_SRAM_TOTAL      (20u * 1024u)
+
+void     ST7735_FB_Init(void);
+void     ST7735_FB_InvalidateAll(void);
+void     ST7735_FB_FillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+void     ST7735_FB_DrawChar(uint16_t x, uint16_t y, char ch, FontDef font,
+                            uint16_t color, uint16_t bgcolor);
+uint8_t  ST7735_FB_Flush(void);
+uint32_t ST7735_FB_RamUsage(void);
+
+#endif // __ST7735_FB_H__
@@ -98,6 +98,7 @@ typedef struct _USBD_CUSTOM_HID_Itf
   int8_t (* DeInit)(void);
   int8_t (* OutEvent)(uint8_t event_idx, uint8_t state);
   int8_t (* SetReport)     (uint8_t *report, uint16_t len);
+  uint8_t *(* GetReport)   (uint8_t report_id, uint16_t *len);   // NULL = GET_REPORT nicht unterstützt
 
 } USBD_CUSTOM_HID_ItfTypeDef;
 
@@ -409,7 +409,26 @@ static uint8_t  USBD_CUSTOM_HID_Setup(USBD_HandleTypeDef *pdev,
 
         case CUSTOM_HID_REQ_SET_REPORT:
           hhid->IsReportAvailable = 1U;
-          USBD_CtlPrepareRx(pdev, hhid->Report_buf, req->wLength);
+          USBD_CtlPrepareRx(pdev, hhid->Report_buf,
+                            MIN(req->wLength, USBD_CUSTOMHID_OUTREPORT_BUF_SIZE));
+          break;
+
+        case CUSTOM_HID_REQ_GET_REPORT:
+          // *** Feature-Reports (Diagnose) an die Anwendung durchreichen ***
+          if (((USBD_CUSTOM_HID_ItfTypeDef *)pdev->pUserData)->GetReport != NULL)
+          {
+            pbuf = ((USBD_CUSTOM_HID_ItfTypeDef *)pdev->pUserData)->GetReport((uint8_t)(req->wValue),
+                                                                               &len);
+          }
+          if ((pbuf != NULL) && (len != 0U))
+          {
+            USBD_CtlSendData(pdev, pbuf, MIN(len, req->wLength));
+          }
+          else
+          {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
           break;
 
         default:
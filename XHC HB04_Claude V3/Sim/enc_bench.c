@@ -0,0 +1,130 @@
+/*
+ * XHC HB04 Host-Simulation: Rastungsverlust-Benchmark
+ *
+ *   ./build/xhc_encbench [-v] [fall ...]   ohne Fall-Namen alle Fälle
+ *
+ * Die Firmware-Ausgaben (printf) landen nur mit -v auf stdout, die
+ * Tabelle immer.
+ *
+ * Spielt synthetische Quadratur-Signale (sim_quad.c) mit festen Profilen
+ * in die unveränderte Encoder-Kette: Eingangsfilter -> TIM2 ->
+ * encoder_1ms_poll (/4-Rest, ±127) -> task_encoder (ROTARY_OFF verwerfen)
+ * -> flush_encoder_detents (Moduswechsel) -> task_usb_report (Speed-Mapping).
+ *
+ * Spalten:
+ *   ein        Rastungen am Eingang
+ *   TIM2       Netto-Zählschritte / 4 nach dem Eingangsfilter
+ *   aus        Summe |Rad-Wert| im in_report-Strom
+ *   aus/ein    Verstärkung durch das Speed-Mapping (1.00 = 1:1)
+ *   verloren   Rastungen, für die kein Report mit Rad-Wert kam (siehe sim_stats.h);
+ *              Rastungen vor einem Flush, denen ein Report folgt, zählen
+ *              als gemeldet -> Untergrenze
+ *   p50/p99/max  Latenz Rastung -> Report
+ */
+
+#include "sim_hal.h"
+#include "sim_quad.h"
+#include "sim_stats.h"
+#include "xhc_sched.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SETTLE_MS   200u     // Drehschalter-Entprellung + Flush vor jedem Fall
+#define DRAIN_MS    300u     // Nachlauf, bis der letzte Report draußen ist
+
+/* Drehschalter-Pins wie sim_rotary() */
+enum { ROT_OFF = 0, ROT_X = 1, ROT_Y = 2 };
+
+typedef struct {
+    const char        *name;
+    sim_quad_profile_t q;
+    uint8_t            rotary;       // Schalterstellung beim Drehen
+    uint32_t           switch_ms;    // > 0: nach switch_ms auf switch_to umschalten
+    uint8_t            switch_to;
+} bench_case_t;
+
+static const bench_case_t cases[] = {
+    { "langsam",      {   40,    2,    2, 0,    0,  0 }, ROT_X },
+    { "mittel",       {  100,   10,   10, 0,    0,  0 }, ROT_X },
+    { "schnell",      {  200,   50,   50, 0,    0,  0 }, ROT_X },
+    { "sehr_schnell", {  400,  200,  200, 0,    0,  0 }, ROT_X },
+    { "anschlag",     { 2000, 1000, 1000, 0,    0,  0 }, ROT_X },
+    { "rampe",        {  300,    5,  300, 0,    0,  0 }, ROT_X },
+    { "bremsen",      {  300,  300,    5, 0,    0,  0 }, ROT_X },
+    { "links",        { -100,   20,   20, 0,    0,  0 }, ROT_X },
+    { "jitter",       {  100,   20,   20, 0,    0, 40 }, ROT_X },
+    { "prellen_kurz", {  100,   20,   20, 3,  100,  0 }, ROT_X },
+    { "prellen_lang", {  100,   20,   20, 3, 2000,  0 }, ROT_X },
+    { "prellen_fix",  {  200,  100,  100, 2, 5000, 20 }, ROT_X },
+    { "moduswechsel", {  100,   20,   20, 0,    0,  0 }, ROT_X, 2500, ROT_Y },
+    { "aus",          {   50,   20,   20, 0,    0,  0 }, ROT_OFF },
+};
+
+static FILE *out;
+
+static int selected(const char *name, int argc, char **argv, int first)
+{
+    if (first >= argc) return 1;
+    for (int i = first; i < argc; i++) {
+        if (!strcmp(argv[i], name)) return 1;
+    }
+    return 0;
+}
+
+static void run_case(const bench_case_t *c, uint32_t seed)
+{
+    sim_rotary(c->rotary);
+    sim_run_until(sim_now() + SIM_MS(SETTLE_MS));
+    sim_stats_mark();
+    sim_quad_stats_t q0 = *sim_quad_stats();
+
+    uint64_t t_end = sim_quad_play(&c->q, seed);
+    if (c->switch_ms) {
+        sim_run_until(sim_now() + SIM_MS(c->switch_ms));
+        sim_rotary(c->switch_to);
+    }
+    sim_run_until((t_end > sim_now() ? t_end : sim_now()) + SIM_MS(DRAIN_MS));
+
+    const sim_quad_stats_t *q1 = sim_quad_stats();
+    uint32_t in = sim_stats.detents;
+    uint32_t lost = sim_stats_unreported();
+    uint32_t misses = 0;
+    for (uint8_t i = 0; i < xhc_sched_task_count(); i++) misses += xhc_sched_task(i)->misses;
+
+    fprintf(out, "%-13s %5u %6d %6u %7.2f %5u %5.1f%% %7.1f %7.1f %7.1f %6u %5u %5u\n",
+           c->name, in, (int)(q1->counts - q0.counts) / 4, sim_stats.wheel_abs,
+           in ? (double)sim_stats.wheel_abs / in : 0.0,
+           lost, in ? 100.0 * lost / in : 0.0,
+           sim_stats_latency_us(50) / 1000.0, sim_stats_latency_us(99) / 1000.0,
+           sim_stats_latency_us(100) / 1000.0,
+           q1->filtered - q0.filtered, sim_stats.reports, misses);
+}
+
+int main(int argc, char **argv)
+{
+    int first = 1;
+
+    out = fdopen(dup(fileno(stdout)), "w");
+    if (argc > 1 && !strcmp(argv[1], "-v")) {
+        first = 2;
+    } else if (!freopen("/dev/null", "w", stdout)) {
+        return 2;
+    }
+
+    sim_stats_attach(0);
+    sim_firmware_init();
+    sim_run_until(SIM_MS(1200));            // Panel-Init und statische UI
+
+    fprintf(out, "%-13s %5s %6s %6s %7s %5s %6s %7s %7s %7s %6s %5s %5s\n",
+            "Fall", "ein", "TIM2", "aus", "aus/ein", "verl", "verl%", "p50 ms", "p99 ms", "max ms",
+            "gefilt", "Rep", "Miss");
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (selected(cases[i].name, argc, argv, first)) {
+            run_case(&cases[i], 0x9E3779B9u + i);
+            fflush(out);
+        }
+    }
+    fclose(out);
+    return 0;
+}
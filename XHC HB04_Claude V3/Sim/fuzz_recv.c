@@ -0,0 +1,200 @@
+/*
+ * XHC HB04 Host-Simulation: Fuzz-Ziel für die Host-Eingänge
+ *
+ * Alles, was der Host ungeprüft schicken kann, läuft hier durch die
+ * unveränderten Firmware-Pfade:
+ *
+ *   SET_REPORT 0x06   xhc_recv_isr -> PendSV (xhc_irq_pendsv) -> xhc_recv
+ *                     -> UI-Task (xhc_process_received_data, Zeichnen)
+ *   SET_REPORT 0x10   xhc_diag_set_report (+ Reset über PendSV)
+ *   GET_REPORT 0x10   xhc_diag_get_report mit vom Host gesetzter Seite/Index
+ *   GET_REPORT 0x11   xhc_telem_get_report
+ *
+ * Eingabe = Folge von Datensätzen, das erste Byte wählt die Aktion:
+ *
+ *   (b & 3) == 0   Chunk: 7 Byte -> USB-IRQ (ohne PendSV, Warteschlange kann volllaufen)
+ *   (b & 3) == 1   Diagnose: 3 Byte page, index, cmd -> SET_REPORT, dann GET_REPORT,
+ *                  dazu GET_REPORT 0x11
+ *   (b & 3) == 2   UI-Durchlauf (nur wenn ein Paket fertig ist)
+ *   (b & 3) == 3   PendSV ausführen
+ *
+ * Am Ende laufen PendSV und UI noch einmal. Geprüft wird zusätzlich zu
+ * ASan/UBSan: ein gemeldetes Paket beginnt mit WHBxx_MAGIC, GET_REPORT
+ * liefert immer XHC_DIAG_REPORT_LEN bzw. XHC_TELEM_REPORT_LEN Byte.
+ *
+ * Bauarten (Makefile):
+ *   make fuzz        gcc + ASan/UBSan, eigener Treiber (siehe main)
+ *   make libfuzzer   clang -fsanitize=fuzzer, -DXHC_LIBFUZZER
+ *   AFL              afl-gcc/afl-clang-fast statt CC, Eingabe per Datei (@@) oder stdin
+ */
+
+#include "sim_hal.h"
+#include "xhc_main.h"
+#include "xhc_irq.h"
+#include "xhc_receive.h"
+#include "xhc_diag.h"
+#include "xhc_telemetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHUNK_BYTES   7u
+
+static void fuzz_check(int ok, const char *what)
+{
+    if (!ok) {
+        fprintf(stderr, "fuzz_recv: Invariante verletzt: %s\n", what);
+        abort();
+    }
+}
+
+static void fuzz_boot(void)
+{
+    static uint8_t booted;
+    if (booted) return;
+    booted = 1;
+
+    if (!getenv("XHC_FUZZ_VERBOSE") && !freopen("/dev/null", "w", stdout)) abort();
+    sim_firmware_init();
+    sim_rotary(1);
+    sim_run_until(SIM_MS(1200));        // Panel-Init und statische UI, danach zeichnet der UI-Pfad
+}
+
+static void fuzz_ui(void)
+{
+    if (xhc_rx_take_update()) {
+        fuzz_check(output_report.magic == WHBxx_MAGIC, "Paket ohne Magic übernommen");
+        xhc_process_received_data();
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz_boot();
+
+    size_t off = 0;
+    while (off < size) {
+        uint8_t op = data[off++];
+        switch (op & 3u) {
+            case 0:
+                if (size - off < CHUNK_BYTES) return 0;
+                xhc_recv_isr(&data[off]);
+                off += CHUNK_BYTES;
+                break;
+
+            case 1: {
+                if (size - off < 3u) return 0;
+                uint8_t rep[4] = { XHC_DIAG_REPORT_ID, data[off], data[off + 1], data[off + 2] };
+                off += 3u;
+                xhc_diag_set_report(rep, sizeof(rep));
+                uint16_t len = 0;
+                uint8_t *resp = xhc_diag_get_report(&len);
+                fuzz_check(resp != NULL && len == XHC_DIAG_REPORT_LEN, "GET_REPORT-Länge");
+                resp = xhc_telem_get_report(&len);
+                fuzz_check(resp != NULL && len == XHC_TELEM_REPORT_LEN && resp[0] == XHC_TELEM_REPORT_ID,
+                           "Telemetrie-Report");
+                break;
+            }
+
+            case 2:
+                fuzz_ui();
+                break;
+
+            default:
+                xhc_irq_pendsv();
+                break;
+        }
+    }
+    xhc_irq_pendsv();
+    fuzz_ui();
+    return 0;
+}
+
+#ifndef XHC_LIBFUZZER
+
+/* ---- Eigener Treiber: Dateien/stdin abspielen oder Zufallseingaben ---- */
+
+static uint32_t rng = 0x12345678u;
+
+static uint32_t rnd(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* Gültiges Host-Paket als Chunk-Datensätze, dann zufällig verbogen */
+static size_t gen_input(uint8_t *buf, size_t cap)
+{
+    size_t n = 0;
+    uint32_t records = 1u + rnd() % 40u;
+
+    for (uint32_t r = 0; r < records && n + 1u + 6u * (1u + CHUNK_BYTES) < cap; r++) {
+        uint32_t kind = rnd() % 8u;
+        if (kind < 4u) {
+            /* ganzes oder abgeschnittenes Paket */
+            uint8_t pkt[6 * CHUNK_BYTES];
+            for (size_t i = 0; i < sizeof(pkt); i++) pkt[i] = (uint8_t)rnd();
+            pkt[0] = (uint8_t)(WHBxx_MAGIC & 0xFF);
+            pkt[1] = (uint8_t)(WHBxx_MAGIC >> 8);
+            uint32_t chunks = (kind == 0u) ? 1u + rnd() % 6u : 6u;
+            for (uint32_t c = 0; c < chunks; c++) {
+                buf[n++] = (uint8_t)(rnd() & ~3u);
+                memcpy(&buf[n], &pkt[c * CHUNK_BYTES], CHUNK_BYTES);
+                n += CHUNK_BYTES;
+                if (rnd() % 3u == 0u) buf[n++] = 3u;            // PendSV dazwischen
+            }
+            buf[n++] = 2u;
+        } else if (kind == 4u) {
+            buf[n++] = 1u;
+            buf[n++] = (uint8_t)(rnd() % 5u);
+            buf[n++] = (uint8_t)rnd();
+            buf[n++] = (uint8_t)rnd();
+        } else {
+            uint32_t len = rnd() % 16u;
+            for (uint32_t i = 0; i < len; i++) buf[n++] = (uint8_t)rnd();
+        }
+    }
+    /* Bitfehler */
+    for (uint32_t f = rnd() % 4u; f > 0 && n; f--) {
+        buf[rnd() % n] ^= (uint8_t)(1u << (rnd() % 8u));
+    }
+    return n;
+}
+
+static void run_file(FILE *f, const char *name)
+{
+    static uint8_t buf[1 << 20];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    LLVMFuzzerTestOneInput(buf, n);
+    fprintf(stderr, "%s: %zu Byte ok\n", name, n);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 3 && !strcmp(argv[1], "-r")) {
+        unsigned long runs = strtoul(argv[2], NULL, 0);
+        if (argc >= 4) rng = (uint32_t)strtoul(argv[3], NULL, 0) | 1u;
+        static uint8_t buf[4096];
+        for (unsigned long i = 0; i < runs; i++) {
+            size_t n = gen_input(buf, sizeof(buf));
+            LLVMFuzzerTestOneInput(buf, n);
+        }
+        fprintf(stderr, "fuzz_recv: %lu Zufallseingaben ok\n", runs);
+        return 0;
+    }
+    if (argc < 2) {
+        run_file(stdin, "stdin");
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE *f = fopen(argv[i], "rb");
+        if (!f) { perror(argv[i]); return 2; }
+        run_file(f, argv[i]);
+        fclose(f);
+    }
+    return 0;
+}
+
+#endif /* XHC_LIBFUZZER */
@@ -0,0 +1,152 @@
+/*
+ * XHC HB04 Host-Simulation: Durchsatz des Empfangspfads
+ *
+ *   ./build/xhc_recvbench [chunks]      Standard 2000000 je Strom
+ *
+ * Misst Chunks/s (Wanduhr des Host-Rechners) durch
+ *   xhc_recv_isr -> xhc_recv_deferred (Zusammenbau)        Spalte "recv"
+ *   + xhc_process_received_data (Änderungserkennung),       Spalte "+erk"
+ *     ohne Zeichnen: die UI ist noch nicht initialisiert,
+ *     xhc_ui_update_* kehren sofort zurück
+ *
+ * für gültige und kaputte Eingangsströme. Zweck: eine Härtung im
+ * Empfangspfad darf den gültigen Strom nicht bremsen, und kaputte Chunks
+ * dürfen nicht teurer sein als gültige (eine begrenzte Ablehnung je Chunk).
+ * Absolute Zahlen gelten nur für den Host; auf dem Target zählt das
+ * Verhältnis der Zeilen zueinander.
+ */
+
+#include "sim_hal.h"
+#include "xhc_main.h"
+#include "xhc_receive.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHUNK_BYTES   7u
+#define PKT_CHUNKS    6u           // 37 Byte -> 6 Chunks
+
+typedef struct {
+    const char *name;
+    void      (*fill)(uint8_t *buf, uint32_t n);   // n Chunks erzeugen
+} stream_t;
+
+static uint32_t rng = 0x2545F491u;
+
+static uint32_t rnd(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void put_packet(uint8_t *dst, uint16_t x)
+{
+    struct whb04_out_data p;
+    memset(&p, 0, sizeof(p));
+    p.magic = WHBxx_MAGIC;
+    p.pos[0].p_int = x;
+    p.feedrate = 1200;
+    p.step_mul = 1;
+    memset(dst, 0, PKT_CHUNKS * CHUNK_BYTES);
+    memcpy(dst, &p, sizeof(p));
+}
+
+/* Gleiches Paket immer wieder (Host im Stillstand) */
+static void fill_dup(uint8_t *buf, uint32_t n)
+{
+    for (uint32_t c = 0; c + PKT_CHUNKS <= n; c += PKT_CHUNKS) put_packet(&buf[c * CHUNK_BYTES], 1);
+}
+
+/* Position ändert sich mit jedem Paket */
+static void fill_moving(uint8_t *buf, uint32_t n)
+{
+    for (uint32_t c = 0; c + PKT_CHUNKS <= n; c += PKT_CHUNKS) put_packet(&buf[c * CHUNK_BYTES], (uint16_t)(c / PKT_CHUNKS));
+}
+
+/* Zufallsbytes, Magic kommt praktisch nie vor */
+static void fill_garbage(uint8_t *buf, uint32_t n)
+{
+    for (uint32_t i = 0; i < n * CHUNK_BYTES; i++) buf[i] = (uint8_t)rnd();
+}
+
+/* Jeder Chunk beginnt mit Magic: ständiger Neustart, nie ein fertiges Paket */
+static void fill_magic(uint8_t *buf, uint32_t n)
+{
+    fill_garbage(buf, n);
+    for (uint32_t c = 0; c < n; c++) {
+        buf[c * CHUNK_BYTES]     = (uint8_t)(WHBxx_MAGIC & 0xFF);
+        buf[c * CHUNK_BYTES + 1] = (uint8_t)(WHBxx_MAGIC >> 8);
+    }
+}
+
+/* Pakete nach 3 von 6 Chunks abgebrochen */
+static void fill_truncated(uint8_t *buf, uint32_t n)
+{
+    uint8_t pkt[PKT_CHUNKS * CHUNK_BYTES];
+    put_packet(pkt, 7);
+    for (uint32_t c = 0; c < n; c++) memcpy(&buf[c * CHUNK_BYTES], &pkt[(c % 3u) * CHUNK_BYTES], CHUNK_BYTES);
+}
+
+static const stream_t streams[] = {
+    { "gültig, Duplikate",   fill_dup       },
+    { "gültig, bewegt",      fill_moving    },
+    { "Zufallsbytes",        fill_garbage   },
+    { "Magic in jedem Chunk", fill_magic    },
+    { "abgebrochen (3/6)",   fill_truncated },
+};
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Chunks so durchschieben, wie USB-IRQ und PendSV es tun (4 je PendSV) */
+static double run(const uint8_t *buf, uint32_t n, int detect, uint32_t *packets)
+{
+    *packets = 0;
+    double t0 = now_s();
+    for (uint32_t c = 0; c < n; c++) {
+        xhc_recv_isr(&buf[c * CHUNK_BYTES]);
+        if ((c & 3u) == 3u || c == n - 1u) {
+            xhc_recv_deferred();
+            if (xhc_rx_take_update()) {
+                (*packets)++;
+                if (detect) xhc_process_received_data();
+            }
+        }
+    }
+    return now_s() - t0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000000u;
+    n -= n % PKT_CHUNKS;
+    if (n == 0) n = PKT_CHUNKS;
+
+    uint8_t *buf = malloc((size_t)n * CHUNK_BYTES);
+    if (!buf) return 2;
+
+    /* Nur Reset + Init, kein Boot-Lauf: UI bleibt aus, gemessen wird der Empfang */
+    sim_firmware_init();
+
+    printf("%-22s %12s %12s %9s %9s %8s\n", "Strom", "recv Chk/s", "+erk Chk/s", "ns/Chk", "+erk ns", "Pakete");
+    double ref = 0.0;
+    for (uint32_t s = 0; s < sizeof(streams) / sizeof(streams[0]); s++) {
+        streams[s].fill(buf, n);
+        uint32_t pk_a, pk_b;
+        double ta = run(buf, n, 0, &pk_a);
+        double tb = run(buf, n, 1, &pk_b);
+        double ns_a = ta * 1e9 / n, ns_b = tb * 1e9 / n;
+        if (s == 0) ref = ns_b;
+        printf("%-22s %12.0f %12.0f %9.1f %9.1f %8u  (%.2fx)\n", streams[s].name,
+               n / ta, n / tb, ns_a, ns_b, pk_b, ref > 0 ? ns_b / ref : 0.0);
+    }
+    free(buf);
+    return 0;
+}
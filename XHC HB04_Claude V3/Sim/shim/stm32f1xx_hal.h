@@ -0,0 +1,203 @@
+/*
+ * XHC HB04 Host-Simulation: Ersatz für stm32f1xx_hal.h
+ *
+ * Nur der Ausschnitt aus HAL, CMSIS und Registern, den die Firmware-Module
+ * tatsächlich benutzen. Register sind Strukturen im Host-RAM; Zähler, die
+ * auf dem Chip von selbst laufen (SysTick->VAL, DWT->CYCCNT), rechnet
+ * sim_hal.c beim Zugriff aus der virtuellen Zeit aus.
+ *
+ * Steht im Include-Pfad VOR Drivers/STM32F1xx_HAL_Driver/Inc, dadurch zieht
+ * das unveränderte Core/Inc/main.h diese Datei statt der echten HAL.
+ */
+
+#ifndef SIM_STM32F1XX_HAL_H
+#define SIM_STM32F1XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>      /* newlib-Header kommen auf dem Target indirekt mit */
+#include <stdlib.h>
+
+#define __IO volatile
+
+/* ---- HAL-Grundtypen ---- */
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+#define HAL_MAX_DELAY   0xFFFFFFFFu
+
+/* ---- Interrupts / NVIC ---- */
+typedef enum {
+    PendSV_IRQn          = -2,
+    SysTick_IRQn         = -1,
+    DMA1_Channel3_IRQn   = 13,
+    USB_LP_CAN1_RX0_IRQn = 20,
+} IRQn_Type;
+
+#define NVIC_PRIORITYGROUP_0  0x7u
+#define NVIC_PRIORITYGROUP_1  0x6u
+#define NVIC_PRIORITYGROUP_2  0x5u
+#define NVIC_PRIORITYGROUP_3  0x4u
+#define NVIC_PRIORITYGROUP_4  0x3u
+
+uint32_t HAL_NVIC_GetPriorityGrouping(void);
+void     HAL_NVIC_GetPriority(IRQn_Type IRQn, uint32_t PriorityGroup,
+                              uint32_t *pPreemptPriority, uint32_t *pSubPriority);
+
+/* ---- Kern-Register (nur benutzte Felder) ---- */
+typedef struct { __IO uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+typedef struct { __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { __IO uint32_t DEMCR; } CoreDebug_Type;
+typedef struct { __IO uint32_t ICSR; } SCB_Type;
+
+SysTick_Type *sim_systick(void);
+DWT_Type     *sim_dwt(void);
+extern CoreDebug_Type sim_coredebug;
+extern SCB_Type       sim_scb;
+extern uint32_t       SystemCoreClock;
+
+#define SysTick    (sim_systick())
+#define DWT        (sim_dwt())
+#define CoreDebug  (&sim_coredebug)
+#define SCB        (&sim_scb)
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1u << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1u << 0)
+#define SCB_ICSR_PENDSVSET_Msk      (1u << 28)
+
+/* ---- CMSIS-Intrinsics ---- */
+void     sim_irq_disable(void);
+void     sim_irq_enable(void);
+uint32_t sim_irq_primask(void);
+void     sim_irq_set_primask(uint32_t v);
+void     sim_wfi(void);
+void     sim_nop(void);
+uint32_t sim_msp(void);
+
+#define __disable_irq()     sim_irq_disable()
+#define __enable_irq()      sim_irq_enable()
+#define __get_PRIMASK()     sim_irq_primask()
+#define __set_PRIMASK(v)    sim_irq_set_primask(v)
+#define __WFI()             sim_wfi()
+#define __NOP()             sim_nop()
+#define __get_MSP()         sim_msp()
+#define __CLZ(x)            ((uint8_t)((x) ? __builtin_clz(x) : 32))
+#define __REV16(x)          ((uint32_t)((((x) & 0xFF00FF00u) >> 8) | (((x) & 0x00FF00FFu) << 8)))
+
+/* ---- GPIO ---- */
+typedef struct { __IO uint32_t IDR, ODR; } GPIO_TypeDef;
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+extern GPIO_TypeDef sim_gpioa, sim_gpiob;
+#define GPIOA  (&sim_gpioa)
+#define GPIOB  (&sim_gpiob)
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_1   ((uint16_t)0x0002)
+#define GPIO_PIN_2   ((uint16_t)0x0004)
+#define GPIO_PIN_3   ((uint16_t)0x0008)
+#define GPIO_PIN_4   ((uint16_t)0x0010)
+#define GPIO_PIN_5   ((uint16_t)0x0020)
+#define GPIO_PIN_6   ((uint16_t)0x0040)
+#define GPIO_PIN_7   ((uint16_t)0x0080)
+#define GPIO_PIN_8   ((uint16_t)0x0100)
+#define GPIO_PIN_9   ((uint16_t)0x0200)
+#define GPIO_PIN_10  ((uint16_t)0x0400)
+#define GPIO_PIN_11  ((uint16_t)0x0800)
+#define GPIO_PIN_12  ((uint16_t)0x1000)
+#define GPIO_PIN_13  ((uint16_t)0x2000)
+#define GPIO_PIN_14  ((uint16_t)0x4000)
+#define GPIO_PIN_15  ((uint16_t)0x8000)
+
+typedef struct { uint32_t Pin, Mode, Pull, Speed; } GPIO_InitTypeDef;
+
+#define GPIO_MODE_INPUT       0x00u
+#define GPIO_MODE_OUTPUT_PP   0x01u
+#define GPIO_MODE_AF_PP       0x02u
+#define GPIO_NOPULL           0x00u
+#define GPIO_SPEED_FREQ_HIGH  0x03u
+
+void          HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void          HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+/* ---- TIM (Encoder-Modus) ---- */
+typedef struct { __IO uint32_t CR1, CNT, PSC, ARR; } TIM_TypeDef;
+extern TIM_TypeDef sim_tim2;
+#define TIM2  (&sim_tim2)
+
+typedef struct {
+    uint32_t Prescaler, CounterMode, Period, ClockDivision, RepetitionCounter, AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef          *Instance;
+    TIM_Base_InitTypeDef  Init;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    uint32_t EncoderMode;
+    uint32_t IC1Polarity, IC1Selection, IC1Prescaler, IC1Filter;
+    uint32_t IC2Polarity, IC2Selection, IC2Prescaler, IC2Filter;
+} TIM_Encoder_InitTypeDef;
+
+typedef struct { uint32_t MasterOutputTrigger, MasterSlaveMode; } TIM_MasterConfigTypeDef;
+
+#define TIM_COUNTERMODE_UP              0u
+#define TIM_CLOCKDIVISION_DIV1          0u
+#define TIM_AUTORELOAD_PRELOAD_DISABLE  0u
+#define TIM_ENCODERMODE_TI12            3u
+#define TIM_ICPOLARITY_RISING           0u
+#define TIM_ICSELECTION_DIRECTTI        1u
+#define TIM_ICPSC_DIV1                  0u
+#define TIM_TRGO_RESET                  0u
+#define TIM_MASTERSLAVEMODE_DISABLE     0u
+#define TIM_CHANNEL_ALL                 0x3Cu
+
+#define __HAL_TIM_GET_COUNTER(h)        ((h)->Instance->CNT)
+#define __HAL_TIM_SET_COUNTER(h, v)     ((h)->Instance->CNT = (v))
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim, TIM_Encoder_InitTypeDef *sConfig);
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+                                                        TIM_MasterConfigTypeDef *sMasterConfig);
+
+/* ---- SPI + DMA (Display) ---- */
+typedef struct { uint32_t dummy; } DMA_HandleTypeDef;
+typedef enum { HAL_DMA_FULL_TRANSFER = 0, HAL_DMA_HALF_TRANSFER } HAL_DMA_LevelCompleteTypeDef;
+
+typedef struct { uint32_t BaudRatePrescaler; } SPI_InitTypeDef;
+typedef struct {
+    SPI_InitTypeDef    Init;
+    DMA_HandleTypeDef *hdmatx;
+} SPI_HandleTypeDef;
+
+/* Teiler 2^(n+1) von PCLK2 (72 MHz), Kodierung wie im BR-Feld von SPI_CR1 */
+#define SPI_BAUDRATEPRESCALER_2    0x00u
+#define SPI_BAUDRATEPRESCALER_4    0x08u
+#define SPI_BAUDRATEPRESCALER_8    0x10u
+#define SPI_BAUDRATEPRESCALER_16   0x18u
+#define SPI_BAUDRATEPRESCALER_32   0x20u
+#define SPI_BAUDRATEPRESCALER_64   0x28u
+#define SPI_BAUDRATEPRESCALER_128  0x30u
+#define SPI_BAUDRATEPRESCALER_256  0x38u
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_DMA_PollForTransfer(DMA_HandleTypeDef *hdma, HAL_DMA_LevelCompleteTypeDef CompleteLevel,
+                                          uint32_t Timeout);
+void              HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+
+/* ---- System ---- */
+HAL_StatusTypeDef HAL_Init(void);
+uint32_t          HAL_GetTick(void);
+void              HAL_IncTick(void);
+void              HAL_Delay(uint32_t Delay);
+void              HAL_DBGMCU_EnableDBGSleepMode(void);
+
+#define __HAL_RCC_TIM2_CLK_ENABLE()    do { } while (0)
+#define __HAL_RCC_SRAM_CLK_ENABLE()    do { } while (0)
+#define __HAL_RCC_SRAM_CLK_DISABLE()   do { } while (0)
+#define __HAL_RCC_FLITF_CLK_ENABLE()   do { } while (0)
+#define __HAL_RCC_FLITF_CLK_DISABLE()  do { } while (0)
+
+#endif /* SIM_STM32F1XX_HAL_H */
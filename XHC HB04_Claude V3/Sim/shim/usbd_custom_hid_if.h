@@ -0,0 +1,28 @@
+/*
+ * XHC HB04 Host-Simulation: Ersatz für usbd_custom_hid_if.h
+ *
+ * Statt des ST-USB-Stacks nimmt sim_hal.c die IN-Reports entgegen und
+ * protokolliert sie mit virtuellem Zeitstempel. Der IN-Endpunkt ist bis
+ * zum nächsten 1-ms-Frame belegt (USBD_BUSY), wie am echten Bus.
+ */
+
+#ifndef SIM_USBD_CUSTOM_HID_IF_H
+#define SIM_USBD_CUSTOM_HID_IF_H
+
+#include <stdint.h>
+
+typedef enum {
+    USBD_OK = 0,
+    USBD_BUSY,
+    USBD_EMEM,
+    USBD_FAIL,
+} USBD_StatusTypeDef;
+
+typedef struct { uint8_t dev_state; } USBD_HandleTypeDef;
+
+extern USBD_HandleTypeDef hUsbDeviceFS;
+
+uint8_t USBD_CUSTOM_HID_SendReport(USBD_HandleTypeDef *pdev, uint8_t *report, uint16_t len);
+uint32_t XHC_RX_Dropped(void);
+
+#endif /* SIM_USBD_CUSTOM_HID_IF_H */
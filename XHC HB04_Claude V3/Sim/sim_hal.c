@@ -0,0 +1,651 @@
+/*
+ * XHC HB04 Host-Simulation: virtuelle Zeit, Interrupts, Peripherie
+ * siehe sim_hal.h
+ */
+
+#include "sim_hal.h"
+#include "main.h"
+#include "usbd_custom_hid_if.h"
+#include "xhc_main.h"
+#include "xhc_irq.h"
+#include "xhc_profiler.h"
+#include "xhc_receive.h"
+#include "xhc_diag.h"
+#include "xhc_trace.h"
+#include "st7735_dma.h"
+#include "encoder_cubeide.h"
+#include "button_matrix.h"
+#include "rotary_switch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_THREAD_LEVEL   16          // Thread-Modus, unter allen IRQs
+#define SIM_USB_MAX_LEN    64u
+
+/* ---- Peripherie-Register und Handles, die sonst CubeMX-Code anlegt ---- */
+GPIO_TypeDef       sim_gpioa, sim_gpiob;
+TIM_TypeDef        sim_tim2;
+CoreDebug_Type     sim_coredebug;
+SCB_Type           sim_scb;
+uint32_t           SystemCoreClock = SIM_CPU_HZ;
+static SysTick_Type sim_systick_regs;
+static DWT_Type     sim_dwt_regs;
+
+SPI_HandleTypeDef  hspi1;
+DMA_HandleTypeDef  hdma_spi1_tx;
+USBD_HandleTypeDef hUsbDeviceFS;
+
+volatile uint32_t uwTick;
+
+/* Symbole aus STM32F103C8TX_FLASH.ld für xhc_mem.c. Im Host-Build nur
+ * Platzhalter: die Adressen liegen irgendwo im Prozess, die daraus
+ * berechneten Größen sind bedeutungslos (XHC_MEM_ENABLE=0). _edata und
+ * _end legt der Host-Linker selbst an. */
+uint8_t _sdata, _sbss, _ebss, _estack;
+uint8_t _Min_Heap_Size, _Min_Stack_Size;
+uint8_t _sramfunc, _eramfunc;
+uint8_t _snoinit, _enoinit;
+extern uint8_t _end;
+
+void *_sbrk(ptrdiff_t incr)
+{
+    (void)incr;
+    return &_end;
+}
+
+/* ---- Zustand ---- */
+static uint64_t now;                 // virtuelle Zeit in CPU-Zyklen
+static uint64_t next_at;             // zwischengespeichertes sim_next_event(), 0 = ungültig
+static int      cur_level = SIM_THREAD_LEVEL;
+static uint32_t primask;
+
+static uint64_t tick_at, tick_last;  // nächster / letzter SysTick-Überlauf
+static uint8_t  tick_pending;
+
+static uint64_t dma_at;              // 0 = kein DMA unterwegs
+static uint8_t  dma_pending;
+static uint64_t spi_bytes;
+
+/* Quadratur: eingereihte Eingangsflanken, Eingangsfilter, TIM2-Zähler */
+typedef struct { uint64_t at; uint8_t ch; int8_t detent; } sim_edge_t;
+static sim_edge_t *edge_q;
+static uint32_t edge_head, edge_tail, edge_cap;
+static uint8_t  quad_in, quad_filt;  // Bit 0 = A, Bit 1 = B
+static uint8_t  quad_tail_in;        // Pegel nach der letzten eingereihten Flanke
+static uint64_t quad_acc_at[2];      // Filter übernimmt den Pegel (0 = nichts offen)
+static sim_quad_stats_t quad_stats;
+
+static uint64_t usb_in_free_at;
+static struct { uint64_t at; uint16_t len; uint8_t data[SIM_USB_MAX_LEN]; } usb_q[SIM_USB_QUEUE];
+static uint32_t usb_head, usb_tail;
+static uint8_t  usb_pending;
+static uint64_t usb_phase;           // Host-Frames (SOF) gegenüber SysTick versetzt
+
+static uint16_t keys_down;           // Bit je Matrix-Index
+static uint8_t  rotary_pin;          // 0 = OFF
+
+static sim_report_hook_t report_hook;
+static sim_detent_hook_t detent_hook;
+
+/* Pin-Belegung wie button_matrix.c / rotary_switch.c */
+static const uint16_t row_pins[4] = { GPIO_PIN_12, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_15 };
+static const uint16_t col_pins[4] = { GPIO_PIN_5,  GPIO_PIN_6,  GPIO_PIN_7,  GPIO_PIN_8  };
+static const struct { GPIO_TypeDef *port; uint16_t pin; } rotary_pins[7] = {
+    { NULL, 0 },
+    { GPIOB, GPIO_PIN_1  }, { GPIOB, GPIO_PIN_11 }, { GPIOB, GPIO_PIN_10 },
+    { GPIOA, GPIO_PIN_10 }, { GPIOA, GPIO_PIN_9  }, { GPIOA, GPIO_PIN_8  },
+};
+
+/* ================================================================== */
+/* Interrupt-Rümpfe (wie stm32f1xx_it.c / usbd_custom_hid_if.c)        */
+/* ================================================================== */
+
+extern void encoder_1ms_poll(void);
+
+static void isr_systick(void)
+{
+    XHC_PROF_SYSTICK_LATENCY();
+    HAL_IncTick();
+    encoder_1ms_poll();
+}
+
+static void isr_dma(void)
+{
+    HAL_SPI_TxCpltCallback(&hspi1);
+}
+
+static void isr_usb(void)
+{
+    while (usb_tail != usb_head && usb_q[usb_tail % SIM_USB_QUEUE].at <= now) {
+        uint8_t *report = usb_q[usb_tail % SIM_USB_QUEUE].data;
+        uint16_t len    = usb_q[usb_tail % SIM_USB_QUEUE].len;
+        if (len >= 8 && report[0] == 0x06) {
+            xhc_recv_isr(&report[1]);
+        } else if (report[0] == XHC_DIAG_REPORT_ID) {
+            xhc_diag_set_report(report, len);
+        }
+        usb_tail++;
+    }
+}
+
+static void isr_pendsv(void)
+{
+    xhc_irq_pendsv();
+}
+
+/* ================================================================== */
+/* Ereignisse und Verteilung                                           */
+/* ================================================================== */
+
+/* Gray-Index 00 -> 10 -> 11 -> 01 (A eilt vor = vorwärts) */
+static uint8_t quad_index(uint8_t ab)
+{
+    static const uint8_t idx[4] = { 0, 1, 3, 2 };   // ab = A | B<<1
+    return idx[ab & 3u];
+}
+
+/* Eingangsflanke: Pegel kippen, Filter neu aufziehen (IC1F/IC2F, N Abtastungen) */
+static void quad_input_edge(const sim_edge_t *e)
+{
+    uint8_t m = (uint8_t)(1u << e->ch);
+    quad_in ^= m;
+    quad_stats.edges++;
+    if ((quad_in & m) == (quad_filt & m)) {
+        quad_acc_at[e->ch] = 0;              // Puls kürzer als der Filter: verschluckt
+        quad_stats.filtered++;
+    } else {
+        quad_acc_at[e->ch] = e->at + SIM_ENC_FILTER_CYCLES;
+    }
+    if (e->detent && detent_hook) detent_hook(e->at, e->detent);
+}
+
+/* Gefilterter Pegelwechsel: Encoder-Modus TI12 zählt jede Flanke beider Kanäle */
+static void quad_accept(uint8_t ch)
+{
+    uint8_t old = quad_index(quad_filt);
+    quad_filt ^= (uint8_t)(1u << ch);
+    quad_acc_at[ch] = 0;
+    switch ((quad_index(quad_filt) - old) & 3u) {
+        case 1: sim_tim2.CNT = (uint16_t)(sim_tim2.CNT + 1u); quad_stats.counts++; break;
+        case 3: sim_tim2.CNT = (uint16_t)(sim_tim2.CNT - 1u); quad_stats.counts--; break;
+        default: break;
+    }
+}
+
+/* Frühestes Quadratur-Ereignis (Eingangsflanke oder Filterende), 0 = keins */
+static uint64_t quad_next(void)
+{
+    uint64_t t = (edge_tail != edge_head) ? edge_q[edge_tail].at : 0;
+    for (uint8_t ch = 0; ch < 2; ch++) {
+        if (quad_acc_at[ch] && (!t || quad_acc_at[ch] < t)) t = quad_acc_at[ch];
+    }
+    return t;
+}
+
+static void quad_events(void)
+{
+    for (uint64_t t = quad_next(); t && t <= now; t = quad_next()) {
+        if (quad_acc_at[0] == t)      quad_accept(0);
+        else if (quad_acc_at[1] == t) quad_accept(1);
+        else                          quad_input_edge(&edge_q[edge_tail++]);
+    }
+    if (edge_tail == edge_head) edge_tail = edge_head = 0;
+}
+
+/* Fällige Hardware-Ereignisse übernehmen (setzt Pending-Bits) */
+static void sim_events(void)
+{
+    while (tick_at <= now) {
+        tick_pending = 1;             // mehrere verpasste Ticks = ein Pending-Bit
+        tick_last = tick_at;
+        tick_at += SIM_TICK_CYCLES;
+    }
+    if (dma_at && dma_at <= now) {
+        dma_at = 0;
+        dma_pending = 1;
+    }
+    quad_events();
+    if (usb_tail != usb_head && usb_q[usb_tail % SIM_USB_QUEUE].at <= now) {
+        usb_pending = 1;
+    }
+}
+
+static uint64_t sim_next_event(void)
+{
+    uint64_t t = tick_at;
+    if (dma_at && dma_at < t) t = dma_at;
+    uint64_t q = quad_next();
+    if (q && q < t) t = q;
+    if (!usb_pending && usb_tail != usb_head && usb_q[usb_tail % SIM_USB_QUEUE].at < t) {
+        t = usb_q[usb_tail % SIM_USB_QUEUE].at;
+    }
+    return t;
+}
+
+static inline void sim_spend(uint64_t cycles);
+
+/* Eintritt, Rumpf, dann die Kosten des Rumpfs auf der Stufe der ISR */
+static void run_isr(int level, void (*fn)(void), uint32_t cost)
+{
+    int saved = cur_level;
+    cur_level = level;
+    next_at = 0;                      // ISR kann DMA starten, USB-Warteschlange weiterschalten
+    sim_spend(SIM_ISR_ENTRY_CYCLES);
+    fn();
+    sim_spend(cost);
+    next_at = 0;
+    cur_level = saved;
+}
+
+/* Anstehende IRQs nach Priorität ausführen, soweit PRIMASK/Stufe es erlauben */
+static void sim_dispatch(void)
+{
+    while (!primask) {
+        if (tick_pending && (int)XHC_IRQ_PRIO_TICK < cur_level) {
+            tick_pending = 0;
+            run_isr(XHC_IRQ_PRIO_TICK, isr_systick, SIM_ISR_TICK_CYCLES);
+        } else if (dma_pending && (int)XHC_IRQ_PRIO_DMA < cur_level) {
+            dma_pending = 0;
+            run_isr(XHC_IRQ_PRIO_DMA, isr_dma, SIM_ISR_DMA_CYCLES);
+        } else if (usb_pending && (int)XHC_IRQ_PRIO_USB < cur_level) {
+            usb_pending = 0;
+            run_isr(XHC_IRQ_PRIO_USB, isr_usb, SIM_ISR_USB_CYCLES);
+        } else if ((sim_scb.ICSR & SCB_ICSR_PENDSVSET_Msk) && (int)XHC_IRQ_PRIO_PENDSV < cur_level) {
+            sim_scb.ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+            run_isr(XHC_IRQ_PRIO_PENDSV, isr_pendsv, SIM_ISR_PENDSV_CYCLES);
+        } else {
+            break;
+        }
+    }
+}
+
+/* Weckt ein anstehender IRQ den Kern (PRIMASK zählt dabei nicht)? */
+static uint8_t sim_wake_pending(void)
+{
+    return (tick_pending && (int)XHC_IRQ_PRIO_TICK < cur_level)
+        || (dma_pending  && (int)XHC_IRQ_PRIO_DMA  < cur_level)
+        || (usb_pending  && (int)XHC_IRQ_PRIO_USB  < cur_level)
+        || ((sim_scb.ICSR & SCB_ICSR_PENDSVSET_Msk) && (int)XHC_IRQ_PRIO_PENDSV < cur_level);
+}
+
+static void sim_advance_to(uint64_t t)
+{
+    while (now < t) {
+        uint64_t ne = sim_next_event();
+        now = (ne < t) ? ne : t;
+        sim_events();
+        sim_dispatch();
+    }
+}
+
+static inline void sim_spend(uint64_t cycles) { sim_advance_to(now + cycles); }
+
+/* ================================================================== */
+/* Steuerung                                                           */
+/* ================================================================== */
+
+uint64_t sim_now(void) { return now; }
+
+void sim_reset(void)
+{
+    now = 0;
+    next_at = 0;
+    cur_level = SIM_THREAD_LEVEL;
+    primask = 0;
+    tick_at = SIM_TICK_CYCLES;
+    tick_last = 0;
+    tick_pending = dma_pending = usb_pending = 0;
+    dma_at = 0;
+    spi_bytes = 0;
+    edge_head = edge_tail = 0;
+    quad_in = quad_filt = quad_tail_in = 0;
+    quad_acc_at[0] = quad_acc_at[1] = 0;
+    memset(&quad_stats, 0, sizeof(quad_stats));
+    usb_in_free_at = 0;
+    usb_head = usb_tail = 0;
+    usb_phase = 0;
+    keys_down = 0;
+    rotary_pin = 0;
+    uwTick = 0;
+
+    memset(&sim_gpioa, 0, sizeof(sim_gpioa));
+    memset(&sim_gpiob, 0, sizeof(sim_gpiob));
+    sim_gpioa.IDR = sim_gpiob.IDR = 0xFFFFu;     // Pull-Ups
+    sim_gpioa.ODR = sim_gpiob.ODR = 0xFFFFu;
+    memset(&sim_tim2, 0, sizeof(sim_tim2));
+    memset(&sim_scb, 0, sizeof(sim_scb));
+    sim_systick_regs.LOAD = SIM_TICK_CYCLES - 1u;
+
+    hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16;   // wie spi.c
+    hspi1.hdmatx = &hdma_spi1_tx;
+}
+
+/**
+ * @brief Zurücksetzen und Firmware initialisieren, Reihenfolge wie USER CODE in main.c
+ */
+void sim_firmware_init(void)
+{
+    sim_reset();
+    HAL_Init();
+    xhc_prof_init();
+    xhc_trace_init(0);
+    ST7735_InitStart();
+    xhc_custom_hid_init();
+    encoder_init();
+    button_matrix_init();
+    rotary_switch_init();
+    xhc_main_tasks_init();
+    xhc_irq_check();
+}
+
+/**
+ * @brief Firmware-Hauptschleife bis zur virtuellen Zeit t_end laufen lassen
+ */
+void sim_run_until(uint64_t t_end)
+{
+    while (now < t_end) {
+        xhc_main_loop();
+    }
+}
+
+/**
+ * @brief Eingangsflanke auf Kanal A (0) oder B (1) einreihen
+ *
+ * Zeiten müssen aufsteigend kommen; frühere werden auf die letzte
+ * eingereihte Flanke angehoben.
+ */
+void sim_quad_edge(uint64_t at, uint8_t ch, int8_t detent)
+{
+    if (edge_head == edge_cap) {
+        edge_cap = edge_cap ? edge_cap * 2u : 4096u;
+        edge_q = realloc(edge_q, edge_cap * sizeof(*edge_q));
+        if (!edge_q) { fprintf(stderr, "sim: kein Speicher für Flanken\n"); exit(2); }
+    }
+    if (edge_head != edge_tail && at < edge_q[edge_head - 1u].at) at = edge_q[edge_head - 1u].at;
+    if (at < now) at = now;
+    edge_q[edge_head].at = at;
+    edge_q[edge_head].ch = ch & 1u;
+    edge_q[edge_head].detent = detent;
+    edge_head++;
+    quad_tail_in ^= (uint8_t)(1u << (ch & 1u));
+    next_at = 0;
+}
+
+uint8_t  sim_quad_input(void) { return quad_tail_in; }
+uint64_t sim_quad_last(void)  { return (edge_head != edge_tail) ? edge_q[edge_head - 1u].at : now; }
+const sim_quad_stats_t *sim_quad_stats(void) { return &quad_stats; }
+
+void sim_key(uint8_t index, uint8_t down)
+{
+    if (index >= 16) return;
+    if (down) keys_down |=  (uint16_t)(1u << index);
+    else      keys_down &= (uint16_t)~(1u << index);
+}
+
+void sim_rotary(uint8_t pin)
+{
+    rotary_pin = (pin <= 6) ? pin : 0;
+}
+
+/**
+ * @brief SET_REPORT vom Host einreihen; je Frame (1 ms) wird einer zugestellt
+ */
+void sim_host_report(const uint8_t *report, uint16_t len)
+{
+    sim_host_report_at(now, report, len);
+}
+
+/**
+ * @brief SET_REPORT für den Zeitpunkt at einreihen (Frame nach at, frühestens
+ *        einen Frame nach dem vorigen)
+ * @return Zustellzeitpunkt, 0 wenn die Warteschlange voll ist
+ */
+uint64_t sim_host_report_at(uint64_t at, const uint8_t *report, uint16_t len)
+{
+    if (usb_head - usb_tail >= SIM_USB_QUEUE) {
+        fprintf(stderr, "sim: USB-OUT-Warteschlange voll\n");
+        return 0;
+    }
+    if (at < now) at = now;
+    uint64_t frame = (at + SIM_TICK_CYCLES - usb_phase) / SIM_TICK_CYCLES * SIM_TICK_CYCLES + usb_phase;
+    if (usb_head != usb_tail) {
+        uint64_t last = usb_q[(usb_head - 1u) % SIM_USB_QUEUE].at + SIM_TICK_CYCLES;
+        if (last > frame) frame = last;
+    }
+    if (len > SIM_USB_MAX_LEN) len = SIM_USB_MAX_LEN;
+    usb_q[usb_head % SIM_USB_QUEUE].at  = frame;
+    usb_q[usb_head % SIM_USB_QUEUE].len = len;
+    memcpy(usb_q[usb_head % SIM_USB_QUEUE].data, report, len);
+    usb_head++;
+    next_at = 0;
+    return frame;
+}
+
+/**
+ * @brief Host-Frames um cycles hinter den SysTick legen (Standard 0 = gleichzeitig)
+ *
+ * SOF des Hosts und SysTick laufen auf dem Gerät frei gegeneinander; ein
+ * Versatz kurz vor dem Tick lässt den USB-IRQ in den Tick hineinlaufen.
+ */
+void sim_usb_phase(uint32_t cycles) { usb_phase = cycles % SIM_TICK_CYCLES; }
+
+void     sim_on_report(sim_report_hook_t hook) { report_hook = hook; }
+void     sim_on_detent(sim_detent_hook_t hook) { detent_hook = hook; }
+uint64_t sim_spi_bytes(void) { return spi_bytes; }
+uint32_t sim_usb_out_pending(void) { return usb_head - usb_tail; }
+
+/* ================================================================== */
+/* HAL / CMSIS                                                          */
+/* ================================================================== */
+
+void sim_irq_disable(void)            { primask = 1; }
+/* Freigeben kostet SIM_MASKED_CYCLES noch unter der Sperre (sim_hal.h) */
+static void sim_unmask(void)
+{
+    if (primask) sim_spend(SIM_MASKED_CYCLES);
+    primask = 0;
+    sim_dispatch();
+}
+
+void sim_irq_enable(void)             { sim_unmask(); }
+uint32_t sim_irq_primask(void)        { return primask; }
+void sim_irq_set_primask(uint32_t v)  { if (v) primask = v; else sim_unmask(); }
+uint32_t sim_msp(void)                { return 0x20004F00u; }
+
+void sim_wfi(void)
+{
+    if (sim_wake_pending()) {
+        sim_dispatch();
+        return;
+    }
+    sim_advance_to(sim_next_event());
+}
+
+/*
+ * NOP-Warteschleifen (ST_WaitDMA, Entprellpausen) rufen das sehr oft auf.
+ * Solange bis zum nächsten Ereignis nichts fällig ist und kein PendSV
+ * ansteht, kann sich nichts ändern: nur die Zeit weiterzählen. next_at
+ * wird ungültig, sobald eine Quelle ein früheres Ereignis einplanen kann.
+ */
+void sim_nop(void)
+{
+    uint64_t t = now + SIM_NOP_CYCLES;
+    if (t < next_at && !(sim_scb.ICSR & SCB_ICSR_PENDSVSET_Msk)) {
+        now = t;
+        return;
+    }
+    uint64_t ne = sim_next_event();
+    sim_advance_to(ne < t ? ne : t);
+    next_at = sim_next_event();
+}
+
+SysTick_Type *sim_systick(void)
+{
+    uint64_t since = now - tick_last;
+    sim_systick_regs.VAL = (uint32_t)(sim_systick_regs.LOAD - (since % SIM_TICK_CYCLES));
+    return &sim_systick_regs;
+}
+
+DWT_Type *sim_dwt(void)
+{
+    sim_dwt_regs.CYCCNT = (uint32_t)now;
+    return &sim_dwt_regs;
+}
+
+uint32_t HAL_NVIC_GetPriorityGrouping(void) { return NVIC_PRIORITYGROUP_2; }
+
+void HAL_NVIC_GetPriority(IRQn_Type IRQn, uint32_t PriorityGroup,
+                          uint32_t *pPreemptPriority, uint32_t *pSubPriority)
+{
+    (void)PriorityGroup;
+    switch (IRQn) {
+        case SysTick_IRQn:         *pPreemptPriority = XHC_IRQ_PRIO_TICK;   *pSubPriority = XHC_IRQ_SUB_TICK;   break;
+        case DMA1_Channel3_IRQn:   *pPreemptPriority = XHC_IRQ_PRIO_DMA;    *pSubPriority = XHC_IRQ_SUB_DMA;    break;
+        case USB_LP_CAN1_RX0_IRQn: *pPreemptPriority = XHC_IRQ_PRIO_USB;    *pSubPriority = XHC_IRQ_SUB_USB;    break;
+        case PendSV_IRQn:          *pPreemptPriority = XHC_IRQ_PRIO_PENDSV; *pSubPriority = XHC_IRQ_SUB_PENDSV; break;
+        default:                   *pPreemptPriority = 0; *pSubPriority = 0; break;
+    }
+}
+
+HAL_StatusTypeDef HAL_Init(void) { return HAL_OK; }
+void HAL_IncTick(void)           { uwTick++; }
+void HAL_DBGMCU_EnableDBGSleepMode(void) { }
+
+uint32_t HAL_GetTick(void)
+{
+    sim_spend(SIM_GETTICK_CYCLES);
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start = HAL_GetTick();
+    uint32_t wait = Delay;
+    if (wait < HAL_MAX_DELAY) wait++;
+    while ((HAL_GetTick() - start) < wait) {
+        sim_wfi();
+    }
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "sim: Error_Handler bei t=%.3f ms\n", (double)now / SIM_TICK_CYCLES);
+    exit(2);
+}
+
+/* ---- GPIO ---- */
+
+static void sim_update_inputs(void)
+{
+    sim_gpioa.IDR = 0xFFFFu;
+    sim_gpiob.IDR = 0xFFFFu;
+
+    for (uint8_t i = 0; i < 16; i++) {
+        if ((keys_down & (1u << i)) && !(sim_gpiob.ODR & row_pins[i / 4])) {
+            sim_gpiob.IDR &= ~(uint32_t)col_pins[i % 4];
+        }
+    }
+    if (rotary_pin) {
+        rotary_pins[rotary_pin].port->IDR &= ~(uint32_t)rotary_pins[rotary_pin].pin;
+    }
+}
+
+/* Pin-Modus spielt keine Rolle: SDA liest hier nie Panel-Daten, das
+ * Einmessen des Display-SPI bleibt deshalb beim CubeMX-Teiler */
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx; (void)GPIO_Init;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    sim_update_inputs();
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET) GPIOx->ODR |= GPIO_Pin;
+    else                          GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+}
+
+/* ---- TIM2 Encoder ---- */
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim, TIM_Encoder_InitTypeDef *sConfig)
+{
+    (void)sConfig;
+    htim->Instance->ARR = htim->Init.Period;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    (void)Channel;
+    htim->Instance->CR1 |= 1u;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+                                                        TIM_MasterConfigTypeDef *sMasterConfig)
+{
+    (void)htim; (void)sMasterConfig;
+    return HAL_OK;
+}
+
+/* ---- SPI / DMA ---- */
+
+static uint64_t spi_cycles(const SPI_HandleTypeDef *hspi, uint32_t bytes)
+{
+    uint32_t div = 2u << (hspi->Init.BaudRatePrescaler >> 3);
+    return (uint64_t)bytes * 8u * div;
+}
+
+/* Teiler steht in Init.BaudRatePrescaler, spi_cycles liest ihn direkt */
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)pData; (void)Timeout;
+    spi_bytes += Size;
+    sim_spend(spi_cycles(hspi, Size));
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+    (void)pData;
+    if (dma_at) return HAL_BUSY;
+    spi_bytes += Size;
+    dma_at = now + spi_cycles(hspi, Size);
+    next_at = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_PollForTransfer(DMA_HandleTypeDef *hdma, HAL_DMA_LevelCompleteTypeDef CompleteLevel,
+                                          uint32_t Timeout)
+{
+    (void)hdma; (void)CompleteLevel; (void)Timeout;
+    while (dma_at) {
+        sim_wfi();
+    }
+    return HAL_OK;
+}
+
+/* ---- USB IN ---- */
+
+uint8_t USBD_CUSTOM_HID_SendReport(USBD_HandleTypeDef *pdev, uint8_t *report, uint16_t len)
+{
+    (void)pdev;
+    if (now < usb_in_free_at) return USBD_BUSY;
+    usb_in_free_at = (now / SIM_TICK_CYCLES + 1u) * SIM_TICK_CYCLES;   // nächster Frame
+    if (report_hook) report_hook(now, report, len);
+    return USBD_OK;
+}
+
+/* OUT-Ring des ST-Stacks gibt es hier nicht, Host-Pakete gehen direkt an xhc_recv_isr */
+uint32_t XHC_RX_Dropped(void) { return 0; }
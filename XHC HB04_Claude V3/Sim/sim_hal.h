@@ -0,0 +1,84 @@
+/*
+ * XHC HB04 Host-Simulation: virtuelle Zeit, Interrupts, Peripherie
+ *
+ * Die Firmware-Module aus Core/Src und Drivers/ST7735 laufen unverändert
+ * gegen shim/stm32f1xx_hal.h. Zeit vergeht nur, wenn die Firmware wartet
+ * (WFI, __NOP, HAL_Delay, blockierendes SPI) oder HAL_GetTick fragt;
+ * reine Rechenzeit kostet nichts. Modelliert sind:
+ *
+ *   SysTick     1 ms, ruft HAL_IncTick + encoder_1ms_poll (wie stm32f1xx_it.c)
+ *   SPI/DMA     Dauer aus BaudRatePrescaler, DMA-Ende ruft HAL_SPI_TxCpltCallback
+ *   USB         OUT: ein SET_REPORT pro 1-ms-Frame; IN: Endpunkt bis zum
+ *               nächsten Frame belegt
+ *   PendSV      sobald SCB->ICSR PENDSVSET gesetzt ist
+ *   GPIO        Tastenmatrix (Zeilen treiben, Spalten lesen), Drehschalter
+ *   TIM2        Encoder-Modus TI12 hinter dem Eingangsfilter (IC1F/IC2F),
+ *               Flanken kommen aus sim_quad.c
+ *
+ * Prioritäten und Verschachtelung folgen dem Plan in xhc_irq.h.
+ */
+
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+#include <stdint.h>
+
+#define SIM_CPU_HZ        72000000u
+#define SIM_TICK_CYCLES   (SIM_CPU_HZ / 1000u)
+#define SIM_MS(ms)        ((uint64_t)(ms) * SIM_TICK_CYCLES)
+
+/* Eingangsfilter 0x4 aus encoder_init(): f_DTS/2, N = 6 -> 12 Zyklen (167 ns) */
+#define SIM_ENC_FILTER_CYCLES  12u
+
+/* Kosten der Warte-Primitive in Zyklen (halten Spin-Schleifen am Laufen) */
+#define SIM_NOP_CYCLES      16u
+#define SIM_GETTICK_CYCLES  16u
+
+/*
+ * Kosten der Interrupts in Zyklen. Rechenzeit ist sonst frei, ohne diese
+ * Werte wären alle IRQ-Latenzen 0 und eine falsche Stufe fiele nicht auf.
+ * Eintritt: Stacking des Cortex-M3. Rümpfe: Schätzwerte für -O2 mit HAL
+ * (auf dem Gerät: Profiler i_tick/i_dma/i_usb/i_psv). Sie laufen auf der
+ * Stufe der ISR, nur höhere Stufen kommen dazwischen. Eine PRIMASK-Sperre
+ * kostet beim Freigeben SIM_MASKED_CYCLES, plus jede Wartezeit darin.
+ */
+#define SIM_ISR_ENTRY_CYCLES   12u
+#define SIM_ISR_TICK_CYCLES    250u
+#define SIM_ISR_DMA_CYCLES     400u
+#define SIM_ISR_USB_CYCLES     2000u
+#define SIM_ISR_PENDSV_CYCLES  1500u
+#define SIM_MASKED_CYCLES      8u
+
+uint64_t sim_now(void);
+void     sim_reset(void);
+void     sim_firmware_init(void);
+void     sim_run_until(uint64_t t_end);
+
+/* ---- Reize ---- */
+void     sim_quad_edge(uint64_t at, uint8_t ch, int8_t detent);  // ch 0 = A, 1 = B; detent != 0: Rastung fertig
+uint8_t  sim_quad_input(void);                       // Pegel A|B<<1 nach allen eingereihten Flanken
+uint64_t sim_quad_last(void);                        // Zeit der letzten eingereihten Flanke
+void     sim_key(uint8_t index, uint8_t down);       // Matrix-Index 0..15 (Zeile*4 + Spalte)
+void     sim_rotary(uint8_t pin);                    // 0 = OFF, 1..6 = Schalter-Pin
+void     sim_host_report(const uint8_t *report, uint16_t len);   // SET_REPORT inkl. Report-ID
+uint64_t sim_host_report_at(uint64_t at, const uint8_t *report, uint16_t len);
+#define SIM_USB_QUEUE     64u                        // eingereihte SET_REPORTs
+void     sim_usb_phase(uint32_t cycles);             // Host-Frames gegenüber SysTick versetzen
+
+/* ---- Beobachtung ---- */
+typedef void (*sim_report_hook_t)(uint64_t t, const uint8_t *report, uint16_t len);
+typedef void (*sim_detent_hook_t)(uint64_t t, int8_t dir);
+
+void     sim_on_report(sim_report_hook_t hook);
+void     sim_on_detent(sim_detent_hook_t hook);
+uint64_t sim_spi_bytes(void);
+uint32_t sim_usb_out_pending(void);
+
+typedef struct {
+    uint32_t edges;         // Eingangsflanken A+B
+    uint32_t filtered;      // vom Eingangsfilter verschluckte Pulse
+    int32_t  counts;        // Netto-Zählschritte TIM2
+} sim_quad_stats_t;
+const sim_quad_stats_t *sim_quad_stats(void);
+
+#endif /* SIM_HAL_H */
@@ -0,0 +1,340 @@
+/*
+ * XHC HB04 Host-Simulation: Szenario-Läufer
+ *
+ *   ./build/xhc_sim [-r] [-t trace.bin] szenario.sim ...
+ *
+ *   -r   jeden IN-Report ausgeben
+ *   -t   am Ende den Trace-Ring (xhc_trace.h) als Speicherabzug schreiben,
+ *        lesbar mit Tools/xhc_diag.py trace --file trace.bin
+ *
+ * Ein Szenario ist eine Textdatei, eine Anweisung pro Zeile, '#' = Kommentar:
+ *
+ *   wait <ms>                  Firmware <ms> virtuell laufen lassen
+ *   spin <rastungen> <ms>      Handrad drehen (negativ = links), läuft parallel
+ *   key <0..15> down|up        Matrix-Taste (Zeile*4 + Spalte, button_matrix.c)
+ *   rotary off|x|y|z|spindle|feed|a
+ *   host [x=..] [y=..] [z=..] [mx=..] [my=..] [mz=..] [feed=..] [fovr=..]
+ *        [spindle=..] [sovr=..] [step=..] [state=..] [day=..]
+ *                              Host-Paket (0x06, 7-Byte-Chunks, 1 pro Frame)
+ *   usbphase <us>              Host-Frames so weit hinter den SysTick legen (Standard 0)
+ *   mark                       Statistik ab hier neu zählen (z.B. nach dem Boot)
+ *   expect wheel [==|<=|>=] <n>   Summe der gemeldeten Rad-Werte (nach Speed-Mapping)
+ *   expect key <code>          irgendein Report hatte btn_1 == code
+ *   expect mode <code>         wheel_mode des letzten Reports
+ *   expect misses [==|<=|>=] <n>  Deadline-Misses aller Scheduler-Tasks
+ *   expect latency [==|<=|>=] <us>  größte Latenz Rastung -> Report seit mark
+ *   expect jitter [==|<=|>=] <us>   Streuung Rastung -> Report (max - min) seit mark
+ *   expect tick [==|<=|>=] <us>     SysTick-Jitter, Profiler l_tick max - min seit mark
+ *   expect pendsv [==|<=|>=] <us>   größte Latenz xhc_irq_defer -> PendSV (l_psv) seit mark
+ *   expect sleep [==|<=|>=] <%>     Anteil der Zeit im Scheduler-WFI (Profiler m_wfi) seit mark
+ *   expect runs [==|<=|>=] <n>      Task-Aufrufe pro Sekunde seit mark
+ *   expect echo <us>           Firmware-Messung Rastung -> Echo (xhc_joglat, ab Start)
+ *                              gegen die Sim: gleiche Anzahl Echos und Timeouts,
+ *                              p50 und max auf <us> genau (siehe sim_stats.h)
+ *
+ * Ausgabe: IN-Reports, Latenz Rastung -> Report (p50/p99/max), dieselbe
+ * Strecke und das Host-Echo aus Sicht der Firmware (xhc_joglat.h),
+ * IRQ-Latenzen, Schlafanteil, SPI-Bytes, Scheduler-Misses und das
+ * Verhältnis virtuelle Zeit / Wanduhr.
+ * Exit-Code 1 wenn ein expect fehlschlägt.
+ * Latenz siehe sim_stats.h.
+ */
+
+#include "sim_hal.h"
+#include "sim_quad.h"
+#include "sim_stats.h"
+#include "xhc_main.h"
+#include "xhc_sched.h"
+#include "xhc_trace.h"
+#include "xhc_joglat.h"
+#include "xhc_profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint32_t sched_misses(void)
+{
+    uint32_t m = 0;
+    for (uint8_t i = 0; i < xhc_sched_task_count(); i++) m += xhc_sched_task(i)->misses;
+    return m;
+}
+
+/* "[==|<=|>=] n" gegen Istwert prüfen */
+static int compare(const char *rest, long actual, long *n)
+{
+    while (*rest == ' ' || *rest == '\t') rest++;
+    char op = '=';
+    if ((rest[0] == '<' || rest[0] == '>' || rest[0] == '=') && rest[1] == '=') {
+        op = rest[0];
+        rest += 2;
+    }
+    *n = strtol(rest, NULL, 0);
+    return (op == '<') ? (actual <= *n) : (op == '>') ? (actual >= *n) : (actual == *n);
+}
+
+/* ---- Host-Paket ---- */
+static void host_packet(char *args)
+{
+    struct whb04_out_data pkt;
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.magic = WHBxx_MAGIC;
+
+    static const char *axes[6] = { "x", "y", "z", "mx", "my", "mz" };
+    for (char *tok = strtok(args, " \t"); tok; tok = strtok(NULL, " \t")) {
+        char *eq = strchr(tok, '=');
+        if (!eq) continue;
+        *eq = 0;
+        const char *v = eq + 1;
+        int axis = -1;
+        for (int i = 0; i < 6; i++) if (!strcmp(tok, axes[i])) axis = i;
+        if (axis >= 0) {
+            double d = strtod(v, NULL);
+            double a = d < 0 ? -d : d;
+            uint32_t units = (uint32_t)(a * 10000.0 + 0.5);
+            pkt.pos[axis].p_int  = (uint16_t)(units / 10000u);
+            pkt.pos[axis].p_frac = (uint16_t)((units % 10000u) | (d < 0 ? 0x8000u : 0u));
+        }
+        else if (!strcmp(tok, "feed"))    pkt.feedrate     = (uint16_t)strtoul(v, NULL, 0);
+        else if (!strcmp(tok, "fovr"))    pkt.feedrate_ovr = (uint16_t)strtoul(v, NULL, 0);
+        else if (!strcmp(tok, "spindle")) pkt.sspeed       = (uint16_t)strtoul(v, NULL, 0);
+        else if (!strcmp(tok, "sovr"))    pkt.sspeed_ovr   = (uint16_t)strtoul(v, NULL, 0);
+        else if (!strcmp(tok, "step"))    pkt.step_mul     = (uint8_t)strtoul(v, NULL, 0);
+        else if (!strcmp(tok, "state"))   pkt.state        = (uint8_t)strtoul(v, NULL, 0);
+        else if (!strcmp(tok, "day"))     pkt.day          = (uint8_t)strtoul(v, NULL, 0);
+    }
+
+    const uint8_t *raw = (const uint8_t*)&pkt;
+    uint64_t done = 0;
+    for (uint16_t off = 0; off < sizeof(pkt); off += 7u) {
+        uint8_t rep[8] = { 0x06 };
+        uint16_t n = (uint16_t)((sizeof(pkt) - off) < 7u ? (sizeof(pkt) - off) : 7u);
+        memcpy(&rep[1], raw + off, n);
+        done = sim_host_report_at(sim_now(), rep, sizeof(rep));
+    }
+    if (done) sim_stats_host_packet(done);
+}
+
+/* Profiler-Eintrag seit mark in Zyklen: max oder (spread) max - min */
+static uint32_t prof_cycles(uint8_t id, uint8_t spread)
+{
+    xhc_prof_stat_t st;
+    if (!xhc_prof_snapshot(id, &st) || st.count == 0) return 0;
+    return spread ? st.max - st.min : st.max;
+}
+
+/* ... in us, aufgerundet: jede Verzögerung zählt mindestens 1 us */
+static uint32_t prof_us(uint8_t id, uint8_t spread)
+{
+    return (uint32_t)(((uint64_t)prof_cycles(id, spread) * 1000000u + SIM_CPU_HZ - 1u) / SIM_CPU_HZ);
+}
+
+/* Schlafanteil in Prozent und Task-Aufrufe/s seit mark */
+static uint32_t sleep_pct(void)
+{
+    xhc_prof_stat_t st;
+    uint64_t span = sim_now() - sim_stats.mark_at;
+    if (!span || !xhc_prof_snapshot(PROF_MAIN_SLEEP, &st)) return 0;
+    return (uint32_t)(st.sum * 100u / span);
+}
+
+static uint32_t runs_per_s(void)
+{
+    uint64_t span = sim_now() - sim_stats.mark_at, runs = 0;
+    for (uint8_t i = 0; i < xhc_sched_task_count(); i++) runs += xhc_sched_task(i)->runs;
+    return span ? (uint32_t)(runs * SIM_CPU_HZ / span) : 0;
+}
+
+/* |a - b| <= tol */
+static int within(uint32_t a, uint32_t b, long tol)
+{
+    long d = (long)a - (long)b;
+    return (d < 0 ? -d : d) <= tol;
+}
+
+/* ---- Szenario ---- */
+static int expect(const char *file, int line, char *args)
+{
+    char what[16];
+    long n = 0;
+    int ok;
+
+    if (sscanf(args, "%15s", what) != 1) return 1;
+    char *rest = strstr(args, what) + strlen(what);
+
+    if (!strcmp(what, "wheel")) {
+        ok = compare(rest, sim_stats.wheel_sum, &n);
+        if (!ok) fprintf(stderr, "%s:%d: Rad-Summe %d passt nicht zu %ld\n", file, line, (int)sim_stats.wheel_sum, n);
+    } else if (!strcmp(what, "key")) {
+        n = strtol(rest, NULL, 0);
+        ok = (n >= 0 && n < 256 && sim_stats.keys_seen[n]);
+        if (!ok) fprintf(stderr, "%s:%d: Taste 0x%02lX nie gemeldet\n", file, line, n);
+    } else if (!strcmp(what, "mode")) {
+        n = strtol(rest, NULL, 0);
+        ok = (sim_stats.last_mode == n);
+        if (!ok) fprintf(stderr, "%s:%d: mode 0x%02lX erwartet, 0x%02X gemeldet\n", file, line, n, sim_stats.last_mode);
+    } else if (!strcmp(what, "misses")) {
+        ok = compare(rest, (long)sched_misses(), &n);
+        if (!ok) fprintf(stderr, "%s:%d: %u Deadline-Misses (Grenze %ld)\n", file, line, sched_misses(), n);
+    } else if (!strcmp(what, "latency")) {
+        ok = compare(rest, (long)sim_stats_latency_us(100), &n);
+        if (!ok) fprintf(stderr, "%s:%d: Rastung->Report max %u us (Grenze %ld us)\n", file, line,
+                         sim_stats_latency_us(100), n);
+    } else if (!strcmp(what, "jitter")) {
+        uint32_t j = sim_stats_latency_us(100) - sim_stats_latency_us(0);
+        ok = compare(rest, (long)j, &n);
+        if (!ok) fprintf(stderr, "%s:%d: Rastung->Report Streuung %u us (Grenze %ld us)\n", file, line, j, n);
+    } else if (!strcmp(what, "tick")) {
+        uint32_t j = prof_us(PROF_LAT_SYSTICK, 1);
+        ok = compare(rest, (long)j, &n);
+        if (!ok) fprintf(stderr, "%s:%d: SysTick-Jitter %u us (Grenze %ld us)\n", file, line, j, n);
+    } else if (!strcmp(what, "pendsv")) {
+        uint32_t l = prof_us(PROF_LAT_PENDSV, 0);
+        ok = compare(rest, (long)l, &n);
+        if (!ok) fprintf(stderr, "%s:%d: defer->PendSV max %u us (Grenze %ld us)\n", file, line, l, n);
+    } else if (!strcmp(what, "sleep")) {
+        ok = compare(rest, (long)sleep_pct(), &n);
+        if (!ok) fprintf(stderr, "%s:%d: %u %% im WFI (Grenze %ld %%)\n", file, line, sleep_pct(), n);
+    } else if (!strcmp(what, "runs")) {
+        ok = compare(rest, (long)runs_per_s(), &n);
+        if (!ok) fprintf(stderr, "%s:%d: %u Task-Aufrufe/s (Grenze %ld)\n", file, line, runs_per_s(), n);
+    } else if (!strcmp(what, "echo")) {
+        xhc_joglat_update();
+        const xhc_joglat_stats_t *jl = xhc_joglat_stats();
+        const xhc_joglat_pct_t *fw = &jl->pct[JOGLAT_ENC_ECHO];
+        uint32_t p50 = sim_stats_echo_us(50), max = sim_stats_echo_us(100);
+        n = strtol(rest, NULL, 0);
+        ok = jl->echoes == sim_stats_echo_count() && jl->timeouts == sim_stats_echo_timeouts()
+          && within(fw->p50, p50, n) && within(fw->max, max, n);
+        if (!ok) fprintf(stderr, "%s:%d: FW Echo %u/%u Timeouts, p50 %u max %u us; "
+                         "Sim %u/%u, p50 %u max %u us (Toleranz %ld us)\n", file, line,
+                         jl->echoes, jl->timeouts, fw->p50, fw->max,
+                         sim_stats_echo_count(), sim_stats_echo_timeouts(), p50, max, n);
+    } else {
+        fprintf(stderr, "%s:%d: unbekanntes expect '%s'\n", file, line, what);
+        ok = 0;
+    }
+    return ok ? 0 : 1;
+}
+
+static int run_scenario(const char *file)
+{
+    static const char *rotary_names[7] = { "off", "x", "y", "z", "spindle", "feed", "a" };
+    FILE *f = fopen(file, "r");
+    if (!f) { perror(file); return 1; }
+
+    char buf[256];
+    int line = 0, failed = 0;
+    while (fgets(buf, sizeof(buf), f)) {
+        line++;
+        char *c = strchr(buf, '#');
+        if (c) *c = 0;
+        char cmd[16];
+        if (sscanf(buf, "%15s", cmd) != 1) continue;
+        char *args = strstr(buf, cmd) + strlen(cmd);
+
+        if (!strcmp(cmd, "wait")) {
+            sim_run_until(sim_now() + SIM_MS(strtoul(args, NULL, 0)));
+        } else if (!strcmp(cmd, "spin")) {
+            long det = 0, ms = 0;
+            sscanf(args, "%ld %ld", &det, &ms);
+            sim_quad_spin((int32_t)det, (uint32_t)ms);
+        } else if (!strcmp(cmd, "key")) {
+            int idx = 0;
+            char state[8] = "down";
+            sscanf(args, "%d %7s", &idx, state);
+            sim_key((uint8_t)idx, strcmp(state, "up") != 0);
+        } else if (!strcmp(cmd, "rotary")) {
+            char name[16] = "off";
+            sscanf(args, "%15s", name);
+            uint8_t pin = 0;
+            for (uint8_t i = 0; i < 7; i++) if (!strcmp(name, rotary_names[i])) pin = i;
+            sim_rotary(pin);
+        } else if (!strcmp(cmd, "usbphase")) {
+            sim_usb_phase((uint32_t)(strtoul(args, NULL, 0) * (SIM_CPU_HZ / 1000000u)));
+        } else if (!strcmp(cmd, "mark")) {
+            sim_stats_mark();
+        } else if (!strcmp(cmd, "host")) {
+            host_packet(args);
+        } else if (!strcmp(cmd, "expect")) {
+            failed |= expect(file, line, args);
+        } else {
+            fprintf(stderr, "%s:%d: unbekannte Anweisung '%s'\n", file, line, cmd);
+            failed = 1;
+        }
+    }
+    fclose(f);
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    int failed = 0;
+    int first = 1;
+    uint8_t verbose = 0;
+    const char *trace_file = NULL;
+
+    for (; first < argc && argv[first][0] == '-'; first++) {
+        if (!strcmp(argv[first], "-r")) {
+            verbose = 1;
+        } else if (!strcmp(argv[first], "-t") && first + 1 < argc) {
+            trace_file = argv[++first];
+        } else {
+            break;
+        }
+    }
+    if (first >= argc || argv[first][0] == '-') {
+        fprintf(stderr, "Aufruf: %s [-r] [-t trace.bin] szenario.sim ...\n", argv[0]);
+        return 2;
+    }
+
+    sim_stats_attach(verbose);
+    sim_firmware_init();
+
+    struct timespec w0, w1;
+    clock_gettime(CLOCK_MONOTONIC, &w0);
+    for (int i = first; i < argc; i++) {
+        failed |= run_scenario(argv[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &w1);
+
+    double virt_ms = (double)sim_now() / SIM_TICK_CYCLES;
+    double wall_ms = (w1.tv_sec - w0.tv_sec) * 1e3 + (w1.tv_nsec - w0.tv_nsec) / 1e6;
+
+    printf("virtuell        %10.1f ms  (Wanduhr %.1f ms, x%.0f)\n",
+           virt_ms, wall_ms, wall_ms > 0 ? virt_ms / wall_ms : 0.0);
+    printf("IN-Reports      %10u      Rad-Summe %+d\n", sim_stats.reports, (int)sim_stats.wheel_sum);
+    printf("Rastung->Report %10u      p50 %u us  p99 %u us  max %u us\n", sim_stats_latency_count(),
+           sim_stats_latency_us(50), sim_stats_latency_us(99), sim_stats_latency_us(100));
+    printf("Rastung->Echo   %10u      p50 %u us  max %u us  (Timeouts %u)\n", sim_stats_echo_count(),
+           sim_stats_echo_us(50), sim_stats_echo_us(100), sim_stats_echo_timeouts());
+    /* Gegenprobe: Messung der Firmware selbst (ab Start, ohne mark) */
+    xhc_joglat_update();
+    const xhc_joglat_stats_t *jl = xhc_joglat_stats();
+    printf("FW Rastung->IN  %10u      p50 %u us  p99 %u us  max %u us\n", jl->reports,
+           jl->pct[JOGLAT_ENC_USB].p50, jl->pct[JOGLAT_ENC_USB].p99, jl->pct[JOGLAT_ENC_USB].max);
+    printf("FW Rastung->Echo%10u      p50 %u us  p99 %u us  max %u us  (Timeouts %u)\n", jl->echoes,
+           jl->pct[JOGLAT_ENC_ECHO].p50, jl->pct[JOGLAT_ENC_ECHO].p99, jl->pct[JOGLAT_ENC_ECHO].max,
+           jl->timeouts);
+    printf("SysTick-Jitter  %10.2f us   defer->PendSV max %.2f us\n",
+           prof_cycles(PROF_LAT_SYSTICK, 1) * 1e6 / SIM_CPU_HZ, prof_cycles(PROF_LAT_PENDSV, 0) * 1e6 / SIM_CPU_HZ);
+    printf("Schlaf (WFI)    %10u %%    Task-Aufrufe %u/s\n", sleep_pct(), runs_per_s());
+    printf("SPI             %10llu B\n", (unsigned long long)(sim_spi_bytes() - sim_stats.spi_base));
+    printf("Deadline-Misses %10u     ", sched_misses());
+    for (uint8_t i = 0; i < xhc_sched_task_count(); i++) {
+        const xhc_task_t *t = xhc_sched_task(i);
+        printf(" %s %u/%ums", t->name, t->misses, t->max_late_ms);
+    }
+    printf("\n");
+
+    if (trace_file) {
+        FILE *f = fopen(trace_file, "wb");
+        if (!f || fwrite(&xhc_trace_buf, sizeof(xhc_trace_buf), 1, f) != 1) {
+            perror(trace_file);
+            failed = 1;
+        }
+        if (f) fclose(f);
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * XHC HB04 Host-Simulation: Quadratur-Generator
+ * siehe sim_quad.h
+ */
+
+#include "sim_quad.h"
+#include "sim_hal.h"
+
+#define NS_TO_CYCLES(ns)  ((uint64_t)(ns) * (SIM_CPU_HZ / 1000000u) / 1000u)
+
+static uint32_t rng_state;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Gray-Index aus dem Pegel (A | B<<1), Reihenfolge wie sim_hal.c */
+static uint8_t gray_index(uint8_t ab)
+{
+    static const uint8_t idx[4] = { 0, 1, 3, 2 };
+    return idx[ab & 3u];
+}
+
+/**
+ * @brief Profil ab der letzten eingereihten Flanke (bzw. jetzt) abspielen
+ * @return Zeitpunkt der letzten erzeugten Flanke
+ *
+ * Vorwärts kippt im Gray-Index k der Kanal A bei geradem k, sonst B;
+ * rückwärts genau umgekehrt. Prellpulse liegen direkt hinter der echten
+ * Flanke und belegen höchstens die halbe Lücke bis zur nächsten.
+ */
+uint64_t sim_quad_play(const sim_quad_profile_t *p, uint32_t seed)
+{
+    int8_t   dir = (p->detents < 0) ? -1 : 1;
+    uint32_t n = (uint32_t)(p->detents * dir);
+    uint64_t t = sim_quad_last();
+    uint64_t w = NS_TO_CYCLES(p->bounce_ns);
+    if (w == 0) w = 1;
+
+    rng_state = seed ? seed : 0x2545F491u;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = p->v0;
+        if (n > 1) v = (uint32_t)((int64_t)p->v0 + ((int64_t)p->v1 - p->v0) * i / (n - 1u));
+        if (v == 0) v = 1;
+        uint64_t iv = SIM_CPU_HZ / (4u * v);
+
+        for (uint8_t e = 0; e < 4; e++) {
+            uint64_t gap = iv;
+            if (p->jitter_pct) {
+                int64_t j = (int64_t)(gap * p->jitter_pct / 100u);
+                gap = (uint64_t)((int64_t)gap + (int64_t)(rng_next() % (uint32_t)(2 * j + 1)) - j);
+                if (gap == 0) gap = 1;
+            }
+            t += gap;
+
+            uint8_t k  = gray_index(sim_quad_input());
+            uint8_t ch = (dir > 0) ? (k & 1u) : ((k + 1u) & 1u);
+            sim_quad_edge(t, ch, (e == 3) ? dir : 0);
+
+            uint8_t pulses = p->bounce;
+            while (pulses && 2u * w * pulses > gap / 2u) pulses--;
+            for (uint8_t b = 0; b < pulses; b++) {
+                sim_quad_edge(t + (2u * b + 1u) * w, ch, 0);
+                sim_quad_edge(t + (2u * b + 2u) * w, ch, 0);
+            }
+        }
+    }
+    return t;
+}
+
+/**
+ * @brief Gleichmäßig drehen: detents Rastungen über ms Millisekunden
+ */
+void sim_quad_spin(int32_t detents, uint32_t ms)
+{
+    uint32_t n = (uint32_t)(detents < 0 ? -detents : detents);
+    if (n == 0) return;
+    uint32_t v = ms ? (uint32_t)((uint64_t)n * 1000u / ms) : 1000u;
+    sim_quad_profile_t p = { .detents = detents, .v0 = v, .v1 = v };
+    sim_quad_play(&p, 0);
+}
@@ -0,0 +1,25 @@
+/*
+ * XHC HB04 Host-Simulation: Quadratur-Generator für das Handrad
+ *
+ * Erzeugt A/B-Flanken mit vorgegebener Geschwindigkeit, Beschleunigung,
+ * Flankenjitter und Kontaktprellen und reiht sie über sim_quad_edge() ein.
+ * Der TIM2-Zähler in sim_hal.c sieht sie hinter dem Eingangsfilter.
+ */
+
+#ifndef SIM_QUAD_H
+#define SIM_QUAD_H
+
+#include <stdint.h>
+
+typedef struct {
+    int32_t  detents;        // Rastungen, Vorzeichen = Richtung
+    uint32_t v0, v1;         // Rastungen/s an erster und letzter Rastung (linear dazwischen)
+    uint8_t  bounce;         // Prellpulse nach jeder Flanke
+    uint32_t bounce_ns;      // Breite eines Prellpulses (und der Lücke danach)
+    uint8_t  jitter_pct;     // Flankenabstand zufällig um +-jitter_pct % verschoben
+} sim_quad_profile_t;
+
+uint64_t sim_quad_play(const sim_quad_profile_t *p, uint32_t seed);
+void     sim_quad_spin(int32_t detents, uint32_t ms);
+
+#endif /* SIM_QUAD_H */
@@ -0,0 +1,162 @@
+/*
+ * XHC HB04 Host-Simulation: Auswertung der IN-Reports
+ * siehe sim_stats.h
+ */
+
+#include "sim_stats.h"
+#include "sim_hal.h"
+#include "xhc_sched.h"
+#include "xhc_joglat.h"
+#include "xhc_profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_DETENTS   65536u
+#define MAX_ECHOES    256u
+#define ECHO_TIMEOUT  ((uint64_t)XHC_JOGLAT_ECHO_TIMEOUT_MS * SIM_TICK_CYCLES)
+
+sim_stats_t sim_stats;
+
+static uint8_t  verbose_reports;
+static uint64_t detent_t[MAX_DETENTS];      // Zeitpunkte noch nicht gemeldeter Rastungen
+static uint32_t detent_head, detent_tail;
+static int8_t   detent_dir;
+static uint32_t detent_dropped;             // durch Richtungswechsel verfallen
+static uint32_t *lat_us;                    // Latenz je gemeldeter Rastung
+static uint32_t lat_n, lat_cap;
+static uint8_t  lat_sorted;
+static uint64_t echo_detent_t;              // erste Rastung ohne Echo, 0 = keine offen
+static uint32_t echo_us[MAX_ECHOES];
+static uint32_t echo_n, echo_timeouts;
+
+static void on_detent(uint64_t t, int8_t dir)
+{
+    sim_stats.detents++;
+    if (echo_detent_t && t - echo_detent_t >= ECHO_TIMEOUT) {
+        echo_timeouts++;
+        echo_detent_t = 0;
+    }
+    if (!echo_detent_t) echo_detent_t = t;
+
+    if (dir != detent_dir) {                // Richtungswechsel: alte Rastungen heben sich auf
+        detent_dropped += detent_head - detent_tail;
+        detent_tail = detent_head;
+        detent_dir = dir;
+    }
+    if (detent_head - detent_tail < MAX_DETENTS) {
+        detent_t[detent_head++ % MAX_DETENTS] = t;
+    }
+}
+
+static void on_report(uint64_t t, const uint8_t *r, uint16_t len)
+{
+    if (len < 6) return;
+    int8_t wheel = (int8_t)r[4];
+    uint8_t mag = (uint8_t)(wheel < 0 ? -wheel : wheel);
+
+    sim_stats.reports++;
+    sim_stats.wheel_sum += wheel;
+    sim_stats.wheel_abs += mag;
+    if (mag > sim_stats.wheel_peak) sim_stats.wheel_peak = mag;
+    sim_stats.last_mode = r[3];
+    sim_stats.keys_seen[r[1]] = 1;
+
+    while (wheel != 0 && detent_tail != detent_head) {
+        uint64_t dt = t - detent_t[detent_tail++ % MAX_DETENTS];
+        if (lat_n == lat_cap) {
+            lat_cap = lat_cap ? lat_cap * 2u : 1024u;
+            lat_us = realloc(lat_us, lat_cap * sizeof(*lat_us));
+        }
+        lat_us[lat_n++] = (uint32_t)(dt * 1000000u / SIM_CPU_HZ);
+        lat_sorted = 0;
+    }
+
+    if (verbose_reports) {
+        printf("%10.3f ms  IN btn=%02X/%02X mode=%02X wheel=%+d\n",
+               (double)t / SIM_TICK_CYCLES, r[1], r[2], r[3], wheel);
+    }
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void sim_stats_attach(uint8_t verbose)
+{
+    verbose_reports = verbose;
+    sim_on_report(on_report);
+    sim_on_detent(on_detent);
+}
+
+/**
+ * @brief Statistik ab jetzt neu zählen (inkl. Scheduler-Misses und Profiler)
+ */
+void sim_stats_mark(void)
+{
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    sim_stats.spi_base = sim_spi_bytes();
+    sim_stats.mark_at = sim_now();
+    xhc_sched_reset_stats();
+    xhc_prof_reset();
+    detent_tail = detent_head;
+    detent_dropped = 0;
+    lat_n = 0;
+    echo_detent_t = 0;
+    echo_n = echo_timeouts = 0;
+}
+
+uint32_t sim_stats_latency_count(void)
+{
+    return lat_n;
+}
+
+uint32_t sim_stats_unreported(void)
+{
+    return detent_dropped + (detent_head - detent_tail);
+}
+
+uint32_t sim_stats_latency_us(uint32_t pct)
+{
+    if (lat_n == 0) return 0;
+    if (!lat_sorted) {
+        qsort(lat_us, lat_n, sizeof(*lat_us), cmp_u32);
+        lat_sorted = 1;
+    }
+    uint32_t i = (uint32_t)(((uint64_t)lat_n * pct + 99u) / 100u);
+    return lat_us[i ? i - 1u : 0u];
+}
+
+void sim_stats_host_packet(uint64_t done)
+{
+    if (!echo_detent_t) return;
+    if (done - echo_detent_t >= ECHO_TIMEOUT) {
+        echo_timeouts++;
+    } else if (echo_n < MAX_ECHOES) {
+        echo_us[echo_n++] = (uint32_t)((done - echo_detent_t) * 1000000u / SIM_CPU_HZ);
+    }
+    echo_detent_t = 0;
+}
+
+uint32_t sim_stats_echo_count(void)
+{
+    return echo_n;
+}
+
+uint32_t sim_stats_echo_timeouts(void)
+{
+    uint8_t open = echo_detent_t && sim_now() - echo_detent_t >= ECHO_TIMEOUT;
+    return echo_timeouts + open;
+}
+
+/* Rang wie xhc_joglat (lat_percentiles), damit beide Seiten vergleichbar sind */
+uint32_t sim_stats_echo_us(uint32_t pct)
+{
+    if (echo_n == 0) return 0;
+    uint32_t v[MAX_ECHOES];
+    memcpy(v, echo_us, echo_n * sizeof(*v));
+    qsort(v, echo_n, sizeof(*v), cmp_u32);
+    return v[(echo_n - 1u) * pct / 100u];
+}
@@ -0,0 +1,47 @@
+/*
+ * XHC HB04 Host-Simulation: Auswertung der IN-Reports
+ *
+ * Hängt sich an sim_on_report/sim_on_detent und zählt Reports, Rad-Werte,
+ * Tasten und die Latenz Rastung -> Report. Ein Report mit Rad-Wert != 0
+ * gilt als Meldung aller bis dahin aufgelaufenen Rastungen
+ * (task_usb_report leert den Akkumulator komplett). Rastungen, die noch im
+ * 1-ms-Puffer stecken, werden dabei eine Report-Periode zu früh verbucht -
+ * die Werte sind also eher zu optimistisch.
+ *
+ * Echo (Gegenprobe zu xhc_joglat): das erste Host-Paket nach einer Rastung
+ * gilt als deren Echo, gemessen bis zur Zustellung des letzten Chunks.
+ * Das stimmt nur für Szenarien, die wie echo.sim einzelne Rastungen aus
+ * der Ruhe drehen und jede Antwort selbst skripten. Kommt binnen
+ * XHC_JOGLAT_ECHO_TIMEOUT_MS kein Paket, zählt die Rastung als Timeout.
+ */
+
+#ifndef SIM_STATS_H
+#define SIM_STATS_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t reports;           // IN-Reports
+    int32_t  wheel_sum;         // Summe der Rad-Werte (nach Speed-Mapping)
+    uint32_t wheel_abs;         // Summe |Rad-Wert|
+    uint8_t  wheel_peak;        // größter |Rad-Wert|
+    uint8_t  last_mode;         // wheel_mode des letzten Reports
+    uint32_t detents;           // Rastungen am Eingang
+    uint64_t spi_base;          // sim_spi_bytes() beim letzten mark
+    uint64_t mark_at;           // sim_now() beim letzten mark
+    uint8_t  keys_seen[256];    // btn_1-Codes
+} sim_stats_t;
+
+extern sim_stats_t sim_stats;
+
+void     sim_stats_attach(uint8_t verbose);
+void     sim_stats_mark(void);
+uint32_t sim_stats_latency_count(void);
+uint32_t sim_stats_unreported(void);            // Rastungen ohne zugehörigen Report
+uint32_t sim_stats_latency_us(uint32_t pct);     // Perzentil, 100 = Maximum
+void     sim_stats_host_packet(uint64_t done);   // Host-Paket komplett zugestellt
+uint32_t sim_stats_echo_count(void);
+uint32_t sim_stats_echo_timeouts(void);
+uint32_t sim_stats_echo_us(uint32_t pct);        // Perzentil, 100 = Maximum
+
+#endif /* SIM_STATS_H */
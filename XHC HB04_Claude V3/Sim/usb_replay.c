@@ -0,0 +1,379 @@
+/*
+ * XHC HB04 Host-Simulation: usbmon-Mitschnitt in den Empfangspfad einspielen
+ *
+ *   ./build/xhc_replay [-p] [-v] [-x faktor] mitschnitt.(txt|pcap)
+ *
+ *   -p          Zeile je Paket ausgeben
+ *   -v          Firmware-Ausgaben (printf) zeigen
+ *   -x faktor   Zeitachse stauchen (2 = doppelt so schnell wie aufgenommen)
+ *
+ * Eingabe: usbmon-Text (/sys/kernel/debug/usb/usbmon/<bus>u) oder pcap mit
+ * Linktyp USB_LINUX (189) / USB_LINUX_MMAPPED (220), z.B. von
+ * "tcpdump -i usbmon1 -w x.pcap" oder Wireshark (als pcap, nicht pcapng
+ * speichern). Verwendet werden nur SET_REPORT-Control-Transfers mit
+ * Report-ID 6 (Feature oder Output), also die 7-Byte-Chunks des Host-Pakets.
+ *
+ * Jeder Chunk geht zum aufgezeichneten Zeitpunkt über den simulierten
+ * USB-IRQ (xhc_recv_isr, wie CUSTOM_HID_OutEvent_FS) -> PendSV -> xhc_recv
+ * -> UI-Task. Pro Host-Paket (Magic 0xFDFE bis zum nächsten Magic) werden
+ * gezählt:
+ *
+ *   UI-Zyklen    Summe PROF_MAIN_UI; im Host-Build nur die Wartezeit auf
+ *                SPI/DMA, reine Rechenzeit kostet nichts (sim_hal.h). Auf
+ *                dem Target ist das der Großteil der Kosten eines Pakets.
+ *   SPI-Bytes    ans Display geschickt
+ *   Koord./Status  Aufrufe xhc_ui_update_coordinates / _status_bar
+ *
+ * Duplikate: Paket-Nutzdaten identisch mit dem vorigen Paket.
+ *
+ * SET_REPORT ist auf dem Host synchron: ein Chunk geht erst raus, wenn der
+ * vorige zugestellt ist (ein Transfer je 1-ms-Frame). Mit -x kann die
+ * Wiedergabe dadurch hinter der Aufnahme zurückfallen; Chunks, die
+ * später als im Frame nach ihrem Aufnahmezeitpunkt ankommen, stehen als
+ * "verzögert" in der Zusammenfassung.
+ */
+
+#include "sim_hal.h"
+#include "sim_stats.h"
+#include "xhc_profiler.h"
+#include "xhc_main.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CHUNK_LEN        8u          // Report-ID + 7 Byte
+#define PKT_MAX_CHUNKS   8u
+#define LOOKAHEAD        SIM_MS(100) // so weit im Voraus einreihen (> längste UI-Blockade)
+
+typedef struct { uint64_t t_us; uint8_t d[CHUNK_LEN]; } chunk_t;
+
+static chunk_t  *chunks;
+static uint32_t  n_chunks, cap_chunks;
+
+/* Ein Wert je Paket, für Perzentile */
+typedef struct { uint32_t *v; uint32_t n; uint64_t sum; } series_t;
+
+enum { S_UI, S_SPI, S_COORD, S_STATUS, S_COUNT };
+static series_t series[S_COUNT];
+static const char *series_name[S_COUNT] = { "UI-Zyklen", "SPI-Bytes", "Koord.", "Status" };
+static FILE *out;
+
+/* ------------------------------------------------------------------ */
+/* Einlesen                                                            */
+/* ------------------------------------------------------------------ */
+
+static void add_chunk(uint64_t t_us, const uint8_t *data, uint32_t len)
+{
+    if (len < CHUNK_LEN || data[0] != 0x06) return;
+    if (n_chunks == cap_chunks) {
+        cap_chunks = cap_chunks ? cap_chunks * 2u : 1024u;
+        chunks = realloc(chunks, cap_chunks * sizeof(*chunks));
+        if (!chunks) { fprintf(stderr, "kein Speicher\n"); exit(2); }
+    }
+    chunks[n_chunks].t_us = t_us;
+    memcpy(chunks[n_chunks].d, data, CHUNK_LEN);
+    n_chunks++;
+}
+
+/* SET_REPORT (Klasse, Interface, OUT) mit Report-ID 6 als Feature oder Output */
+static int is_set_report_6(const uint8_t *setup)
+{
+    uint8_t type = setup[3], id = setup[2];
+    return setup[0] == 0x21 && setup[1] == 0x09 && (type == 0x02 || type == 0x03) && id == 0x06;
+}
+
+static uint32_t rd32(const uint8_t *p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint32_t bswap32(uint32_t v)    { return (v >> 24) | ((v >> 8) & 0xFF00u) | ((v << 8) & 0xFF0000u) | (v << 24); }
+
+/**
+ * @brief pcap mit usbmon-Kopf (Linktyp 189 = 48 Byte, 220 = 64 Byte)
+ *
+ * Der usbmon-Kopf steht in der Byte-Reihenfolge des aufnehmenden Rechners,
+ * angenommen wird Little Endian.
+ */
+static int load_pcap(FILE *f)
+{
+    uint8_t gh[24];
+    if (fread(gh, 1, sizeof(gh), f) != sizeof(gh)) return -1;
+
+    uint32_t magic = rd32(gh);
+    int swap = 0, nsec = 0;
+    if      (magic == 0xA1B2C3D4u) { }
+    else if (magic == 0xD4C3B2A1u) { swap = 1; }
+    else if (magic == 0xA1B23C4Du) { nsec = 1; }
+    else if (magic == 0x4D3CB2A1u) { swap = 1; nsec = 1; }
+    else return -1;
+
+    uint32_t link = swap ? bswap32(rd32(&gh[20])) : rd32(&gh[20]);
+    uint32_t hdr_len = (link == 189u) ? 48u : (link == 220u) ? 64u : 0u;
+    if (!hdr_len) {
+        fprintf(stderr, "pcap-Linktyp %u ist kein usbmon (189/220)\n", link);
+        return -2;
+    }
+
+    uint8_t rh[16];
+    static uint8_t rec[65536];
+    while (fread(rh, 1, sizeof(rh), f) == sizeof(rh)) {
+        uint32_t sec  = swap ? bswap32(rd32(&rh[0]))  : rd32(&rh[0]);
+        uint32_t frac = swap ? bswap32(rd32(&rh[4]))  : rd32(&rh[4]);
+        uint32_t incl = swap ? bswap32(rd32(&rh[8]))  : rd32(&rh[8]);
+        if (incl > sizeof(rec) || fread(rec, 1, incl, f) != incl) break;
+        if (incl < hdr_len) continue;
+
+        /* id(8) type xfer_type epnum devnum busnum(2) flag_setup flag_data
+         * ts_sec(8) ts_usec(4) status(4) urb_len(4) data_len(4) setup(8) */
+        uint8_t  ev       = rec[8];
+        uint8_t  xfer     = rec[9];
+        uint8_t  ep       = rec[10];
+        uint8_t  setup_ok = (rec[14] == 0);
+        uint32_t data_len = rd32(&rec[36]);
+        const uint8_t *setup = &rec[40];
+
+        if (ev != 'S' || xfer != 2u || (ep & 0x80u) || !setup_ok || !is_set_report_6(setup)) continue;
+        if (hdr_len + data_len > incl) data_len = incl - hdr_len;
+
+        uint64_t t_us = (uint64_t)sec * 1000000u + (nsec ? frac / 1000u : frac);
+        add_chunk(t_us, &rec[hdr_len], data_len);
+    }
+    return 0;
+}
+
+/**
+ * @brief usbmon-Text: "<urb> <zeit_us> S Co:<bus>:<dev>:0 s 21 09 0306 0000 0008 8 = 06fefd01 ..."
+ */
+static int load_text(FILE *f)
+{
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        char tag[32], ev[4], addr[32], s[4];
+        unsigned long long ts;
+        unsigned bm, req, wval, widx, wlen;
+        int used = 0;
+
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%31s %llu %3s %31s %3s %x %x %x %x %x %n",
+                   tag, &ts, ev, addr, s, &bm, &req, &wval, &widx, &wlen, &used) < 10) continue;
+        if (strcmp(ev, "S") || strncmp(addr, "Co:", 3) || strcmp(s, "s")) continue;
+
+        uint8_t setup[4] = { (uint8_t)bm, (uint8_t)req, (uint8_t)(wval & 0xFF), (uint8_t)(wval >> 8) };
+        if (!is_set_report_6(setup)) continue;
+
+        char *eq = strchr(line + used, '=');
+        if (!eq) continue;
+
+        uint8_t data[64];
+        uint32_t n = 0;
+        int hi = -1;
+        for (char *p = eq + 1; *p && n < sizeof(data); p++) {
+            int v;
+            if      (*p >= '0' && *p <= '9') v = *p - '0';
+            else if (*p >= 'a' && *p <= 'f') v = *p - 'a' + 10;
+            else if (*p >= 'A' && *p <= 'F') v = *p - 'A' + 10;
+            else continue;
+            if (hi < 0) { hi = v; } else { data[n++] = (uint8_t)(hi << 4 | v); hi = -1; }
+        }
+        add_chunk(ts, data, n);
+    }
+    return 0;
+}
+
+static int load(const char *file, const char **kind)
+{
+    FILE *f = fopen(file, "rb");
+    if (!f) { perror(file); return -1; }
+
+    int r = load_pcap(f);
+    *kind = "pcap";
+    if (r == -1) {
+        rewind(f);
+        r = load_text(f);
+        *kind = "usbmon-Text";
+    }
+    fclose(f);
+    return r;
+}
+
+/* ------------------------------------------------------------------ */
+/* Auswertung                                                          */
+/* ------------------------------------------------------------------ */
+
+typedef struct { uint64_t ui, spi; uint32_t coord, status; } counters_t;
+
+static uint64_t prof_sum(uint8_t id, uint32_t *count)
+{
+    xhc_prof_stat_t st;
+    if (!xhc_prof_snapshot(id, &st)) return 0;
+    if (count) *count = st.count;
+    return st.sum;
+}
+
+static counters_t counters_now(void)
+{
+    counters_t c = { 0 };
+    c.ui  = prof_sum(PROF_MAIN_UI, NULL);
+    c.spi = sim_spi_bytes();
+    prof_sum(PROF_UI_COORDS, &c.coord);
+    prof_sum(PROF_UI_STATUS, &c.status);
+    return c;
+}
+
+static void series_add(series_t *s, uint32_t v)
+{
+    s->v = realloc(s->v, (s->n + 1u) * sizeof(*s->v));
+    s->v[s->n++] = v;
+    s->sum += v;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t series_pct(series_t *s, uint32_t pct)
+{
+    if (!s->n) return 0;
+    uint32_t i = (uint32_t)(((uint64_t)s->n * pct + 99u) / 100u);
+    return s->v[i ? i - 1u : 0u];
+}
+
+/* Aufnahmezeit -> virtuelle Zeit */
+static uint64_t replay_time(uint64_t t0, uint64_t us0, uint64_t t_us, double speed)
+{
+    return t0 + (uint64_t)((double)(t_us - us0) / speed * (SIM_CPU_HZ / 1000000u));
+}
+
+static int is_packet_start(const chunk_t *c)
+{
+    return c->d[1] == (uint8_t)(WHBxx_MAGIC & 0xFF) && c->d[2] == (uint8_t)(WHBxx_MAGIC >> 8);
+}
+
+static void packet_done(const counters_t *a, const counters_t *b, uint32_t idx, uint64_t t_us,
+                        int dup, int per_packet)
+{
+    uint32_t v[S_COUNT] = {
+        (uint32_t)(b->ui - a->ui), (uint32_t)(b->spi - a->spi),
+        b->coord - a->coord, b->status - a->status,
+    };
+    for (int i = 0; i < S_COUNT; i++) series_add(&series[i], v[i]);
+
+    if (per_packet) {
+        fprintf(out, "%5u %10.3f ms %s  ui %8u  spi %6u  koord %u  status %u\n",
+                idx, t_us / 1000.0, dup ? "dup" : "   ", v[S_UI], v[S_SPI], v[S_COORD], v[S_STATUS]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int per_packet = 0, verbose = 0;
+    double speed = 1.0;
+    const char *file = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-p")) per_packet = 1;
+        else if (!strcmp(argv[i], "-v")) verbose = 1;
+        else if (!strcmp(argv[i], "-x") && i + 1 < argc) speed = atof(argv[++i]);
+        else file = argv[i];
+    }
+    if (!file || speed <= 0.0) {
+        fprintf(stderr, "Aufruf: %s [-p] [-v] [-x faktor] mitschnitt.(txt|pcap)\n", argv[0]);
+        return 2;
+    }
+
+    const char *kind;
+    if (load(file, &kind) < 0) return 2;
+    if (n_chunks == 0) {
+        fprintf(stderr, "%s: keine SET_REPORT-Chunks mit Report-ID 6\n", file);
+        return 1;
+    }
+
+    /* Firmware-printf vom Ergebnis trennen */
+    out = fdopen(dup(fileno(stdout)), "w");
+    if (!verbose && !freopen("/dev/null", "w", stdout)) return 2;
+
+    sim_stats_attach(0);
+    sim_firmware_init();
+    sim_rotary(1);                          // X, wie bei einem eingeschalteten Handrad
+    sim_run_until(SIM_MS(1200));            // Panel-Init und statische UI
+    sim_stats_mark();
+    xhc_prof_reset();
+
+    uint64_t t0 = sim_now();
+    uint64_t us0 = chunks[0].t_us;
+    uint32_t packets = 0, dups = 0, delayed = 0;
+    uint64_t first_pkt_us = 0;
+    uint8_t  prev[PKT_MAX_CHUNKS * 7u], cur[PKT_MAX_CHUNKS * 7u];
+    uint32_t prev_len = 0, cur_len = 0;
+    counters_t c_start = counters_now();
+    uint64_t pkt_us = 0;
+    int in_packet = 0;
+    uint32_t next_q = 0, next_b = 0;    // nächster einzureihender / auszuwertender Chunk
+
+    while (next_b < n_chunks) {
+        /* Vorauseilend einreihen: der USB-IRQ muss auch während langer
+         * SPI-Wartezeiten der Hauptschleife pünktlich kommen */
+        while (next_q < n_chunks && sim_usb_out_pending() < SIM_USB_QUEUE / 2u) {
+            uint64_t at = replay_time(t0, us0, chunks[next_q].t_us, speed);
+            if (at > sim_now() + LOOKAHEAD) break;
+            uint64_t when = sim_host_report_at(at, chunks[next_q].d, CHUNK_LEN);
+            if (when > (at / SIM_TICK_CYCLES + 1u) * SIM_TICK_CYCLES) delayed++;
+            next_q++;
+        }
+        sim_run_until(sim_now() + SIM_TICK_CYCLES);
+
+        /* Paketgrenzen in Aufnahme-Reihenfolge auswerten, sobald die Zeit erreicht ist */
+        while (next_b < next_q && replay_time(t0, us0, chunks[next_b].t_us, speed) <= sim_now()) {
+            const chunk_t *c = &chunks[next_b++];
+            if (is_packet_start(c)) {
+                if (in_packet) {
+                    int dup = (cur_len == prev_len) && !memcmp(cur, prev, cur_len);
+                    counters_t c_end = counters_now();
+                    packet_done(&c_start, &c_end, packets, pkt_us - us0, dup, per_packet);
+                    dups += dup;
+                    packets++;
+                    memcpy(prev, cur, cur_len);
+                    prev_len = cur_len;
+                    c_start = c_end;
+                } else {
+                    first_pkt_us = c->t_us;
+                }
+                in_packet = 1;
+                cur_len = 0;
+                pkt_us = c->t_us;
+            }
+            if (in_packet && cur_len + 7u <= sizeof(cur)) {
+                memcpy(&cur[cur_len], &c->d[1], 7u);
+                cur_len += 7u;
+            }
+        }
+    }
+    sim_run_until(sim_now() + SIM_MS(200));    // letztes Paket zeichnen lassen
+    if (in_packet) {
+        int dup = (cur_len == prev_len) && !memcmp(cur, prev, cur_len);
+        counters_t c_end = counters_now();
+        packet_done(&c_start, &c_end, packets, pkt_us - us0, dup, per_packet);
+        dups += dup;
+        packets++;
+    }
+
+    double dur_s = (double)(chunks[n_chunks - 1u].t_us - us0) / 1e6;
+    double span_s = (double)(pkt_us - first_pkt_us) / 1e6;    // erster bis letzter Paketanfang
+    fprintf(out, "\nMitschnitt   %s (%s)\n", file, kind);
+    fprintf(out, "Chunks       %u, Pakete %u, Duplikate %u (%.1f %%)\n",
+            n_chunks, packets, dups, packets ? 100.0 * dups / packets : 0.0);
+    fprintf(out, "Dauer        %.2f s aufgenommen, %.2f Pakete/s, Abspielfaktor %.2f, verzögert %u Chunks\n",
+            dur_s, (span_s > 0 && packets > 1) ? (packets - 1u) / span_s : 0.0, speed, delayed);
+    fprintf(out, "\n%-12s %10s %10s %10s %10s %12s\n", "pro Paket", "p50", "p99", "max", "Mittel", "Summe");
+    for (int i = 0; i < S_COUNT; i++) {
+        series_t *s = &series[i];
+        qsort(s->v, s->n, sizeof(*s->v), cmp_u32);
+        fprintf(out, "%-12s %10u %10u %10u %10.1f %12llu\n", series_name[i],
+                series_pct(s, 50), series_pct(s, 99), series_pct(s, 100),
+                s->n ? (double)s->sum / s->n : 0.0, (unsigned long long)s->sum);
+    }
+    fprintf(out, "\nUI-Zyklen gesamt %.1f ms bei 72 MHz, USB-OUT-Rückstau am Ende %u\n",
+            (double)series[S_UI].sum / (SIM_CPU_HZ / 1000u), sim_usb_out_pending());
+    fclose(out);
+    return 0;
+}
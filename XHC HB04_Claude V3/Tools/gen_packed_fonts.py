@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Font-Compiler: erzeugt Drivers/ST7735/fonts_packed.c aus Drivers/ST7735/fonts.c.
+
+fonts.c speichert pro Glyph-Zeile ein uint16_t (linksbündig, Bit 15 = linkes
+Pixel) für alle 95 druckbaren ASCII-Zeichen. Hier werden
+  - nur die Zeichen aus CHARSETS übernommen (None = alle 95),
+  - die Zeilen Bit für Bit hintereinander gepackt (width*height Bit je
+    Glyph, MSB zuerst, jedes Glyph auf volle Bytes aufgefüllt),
+  - Fonts ohne Eintrag in FONTS ganz weggelassen.
+Fehlende Zeichen zeichnet der Treiber als Hintergrund.
+
+Aufruf (aus dem Projektverzeichnis):
+    python3 Tools/gen_packed_fonts.py
+"""
+import argparse
+import os
+import re
+
+# FontDef-Name -> (Array in fonts.c, Breite, Höhe, Zeichensatz)
+FONTS = [
+    # Debug-/Testausgaben nutzen beliebigen Text -> voller Satz
+    ("Font_7x10",  "Font7x10",  7,  10, None),
+    # DRO: Koordinaten "%5d.%04d", Achs-Labels
+    ("Font_9x11",  "Font9x11",  9,  11, " +-.0123456789:ABCXYZ"),
+    # nur "WC"/"MC" (Fallback ohne RLE-Hintergrund)
+    ("Font_11x18", "Font11x18", 11, 18, "CMW"),
+    # Font_16x26, Font_9x12: nicht benutzt
+]
+
+FIRST, LAST = 32, 126
+NCHARS = LAST - FIRST + 1
+
+
+def load_array(src, name, height):
+    m = re.search(r"static const uint16_t\s+%s\s*\[\]\s*=\s*\{(.*?)\};" % name, src, re.S)
+    if not m:
+        raise SystemExit("%s nicht gefunden" % name)
+    body = "\n".join(line.split("//")[0] for line in m.group(1).splitlines())
+    vals = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", body)]
+    if len(vals) < NCHARS * height:
+        raise SystemExit("%s: %d Werte, erwartet %d" % (name, len(vals), NCHARS * height))
+    return vals
+
+
+def pack_glyph(rows, width):
+    bits = []
+    for r in rows:
+        bits += [(r >> (15 - j)) & 1 for j in range(width)]
+    bits += [0] * (-len(bits) % 8)
+    return [int("".join(map(str, bits[k:k + 8])), 2) for k in range(0, len(bits), 8)]
+
+
+def c_bytes(data, indent="    ", per_line=16):
+    return "\n".join(indent + ", ".join("0x%02X" % b for b in data[k:k + per_line]) + ","
+                     for k in range(0, len(data), per_line))
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("--fonts", default=os.path.join(root, "Drivers", "ST7735", "fonts.c"))
+    ap.add_argument("--out", default=os.path.join(root, "Drivers", "ST7735", "fonts_packed.c"))
+    args = ap.parse_args()
+
+    src = open(args.fonts, encoding="utf-8", errors="replace").read()
+    out = ["/* vim: set ai et ts=4 sw=4: */",
+           "/*",
+           " * Gepackte, auf die benutzten Zeichen reduzierte Fonts.",
+           " * GENERIERT von Tools/gen_packed_fonts.py aus fonts.c - nicht von Hand bearbeiten.",
+           " */",
+           '#include "fonts.h"',
+           "",
+           "#if ST7735_PACKED_FONTS",
+           ""]
+    total_old = total_new = 0
+
+    for fontdef, array, w, h, charset in FONTS:
+        vals = load_array(src, array, h)
+        chars = list(range(FIRST, LAST + 1)) if charset is None else sorted({ord(c) for c in charset})
+        glyph_bytes = (w * h + 7) // 8
+
+        bits = []
+        for c in chars:
+            i = c - FIRST
+            bits += pack_glyph(vals[i * h:(i + 1) * h], w)
+
+        out.append("/* %s: %d Zeichen, %d Bytes je Glyph (vorher %d) */" % (fontdef, len(chars), glyph_bytes, 2 * h))
+        out.append("static const uint8_t %s_bits[] = {" % array)
+        out.append(c_bytes(bits))
+        out.append("};")
+        size = len(bits)
+        map_name = "NULL"
+        if charset is not None:
+            cmap = [0xFF] * NCHARS
+            for idx, c in enumerate(chars):
+                cmap[c - FIRST] = idx
+            map_name = "%s_map" % array
+            out.append("static const uint8_t %s[%d] = {" % (map_name, NCHARS))
+            out.append(c_bytes(cmap))
+            out.append("};")
+            size += NCHARS
+        out.append("FontDef %s = {%d, %d, NULL, %s_bits, %s};" % (fontdef, w, h, array, map_name))
+        out.append("")
+        total_old += NCHARS * h * 2
+        total_new += size
+        print("%-11s %3d Zeichen  %5d -> %4d Bytes" % (fontdef, len(chars), NCHARS * h * 2, size))
+
+    out.append("#endif /* ST7735_PACKED_FONTS */")
+    with open(args.out, "w", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+    print("%s: %d -> %d Bytes (ohne entfallene Fonts)" % (args.out, total_old, total_new))
+
+
+if __name__ == "__main__":
+    main()
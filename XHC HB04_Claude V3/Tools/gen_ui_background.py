@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+Erzeugt das statische UI-Layout (Labels, Trennlinien, blaues Statusband)
+als lauflängenkodiertes, indiziertes Bild fuer ST7735_DrawRLE().
+
+Das Layout unten muss den statischen Teil von xhc_ui_init() abbilden.
+Die Glyphen werden direkt aus Drivers/ST7735/fonts.c gelesen, das Ergebnis
+ist damit pixelgenau identisch mit den bisherigen ST7735_WriteString-Aufrufen.
+
+Kodierung: ein Byte pro Lauf, Bit 7..6 = Palettenindex, Bit 5..0 = Laenge-1
+(1..64 Pixel). Laeufe gehen zeilenuebergreifend weiter (Bild = w*h Pixel am Stueck).
+
+Aufruf (aus dem Projektverzeichnis):
+    python3 Tools/gen_ui_background.py
+"""
+import argparse
+import os
+import re
+
+WIDTH, HEIGHT = 160, 128
+
+BLACK, WHITE, BLUE = 0x0000, 0xFFFF, 0x001F
+PALETTE = [BLACK, WHITE, BLUE]
+
+FONTS = {  # Name in fonts.c -> (Breite, Hoehe)
+    "Font7x10": (7, 10),
+    "Font11x18": (11, 18),
+    "Font9x11": (9, 11),
+}
+
+# Statischer Teil von xhc_ui_init(), in Zeichenreihenfolge
+LAYOUT = [
+    ("fill", 0, 0, WIDTH, HEIGHT, WHITE),
+    ("fill", 0, 94, WIDTH, 34, BLUE),
+    ("text", 2, 2, "WC", "Font11x18", BLACK, WHITE),
+    ("text", 38, 2, "X:", "Font9x11", BLACK, WHITE),
+    ("text", 38, 17, "Y:", "Font9x11", BLACK, WHITE),
+    ("text", 38, 32, "Z:", "Font9x11", BLACK, WHITE),
+    ("fill", 2, 46, 156, 1, BLACK),
+    ("text", 2, 49, "MC", "Font11x18", BLACK, WHITE),
+    ("text", 38, 49, "X:", "Font9x11", BLACK, WHITE),
+    ("text", 38, 64, "Y:", "Font9x11", BLACK, WHITE),
+    ("text", 38, 79, "Z:", "Font9x11", BLACK, WHITE),
+    ("fill", 0, 93, 160, 1, BLACK),
+    ("text", 2, 95, "S:240000", "Font7x10", WHITE, BLUE),
+    ("text", 2, 106, "F:3500", "Font7x10", WHITE, BLUE),
+    ("fill", 60, 94, 1, 22, BLACK),
+    ("fill", 0, 115, 160, 1, BLACK),
+    ("text", 2, 118, "POS:", "Font7x10", WHITE, BLUE),
+    ("text", 92, 118, "STP:", "Font7x10", WHITE, BLUE),
+]
+
+
+def load_fonts(path):
+    src = open(path, encoding="utf-8", errors="replace").read()
+    fonts = {}
+    for name in FONTS:
+        m = re.search(r"static const uint16_t\s+%s\s*\[\]\s*=\s*\{(.*?)\};" % name, src, re.S)
+        if not m:
+            raise SystemExit("Font %s nicht in %s gefunden" % (name, path))
+        body = "\n".join(line.split("//")[0] for line in m.group(1).splitlines())
+        fonts[name] = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", body)]
+    return fonts
+
+
+def render(fonts):
+    img = [[WHITE] * WIDTH for _ in range(HEIGHT)]
+
+    def fill(x, y, w, h, c):
+        for yy in range(y, min(y + h, HEIGHT)):
+            for xx in range(x, min(x + w, WIDTH)):
+                img[yy][xx] = c
+
+    for op in LAYOUT:
+        if op[0] == "fill":
+            fill(*op[1:])
+            continue
+        _, x, y, text, font, fg, bg = op
+        fw, fh = FONTS[font]
+        data = fonts[font]
+        for ch in text:
+            for i in range(fh):
+                b = data[(ord(ch) - 32) * fh + i]
+                for j in range(fw):
+                    img[y + i][x + j] = fg if (b << j) & 0x8000 else bg
+            x += fw
+    return img
+
+
+def encode(img):
+    pixels = [PALETTE.index(c) for row in img for c in row]
+    out = []
+    i = 0
+    while i < len(pixels):
+        idx = pixels[i]
+        n = 1
+        while i + n < len(pixels) and pixels[i + n] == idx and n < 64:
+            n += 1
+        out.append((idx << 6) | (n - 1))
+        i += n
+    return out
+
+
+def emit(rle, path):
+    lines = []
+    for k in range(0, len(rle), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in rle[k:k + 16]) + ",")
+    with open(path, "w", newline="\n") as f:
+        f.write("/*\n")
+        f.write(" * Statischer UI-Hintergrund (%dx%d), RLE-kodiert.\n" % (WIDTH, HEIGHT))
+        f.write(" * GENERIERT von Tools/gen_ui_background.py - nicht von Hand bearbeiten.\n")
+        f.write(" * %d Bytes statt %d Bytes RGB565.\n" % (len(rle), WIDTH * HEIGHT * 2))
+        f.write(" */\n\n")
+        f.write('#include "xhc_ui_background.h"\n\n')
+        f.write("const uint16_t xhc_ui_bg_palette[4] = { 0x%04X, 0x%04X, 0x%04X, 0x0000 };\n\n"
+                % tuple(PALETTE))
+        f.write("const uint8_t xhc_ui_bg_rle[XHC_UI_BG_RLE_SIZE] = {\n")
+        f.write("\n".join(lines) + "\n};\n")
+    return len(rle)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("--fonts", default=os.path.join(root, "Drivers", "ST7735", "fonts.c"))
+    ap.add_argument("--out", default=os.path.join(root, "Core", "Src", "xhc_ui_background.c"))
+    args = ap.parse_args()
+
+    rle = encode(render(load_fonts(args.fonts)))
+    n = emit(rle, args.out)
+    print("%s: %d Bytes (XHC_UI_BG_RLE_SIZE in xhc_ui_background.h anpassen)" % (args.out, n))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,437 @@
+#!/usr/bin/env python3
+"""
+Liest die Diagnose-Feature-Reports 0x10 (Core/Inc/xhc_diag.h) und
+0x11 (Core/Inc/xhc_telemetry.h) vom Pendant.
+
+Benötigt das Python-Modul "hid" (hidapi):  pip install hidapi
+Unter Linux ggf. udev-Regel für 10ce:eb70 oder als root starten.
+
+    python3 Tools/xhc_diag.py prof          # Profiler-Tabelle
+    python3 Tools/xhc_diag.py prof --hist   # zusätzlich log2-Histogramme
+    python3 Tools/xhc_diag.py prof --reset  # Statistik löschen
+    python3 Tools/xhc_diag.py sched         # Scheduler: Läufe, Deadline-Misses
+    python3 Tools/xhc_diag.py mem           # RAM-Aufteilung, Stack-High-Water, ISR-Tiefen
+    python3 Tools/xhc_diag.py mem --map Debug/"XHC HB04_Claude V3.map"   # + größte Puffer
+    python3 Tools/xhc_diag.py irq --soak 60 --check   # IRQ-Prioritäten gegen Plan, Latenzen, Encoder-Jitter
+    python3 Tools/xhc_diag.py power --soak 10   # Schlafanteil (WFI) und Task-Aufrufe/s
+    python3 Tools/xhc_diag.py telem         # Telemetrie 0x11: Schleifenrate, USB, Empfang, Encoder, Display
+    python3 Tools/xhc_diag.py telem --watch 1   # jede Sekunde, Zähler als Differenz
+    python3 Tools/xhc_diag.py trace         # Trace-Ring dekodieren (Texte aus Core/Inc/xhc_trace.h)
+    python3 Tools/xhc_diag.py trace --file trace.bin  # Speicherabzug (GDB/Sim), ohne Gerät
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+import time
+
+VID, PID = 0x10CE, 0xEB70
+REPORT_ID = 0x10
+REPORT_LEN = 64
+CMD_RESET = 0x01
+
+PAGE_PROFILER = 1
+PAGE_SCHED = 2
+PAGE_MEMORY = 3
+PAGE_TRACE = 4
+PAGE_IRQ = 5
+TELEM_REPORT_ID = 0x11
+TELEM_VERSION = 4
+TELEM_REPORT_LEN = 128
+PROF_HIST_BINS, PROF_HIST_SHIFT = 18, 6
+CPU_HZ = 72_000_000
+ENC_JITTER_MAX_US = 10          # XHC_ENC_JITTER_MAX_US (Core/Inc/xhc_irq.h)
+TRACE_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Core", "Inc", "xhc_trace.h")
+TRACE_REC = struct.Struct("<IHHii")     # xhc_trace_rec_t
+TRACE_HDR = struct.Struct("<8I")        # xhc_trace_buf_t bis rec[]
+TRACE_MAGIC = 0x58545243
+RESET_CAUSES = [(0x80, "LPWR"), (0x40, "WWDG"), (0x20, "IWDG"), (0x10, "SW"), (0x08, "POR"), (0x04, "PIN")]
+
+
+def reset_cause(bits):
+    """RCC->CSR >> 24 als Text (XHC_RESET_* in xhc_trace.h)."""
+    return "+".join(n for m, n in RESET_CAUSES if bits & m) or "?"
+
+# Messpunkte je IRQ: (Latenz, Dauer); Prioritäten Ist/Soll liefert die IRQ-Seite
+IRQ_PROF = {
+    "SysTick": ("l_tick", "i_tick"),
+    "DMA1_3":  (None,     "i_dma"),
+    "USB_LP":  (None,     "i_usb"),
+    "PendSV":  ("l_psv",  "i_psv"),
+}
+
+
+def open_dev():
+    import hid
+    dev = hid.device()
+    dev.open(VID, PID)
+    return dev
+
+
+def select(dev, page, index=0, cmd=0):
+    dev.send_feature_report([REPORT_ID, page, index, cmd] + [0] * (REPORT_LEN - 4))
+
+
+def get(dev):
+    r = bytes(dev.get_feature_report(REPORT_ID, REPORT_LEN))
+    if r[0] != REPORT_ID:
+        raise SystemExit("unerwartete Antwort: %r" % r[:4])
+    return r
+
+
+def us(cycles):
+    return cycles * 1e6 / CPU_HZ
+
+
+def cmd_prof(dev, args):
+    rows = read_page(dev, PAGE_PROFILER, args.reset)
+    if not rows:
+        return
+
+    print("%-8s %9s %10s %10s %10s" % ("probe", "count", "min us", "mean us", "max us"))
+    for r in rows:
+        name = r[4:12].split(b"\0")[0].decode()
+        count, cmin, cmax, mean = struct.unpack_from("<IIII", r, 12)
+        hist = struct.unpack_from("<%dH" % PROF_HIST_BINS, r, 28)
+        print("%-8s %9d %10.2f %10.2f %10.2f" % (name, count, us(cmin), us(mean), us(cmax)))
+        if args.hist and count:
+            for k, n in enumerate(hist):
+                if n:
+                    lo = 0 if k == 0 else us(1 << (k + PROF_HIST_SHIFT))
+                    print("    >= %9.2f us : %d" % (lo, n))
+
+
+def read_page(dev, page, reset):
+    select(dev, page, 0, CMD_RESET if reset else 0)
+    if reset:
+        return []
+    first = get(dev)
+    return [first] + [get(dev) for _ in range(1, first[3])]
+
+
+def cmd_sched(dev, args):
+    rows = read_page(dev, PAGE_SCHED, args.reset)
+    if rows:
+        print("%-8s %9s %7s %9s %7s %9s" % ("task", "runs", "misses", "max late", "period", "deadline"))
+    for r in rows:
+        name = r[4:12].split(b"\0")[0].decode()
+        runs, misses = struct.unpack_from("<II", r, 12)
+        late, period, deadline = struct.unpack_from("<HHH", r, 20)
+        print("%-8s %9d %7d %6d ms %4d ms %6d ms" % (name, runs, misses, late, period, deadline))
+
+
+def prof_table(dev):
+    """Profiler-Seite als {Name: (Anzahl, Min, Max, Mittel)} in Zyklen."""
+    out = {}
+    for r in read_page(dev, PAGE_PROFILER, False):
+        name = r[4:12].split(b"\0")[0].decode()
+        count, cmin, cmax, mean = struct.unpack_from("<IIII", r, 12)
+        out[name] = (count, cmin, cmax, mean)
+    return out
+
+
+def cmd_irq(dev, args):
+    if args.soak:
+        select(dev, PAGE_PROFILER, 0, CMD_RESET)
+        time.sleep(args.soak)
+    prof = prof_table(dev)
+
+    def worst(name):
+        return prof.get(name, (0, 0, 0, 0))[2]
+
+    # Gemessene Eintrittslatenz (l_*) wo das Ereignis einen Zeitstempel hat,
+    # sonst Schranke: Summe der längsten Läufe aller höheren Stufen + SysTick-Latenz
+    print("%-8s %4s %4s %11s %11s %11s" % ("irq", "prio", "sub", "latenz us", "jitter us", "dauer us"))
+    higher = 0
+    plan_ok = True
+    group = plan_group = 0
+    for r in read_page(dev, PAGE_IRQ, False):
+        irq = r[4:12].split(b"\0")[0].decode()
+        prio, sub_, plan_prio, plan_sub, group, plan_group = r[12:18]
+        lat, dur = IRQ_PROF.get(irq, (None, None))
+        if lat and prof.get(lat, (0,))[0]:
+            count, cmin, cmax, _ = prof[lat]
+            lat_s, jit_s = "%11.2f" % us(cmax), "%11.2f" % us(cmax - cmin)
+        else:
+            lat_s, jit_s = "<= %8.2f" % us(higher + worst("l_tick")), "%11s" % "-"
+        note = ""
+        if (prio, sub_) != (plan_prio, plan_sub):
+            note = "   FEHLER: Plan %d/%d" % (plan_prio, plan_sub)
+            plan_ok = False
+        print("%-8s %4d %4d %s %s %11.2f%s" % (irq, prio, sub_, lat_s, jit_s, us(worst(dur) if dur else 0), note))
+        higher += worst(dur) if dur else 0
+    if group != plan_group:
+        print("FEHLER: Prioritätsgruppe %d statt %d" % (group, plan_group))
+        plan_ok = False
+
+    count, cmin, cmax, _ = prof.get("l_tick", (0, 0, 0, 0))
+    jitter = us(cmax - cmin) if count else 0.0
+    print()
+    print("Encoder-Abtastjitter %.2f us über %d Ticks (Grenze %g us)" % (jitter, count, args.max_jitter_us))
+    if args.check and not plan_ok:
+        print("FEHLER: NVIC weicht vom Plan in xhc_irq.h ab")
+        return 1
+    if args.check and (count == 0 or jitter > args.max_jitter_us):
+        print("FEHLER: Jitter-Grenze überschritten" if count else "FEHLER: keine Messwerte")
+        return 1
+    return 0
+
+
+def cmd_power(dev, args):
+    """Duty-Cycle der Hauptschleife: Profiler m_wfi und Scheduler-Läufe über args.soak Sekunden."""
+    select(dev, PAGE_PROFILER, 0, CMD_RESET)
+    select(dev, PAGE_SCHED, 0, CMD_RESET)
+    time.sleep(args.soak)
+    prof = prof_table(dev)
+    runs = sum(struct.unpack_from("<I", r, 12)[0] for r in read_page(dev, PAGE_SCHED, False))
+
+    count, _, cmax, mean = prof.get("m_wfi", (0, 0, 0, 0))
+    sleep = count * mean / (args.soak * CPU_HZ)
+    print("Schlaf (WFI)    %6.1f %%   %d Mal, längstes %.2f us" % (100.0 * sleep, count, us(cmax)))
+    print("Wach            %6.1f %%   (ISRs + Tasks)" % (100.0 * (1.0 - sleep)))
+    print("Task-Aufrufe    %6.0f /s" % (runs / args.soak))
+    return 0
+
+
+def largest_symbols(map_path, count=12):
+    """Größte .data/.bss-Objekte aus dem GNU-ld-Mapfile (Name, Größe, Objektdatei)."""
+    syms = []
+    pending = None
+    with open(map_path, errors="replace") as f:
+        for line in f:
+            parts = line.split()
+            if not parts:
+                pending = None
+                continue
+            # " .bss.linebuf" steht bei langen Namen allein, Adresse/Größe folgen in der nächsten Zeile
+            if len(parts) == 1 and parts[0].startswith((".bss.", ".data.")):
+                pending = parts[0]
+                continue
+            if pending and len(parts) >= 3 and parts[0].startswith("0x"):
+                parts = [pending] + parts
+            pending = None
+            if len(parts) >= 4 and parts[0].startswith((".bss.", ".data.")) and parts[1].startswith("0x"):
+                try:
+                    size = int(parts[2], 16)
+                except ValueError:
+                    continue
+                if size:
+                    syms.append((size, parts[0], parts[3].rsplit("/", 1)[-1]))
+    syms.sort(reverse=True)
+    return syms[:count]
+
+
+def cmd_mem(dev, args):
+    rows = read_page(dev, PAGE_MEMORY, args.reset)
+    if not rows:
+        return
+
+    total, data, bss, heap, heap_min, stack_min, peak, headroom, ramfunc, noinit, fb = \
+        struct.unpack_from("<11I", rows[0], 12)
+    print("RAM gesamt      %6d B" % total)
+    print(".ramfunc        %6d B  (ISR-Code im SRAM)" % ramfunc)
+    print(".noinit         %6d B  (Flugschreiber, übersteht Reset)" % noinit)
+    if fb:
+        print("Schattenspeicher%6d B  (%.1f %%, in .bss)" % (fb, 100.0 * fb / total if total else 0))
+    print(".data           %6d B" % data)
+    print(".bss            %6d B" % bss)
+    print("Heap benutzt    %6d B  (Reserve %d B)" % (heap, heap_min))
+    print("Stack-Spitze    %6d B  (Reserve %d B)" % (peak, stack_min))
+    print("Luft Heap/Stack %6d B  (%.1f %%)" % (headroom, 100.0 * headroom / total if total else 0))
+    print()
+    print("%-8s %s" % ("isr", "Stack-Tiefe beim Eintritt"))
+    for r in rows[1:]:
+        name = r[4:12].split(b"\0")[0].decode()
+        depth, = struct.unpack_from("<I", r, 12)
+        print("%-8s %6d B" % (name, depth))
+
+    if args.map:
+        print()
+        print("größte statische Puffer (%s):" % args.map)
+        for size, sect, obj in largest_symbols(args.map):
+            print("  %6d B  %-36s %s" % (size, sect, obj))
+
+
+def trace_formats(header):
+    """{ID: (Name, Format)} aus den Kommentaren hinter xhc_trace_id_t."""
+    fmts, nxt = {}, 0
+    with open(header, encoding="utf-8") as f:
+        body = re.search(r"typedef enum \{(.*?)\} xhc_trace_id_t;", f.read(), re.S).group(1)
+    for m in re.finditer(r"^\s*(TRC_\w+)\s*(?:=\s*(\w+))?\s*,\s*(?://\s*\"(.*)\")?", body, re.M):
+        if m.group(2):
+            nxt = int(m.group(2), 0)
+        if m.group(1) != "TRC_COUNT":
+            fmts[nxt] = (m.group(1), m.group(3) or m.group(1))
+        nxt += 1
+    return fmts
+
+
+def trace_slots(head, depth, slots):
+    """Gültige Datensätze als {laufende Nummer: (ts, id, a, b)}.
+
+    Platz s enthält den jüngsten Eintrag n < head mit n % depth == s; passt
+    seine Folgenummer nicht, war er beim Lesen halb geschrieben."""
+    out = {}
+    for s, raw in slots:
+        if head <= s:
+            continue
+        n = head - 1 - ((head - 1 - s) % depth)
+        ts, tid, seq, a, b = TRACE_REC.unpack(raw)
+        if seq == (n & 0xFFFF):
+            out[n] = (ts, tid, a, b)
+    return out
+
+
+def trace_format(fmt, a, b):
+    fmt = re.sub(r"%(\d*)l?[ui]", r"%\1d", fmt)
+    args = (a, b)[:len(re.findall(r"%[^%]", fmt.replace("%%", "")))]
+    try:
+        return fmt % args
+    except (TypeError, ValueError):
+        return "%s [%d, %d]" % (fmt, a, b)
+
+
+def cmd_trace(dev, args):
+    fmts = trace_formats(args.header)
+    hz = args.hz
+    if args.file:
+        data = open(args.file, "rb").read()
+        magic, head, depth, boots, csr, dma_start, dma_done, _ = TRACE_HDR.unpack_from(data, 0)
+        if magic != TRACE_MAGIC:
+            raise SystemExit("%s: kein Flugschreiber-Abzug (Magic 0x%08x)" % (args.file, magic))
+        print("Start #%d, Reset-Ursache %s, DMA offen %d" % (boots, reset_cause(csr >> 24), dma_start - dma_done))
+        base = TRACE_HDR.size
+        recs = trace_slots(head, depth, [(s, data[base + s * TRACE_REC.size:base + (s + 1) * TRACE_REC.size])
+                                         for s in range(depth)])
+    else:
+        rows = read_page(dev, PAGE_TRACE, args.reset)
+        if not rows:
+            return
+        recs, head = {}, 0
+        for r in rows:
+            head, depth, hz = struct.unpack_from("<III", r, 4)
+            slots = [(r[2] * 3 + i, r[16 + 16 * i:32 + 16 * i]) for i in range(3) if r[2] * 3 + i < depth]
+            recs.update(trace_slots(head, depth, slots))
+
+    if not recs:
+        print("Trace leer (%d Einträge geschrieben)" % head)
+        return
+    order = sorted(recs)
+    if order[0] > 0:
+        print("(%d ältere Einträge überschrieben)" % order[0])
+    t, prev = 0, recs[order[0]][0]
+    for n in order:
+        ts, tid, a, b = recs[n]
+        name, fmt = fmts.get(tid, (None, None))
+        if name == "TRC_BOOT":
+            # Neuer Start: CYCCNT beginnt bei 0, Zeit ab hier neu zählen
+            t = 0
+            print("---- Start #%d nach Reset %s ----" % (a, reset_cause(b)))
+        else:
+            t += (ts - prev) & 0xFFFFFFFF      # CYCCNT läuft nach 59 s über
+        prev = ts
+        text = trace_format(fmt, a, b) if fmt else "?id %d [%d, %d]" % (tid, a, b)
+        print("%6d %12.3f ms  %s" % (n, t * 1e3 / hz, text))
+    lost = order[-1] - order[0] + 1 - len(order)
+    if lost:
+        print("(%d Einträge beim Lesen überschrieben)" % lost)
+
+
+# Report 0x11, ab Byte 4 je uint32 (xhc_telemetry.c); (Name, Einheit, Zähler?)
+TELEM_FIELDS = [
+    ("Laufzeit", "ms", False),
+    ("Scheduler-Durchläufe", "/s", False),
+    ("IN-Reports gesendet", "", True),
+    ("IN-Endpunkt belegt", "", True),
+    ("Host-Pakete", "", True),
+    ("Chunks verworfen", "", True),
+    ("Duplikate", "", True),
+    ("Rastungen Encoder", "", True),
+    ("Rastungen gemeldet", "", True),
+    ("Rastungen verworfen", "", True),
+    ("Display", "B/s", False),
+    ("Display gesamt", "B", True),
+    ("Stack-Spitze", "B", False),
+    ("Luft Heap/Stack", "B", False),
+    ("SET_REPORTs", "", True),
+    ("Reports mit Rad-Wert", "", True),
+    ("Echos gemessen", "", True),
+    ("Echo-Timeouts", "", True),
+]
+# ab Byte 76: je Strecke p50/p90/p99/max in us (xhc_joglat.h)
+JOGLAT_PATHS = ["Rastung -> IN-Report", "IN-Report -> Echo", "Rastung -> Echo"]
+
+
+def telem_read(dev):
+    r = bytes(dev.get_feature_report(TELEM_REPORT_ID, TELEM_REPORT_LEN))
+    if r[0] != TELEM_REPORT_ID or r[1] != TELEM_VERSION:
+        raise SystemExit("unerwartete Telemetrie-Antwort: %r" % r[:4])
+    n = len(TELEM_FIELDS)
+    lat = struct.unpack_from("<%dI" % (4 * len(JOGLAT_PATHS)), r, 4 + 4 * n)
+    fb = struct.unpack_from("<2H", r, 124)      # Schattenspeicher, SRAM gesamt
+    return r[2], r[3], struct.unpack_from("<%dI" % n, r, 4), lat, fb
+
+
+def cmd_telem(dev, args):
+    prev = None
+    while True:
+        cause, boots, vals, lat, (fb, sram) = telem_read(dev)
+        if prev is not None:
+            print()
+        print("%-22s %10d   Reset %s" % ("Start", boots, reset_cause(cause)))
+        for i, ((name, unit, counter), v) in enumerate(zip(TELEM_FIELDS, vals)):
+            line = "%-22s %10d %s" % (name, v, unit)
+            if counter and prev is not None:
+                line += "  (+%d)" % ((v - prev[i]) & 0xFFFFFFFF)
+            print(line.rstrip())
+        print("%-22s %8s %8s %8s %8s" % ("Jog-Latenz us", "p50", "p90", "p99", "max"))
+        for k, name in enumerate(JOGLAT_PATHS):
+            print("  %-20s %8d %8d %8d %8d" % ((name,) + lat[4 * k:4 * k + 4]))
+        print("%-22s %10d B von %d B (%.1f %%)" % ("Schattenspeicher", fb, sram,
+                                                 100.0 * fb / sram if sram else 0))
+        if not args.watch:
+            return 0
+        prev = vals
+        time.sleep(args.watch)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    sub = ap.add_subparsers(dest="page", required=True)
+    p = sub.add_parser("prof", help="Zyklen-Profiler")
+    p.add_argument("--hist", action="store_true")
+    p.add_argument("--reset", action="store_true")
+    p = sub.add_parser("sched", help="Scheduler-Statistik")
+    p.add_argument("--reset", action="store_true")
+    p = sub.add_parser("mem", help="RAM-Budget und Stack-High-Water")
+    p.add_argument("--reset", action="store_true", help="Stack neu bemalen, ISR-Tiefen löschen")
+    p.add_argument("--map", help="Mapfile des Builds für die Liste der größten Puffer")
+    p = sub.add_parser("irq", help="IRQ-Prioritäten, Latenzen, Encoder-Jitter")
+    p.add_argument("--soak", type=float, default=0, help="Profiler löschen und N Sekunden messen")
+    p.add_argument("--check", action="store_true", help="Exit-Code 1 wenn Jitter über der Grenze")
+    p.add_argument("--max-jitter-us", type=float, default=ENC_JITTER_MAX_US)
+    p = sub.add_parser("power", help="Schlafanteil und Task-Aufrufe (Idle-Power, xhc_power.h)")
+    p.add_argument("--soak", type=float, default=10, help="Messdauer in Sekunden")
+    p = sub.add_parser("telem", help="Telemetrie-Report 0x11")
+    p.add_argument("--watch", type=float, default=0, help="alle N Sekunden neu lesen")
+    p = sub.add_parser("trace", help="Trace-Ring dekodieren")
+    p.add_argument("--reset", action="store_true", help="Ring leeren")
+    p.add_argument("--file", help="Speicherabzug von xhc_trace_buf statt Gerät")
+    p.add_argument("--header", default=TRACE_HEADER, help="xhc_trace.h mit den Format-Texten")
+    p.add_argument("--hz", type=int, default=CPU_HZ, help="CPU-Takt für --file")
+    args = ap.parse_args()
+
+    if args.page == "trace" and args.file:
+        return cmd_trace(None, args)
+    dev = open_dev()
+    try:
+        return {"prof": cmd_prof, "sched": cmd_sched, "mem": cmd_mem,
+                "irq": cmd_irq, "power": cmd_power, "telem": cmd_telem,
+                "trace": cmd_trace}[args.page](dev, args)
+    finally:
+        dev.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
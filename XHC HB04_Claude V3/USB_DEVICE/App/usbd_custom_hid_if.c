@@ -28,6 +28,8 @@
 #include "usbd_core.h"
 #include "xhc_receive.h"
 #include "xhc_main.h"
+#include "xhc_diag.h"
+#include "xhc_telemetry.h"
 
 #ifndef __USB_DEVICE__H
 extern USBD_HandleTypeDef hUsbDeviceFS;
@@ -48,10 +50,6 @@ extern USBD_HandleTypeDef hUsbDeviceFS;
 #define XHC_RX_RING_SIZE  8u             // Anzahl gepufferter Reports (2..16)
 #define XHC_FEAT_MAX_LEN  USBD_CUSTOMHID_OUTREPORT_BUF_SIZE
 
-// Global counter nur für Display-Debug
-volatile uint32_t debug_setreport_calls = 0;
-volatile uint32_t debug_outevent_calls = 0;
-
 
 typedef struct {
     uint16_t len;
@@ -188,6 +186,14 @@ __ALIGN_BEGIN static uint8_t CUSTOM_HID_ReportDesc_FS[USBD_CUSTOM_HID_REPORT_DES
 	    0x95,0x07, 				/* Report Count (7) */
 	    0x75,0x08, 				/* Report Size (8) */
 	    0xB1,0x06, 				/* Feature (Data,Var,Rel,NWrp,Lin,Pref,NNul,NVol,Bit) */
+	    0x85,0x10, 				/* Report ID (16) - Diagnose, siehe xhc_diag.h */
+	    0x09,0x02, 				/* Usage (Vendor-Defined 2) */
+	    0x95,0x3F, 				/* Report Count (63) */
+	    0xB1,0x02, 				/* Feature (Data,Var,Abs,NWrp,Lin,Pref,NNul,NVol,Bit) */
+	    0x85,0x11, 				/* Report ID (17) - Telemetrie, siehe xhc_telemetry.h */
+	    0x09,0x03, 				/* Usage (Vendor-Defined 3) */
+	    0x95,0x7F, 				/* Report Count (127) */
+	    0xB1,0x03, 				/* Feature (Cnst,Var,Abs,NWrp,Lin,Pref,NNul,NVol,Bit) */
   /* USER CODE END 0 */
   0xC0    /*     END_COLLECTION	             */
 };
@@ -222,6 +228,7 @@ static int8_t CUSTOM_HID_Init_FS(void);
 static int8_t CUSTOM_HID_DeInit_FS(void);
 static int8_t CUSTOM_HID_OutEvent_FS(uint8_t event_idx, uint8_t state);
 static int8_t CUSTOM_HID_SetReport_FS(uint8_t *report, uint16_t len);
+static uint8_t *CUSTOM_HID_GetReport_FS(uint8_t report_id, uint16_t *len);
 
 /**
   * @}
@@ -234,6 +241,7 @@ USBD_CUSTOM_HID_ItfTypeDef USBD_CustomHID_fops_FS =
   CUSTOM_HID_DeInit_FS,
   CUSTOM_HID_OutEvent_FS,
   CUSTOM_HID_SetReport_FS,
+  CUSTOM_HID_GetReport_FS,
 };
 
 /** @defgroup USBD_CUSTOM_HID_Private_Functions USBD_CUSTOM_HID_Private_Functions
@@ -275,8 +283,6 @@ static int8_t CUSTOM_HID_DeInit_FS(void)
 static int8_t CUSTOM_HID_OutEvent_FS(uint8_t event_idx, uint8_t state)
 {
   /* USER CODE BEGIN 6 */
-	debug_outevent_calls++;
-
 	(void)event_idx;
 	    (void)state;
 
@@ -324,12 +330,18 @@ static int8_t USBD_CUSTOM_HID_SendReport_FS(uint8_t *report, uint16_t len)
 static int8_t CUSTOM_HID_SetReport_FS(uint8_t *report, uint16_t len)
 {
   /* USER CODE BEGIN 7 */
-	  debug_setreport_calls++;  // Zähler erhöhen
+	  XHC_TELEM_INC(host_reports);
   /* XHC HB04 Integration */
   if (len >= 8 && report[0] == 0x06)
   {
     /* Report ID 0x06 - Host→Device Kommunikation für XHC */
-    xhc_recv(&report[1]);  // Überspringe Report ID
+    xhc_recv_isr(&report[1]);  // Überspringe Report ID, Zusammenbau in PendSV
+    return USBD_OK;
+  }
+
+  if (report[0] == XHC_DIAG_REPORT_ID)
+  {
+    xhc_diag_set_report(report, len);
     return USBD_OK;
   }
 
@@ -337,6 +349,20 @@ static int8_t CUSTOM_HID_SetReport_FS(uint8_t *report, uint16_t len)
   return (USBD_OK);
 }
 
+
+static uint8_t *CUSTOM_HID_GetReport_FS(uint8_t report_id, uint16_t *len)
+{
+  if (report_id == XHC_DIAG_REPORT_ID)
+  {
+    return xhc_diag_get_report(len);
+  }
+  if (report_id == XHC_TELEM_REPORT_ID)
+  {
+    return xhc_telem_get_report(len);
+  }
+  *len = 0;
+  return NULL;
+}
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 /**
   * @}